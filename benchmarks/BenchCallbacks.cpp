@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <thingset++/ThingSetBinaryDecoder.hpp>
+#include <thingset++/ThingSetBinaryEncoder.hpp>
+#include <thingset++/internal/Delegate.hpp>
+#include <thingset++/internal/FunctionRef.hpp>
+#include <vector>
+
+using namespace ThingSet;
+
+namespace {
+
+/// Decodes maps exactly as ThingSetDecoder::decodeMap() does, but through
+/// a callback of any type, so that callback types can be compared.
+class MapDecoder : public DefaultFixedDepthThingSetBinaryDecoder
+{
+public:
+    MapDecoder(const uint8_t *buffer, size_t size) : DefaultFixedDepthThingSetBinaryDecoder(buffer, size)
+    {}
+
+    template <typename Callback> bool decodeMapWith(Callback callback)
+    {
+        if (!decodeMapStart()) {
+            return false;
+        }
+        while (isInMap()) {
+            uint16_t key;
+            if (!decode(&key) || !callback(key)) {
+                return false;
+            }
+        }
+        return decodeMapEnd();
+    }
+};
+
+/// Stands in for a server, to which a transport dispatches each request.
+class RequestHandler
+{
+public:
+    int handle(uint8_t *request, size_t requestLength, uint8_t *response, size_t)
+    {
+        response[0] = request[requestLength - 1];
+        return 1;
+    }
+};
+
+} // namespace
+
+// Decodes a map of the given number of entries with a callback which
+// captures as much as a typical listener callback; the difference between
+// callback types at one entry is the per-request overhead, and the
+// difference in slope, the per-entry overhead
+template <typename Callback>
+static void BM_DecodeMap(benchmark::State &state)
+{
+    std::vector<uint8_t> buffer(16 + state.range(0) * 8);
+    FixedDepthThingSetBinaryEncoder encoder(buffer.data(), buffer.size(), 2);
+    encoder.encodeMapStart(state.range(0));
+    for (uint16_t i = 0; i < state.range(0); i++) {
+        encoder.encode((uint16_t)(0x1000 + i));
+        encoder.encode((float)i);
+    }
+    encoder.encodeMapEnd(state.range(0));
+
+    for (auto _ : state) {
+        MapDecoder decoder(buffer.data(), encoder.getEncodedLength());
+        float value;
+        size_t count = 0;
+        bool result = decoder.decodeMapWith<Callback>([&decoder, &value, &count](uint16_t &) {
+            count++;
+            return decoder.decode(&value);
+        });
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_DecodeMap<std::function<bool(uint16_t &)>>)->RangeMultiplier(4)->Range(1, 256)->Complexity();
+BENCHMARK(BM_DecodeMap<FunctionRef<bool(uint16_t &)>>)->RangeMultiplier(4)->Range(1, 256)->Complexity();
+
+// Dispatches requests through a stored transport callback which forwards to
+// a handler, as a transport does to its server
+template <typename Callback>
+static void BM_DispatchRequest(benchmark::State &state)
+{
+    RequestHandler handler;
+    Callback callback = [&handler](const int &, uint8_t *request, size_t requestLength, uint8_t *response,
+                                   size_t responseSize) {
+        return handler.handle(request, requestLength, response, responseSize);
+    };
+    uint8_t request[8] = { 0x01, 0x19, 0x10, 0x00 };
+    uint8_t response[8];
+    int sender = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(callback(sender, request, 4, response, sizeof(response)));
+    }
+}
+BENCHMARK(BM_DispatchRequest<std::function<int(const int &, uint8_t *, size_t, uint8_t *, size_t)>>);
+BENCHMARK(BM_DispatchRequest<Delegate<int(const int &, uint8_t *, size_t, uint8_t *, size_t)>>);
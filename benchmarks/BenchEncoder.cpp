@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <benchmark/benchmark.h>
+#include <thingset++/ThingSet.hpp>
+#include <thingset++/internal/CborWriter.hpp>
+
+using namespace ThingSet;
+
+namespace {
+
+struct CellRecord
+{
+    ThingSetReadOnlyRecordMember<0x701, 0x700, "voltage", float> voltage;
+    ThingSetReadOnlyRecordMember<0x702, 0x700, "current", float> current;
+    ThingSetReadOnlyRecordMember<0x703, 0x700, "temperature", float> temperature;
+    ThingSetReadOnlyRecordMember<0x704, 0x700, "soc", float> soc;
+    ThingSetReadOnlyRecordMember<0x705, 0x700, "soh", float> soh;
+    ThingSetReadOnlyRecordMember<0x706, 0x700, "resistance", float> resistance;
+    ThingSetReadOnlyRecordMember<0x707, 0x700, "capacity", float> capacity;
+    ThingSetReadOnlyRecordMember<0x708, 0x700, "balancing", float> balancing;
+};
+
+static const size_t RecordCount = 64;
+
+std::array<CellRecord, RecordCount> makeRecords()
+{
+    std::array<CellRecord, RecordCount> records;
+    for (size_t i = 0; i < RecordCount; i++) {
+        records[i].voltage = 3.2f + i * 0.001f;
+        records[i].current = 1.5f;
+        records[i].temperature = 25.0f - i * 0.1f;
+        records[i].soc = 0.8f;
+        records[i].soh = 0.99f;
+        records[i].resistance = 0.002f;
+        records[i].capacity = 50.0f;
+        records[i].balancing = 0.0f;
+    }
+    return records;
+}
+
+} // namespace
+
+// Encodes an array of records through the polymorphic encoder interface, as
+// property and group encoding does
+static void BM_EncodeRecords_Polymorphic(benchmark::State &state)
+{
+    auto records = makeRecords();
+    std::array<uint8_t, 4096> buffer;
+    for (auto _ : state) {
+        DefaultFixedDepthThingSetBinaryEncoder encoder(buffer);
+        ThingSetEncoder &polymorphic = encoder;
+        benchmark::DoNotOptimize(polymorphic.encode(records));
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations() * RecordCount);
+}
+BENCHMARK(BM_EncodeRecords_Polymorphic);
+
+// Encodes the same records through the inline encoder, whose calls are
+// resolved at compile time
+static void BM_EncodeRecords_Inline(benchmark::State &state)
+{
+    auto records = makeRecords();
+    std::array<uint8_t, 4096> buffer;
+    for (auto _ : state) {
+        FixedDepthInlineThingSetBinaryEncoder encoder(buffer);
+        benchmark::DoNotOptimize(encoder.encode(records));
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations() * RecordCount);
+}
+BENCHMARK(BM_EncodeRecords_Inline);
+
+static const size_t ReportEntryCount = 64;
+
+// Writes a report-like map of integer keys to integers and floats with
+// zcbor; the argument selects forward-only encoding, in which containers
+// are ended without rewriting their headers
+static void BM_WriteReport_Zcbor(benchmark::State &state)
+{
+    std::array<uint8_t, 4096> buffer;
+    zcbor_state_t zcbor[BINARY_ENCODER_DEFAULT_MAX_DEPTH];
+    bool forwardOnly = state.range(0);
+    for (auto _ : state) {
+        zcbor_new_encode_state(zcbor, BINARY_ENCODER_DEFAULT_MAX_DEPTH, buffer.data(), buffer.size(), 1);
+        bool result = zcbor_map_start_encode(zcbor, ReportEntryCount);
+        for (uint32_t i = 0; i < ReportEntryCount; i++) {
+            uint32_t key = 0x1000 + i;
+            result &= zcbor_uint32_encode(zcbor, &key);
+            if (i & 1) {
+                float value = i * 0.5f;
+                result &= zcbor_float32_encode(zcbor, &value);
+            }
+            else {
+                int32_t value = -(int32_t)(i * 1000);
+                result &= zcbor_int32_encode(zcbor, &value);
+            }
+        }
+        if (forwardOnly) {
+            auto flags = ZCBOR_FLAG_RESTORE | ZCBOR_FLAG_CONSUME;
+#ifdef ZCBOR_FLAG_TRANSFER_PAYLOAD
+            flags |= ZCBOR_FLAG_TRANSFER_PAYLOAD;
+#else
+            flags |= ZCBOR_FLAG_KEEP_PAYLOAD;
+#endif
+            result &= zcbor_process_backup(zcbor, flags, ZCBOR_MAX_ELEM_COUNT);
+        }
+        else {
+            result &= zcbor_map_end_encode(zcbor, ReportEntryCount);
+        }
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetBytesProcessed(state.iterations() * (zcbor->payload - buffer.data()));
+}
+BENCHMARK(BM_WriteReport_Zcbor)->Arg(false)->Arg(true);
+
+// Writes the same map with CborWriter
+static void BM_WriteReport_CborWriter(benchmark::State &state)
+{
+    std::array<uint8_t, 4096> buffer;
+    zcbor_state_t cursor;
+    CborContainerStack<BINARY_ENCODER_DEFAULT_MAX_DEPTH> containers;
+    bool forwardOnly = state.range(0);
+    for (auto _ : state) {
+        zcbor_new_encode_state(&cursor, 1, buffer.data(), buffer.size(), 1);
+        CborWriter::Container *container = forwardOnly ? nullptr : containers.push();
+        bool result = CborWriter::writeContainerStart(&cursor, CborWriter::map, ReportEntryCount, container);
+        for (uint32_t i = 0; i < ReportEntryCount; i++) {
+            result &= CborWriter::writeUnsigned(&cursor, 0x1000 + i);
+            if (i & 1) {
+                result &= CborWriter::writeFloat(&cursor, i * 0.5f);
+            }
+            else {
+                result &= CborWriter::writeSigned(&cursor, -(int32_t)(i * 1000));
+            }
+        }
+        result &= CborWriter::writeContainerEnd(&cursor, CborWriter::map, ReportEntryCount,
+                                                forwardOnly ? nullptr : containers.pop());
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetBytesProcessed(state.iterations() * (cursor.payload - buffer.data()));
+}
+BENCHMARK(BM_WriteReport_CborWriter)->Arg(false)->Arg(true);
+
+static const size_t CellCount = 512;
+
+// Encodes an array of cell voltages, either as a list of floats or, with the
+// argument set, as a typed array
+static void BM_EncodeFloatArray(benchmark::State &state)
+{
+    std::array<float, CellCount> voltages;
+    for (size_t i = 0; i < CellCount; i++) {
+        voltages[i] = 3.2f + i * 0.001f;
+    }
+    std::array<uint8_t, 4096> buffer;
+    ThingSetBinaryEncoderOptions options = (ThingSetBinaryEncoderOptions)(
+        ThingSetBinaryEncoderOptions::encodeKeysAsIds | (state.range(0) ? ThingSetBinaryEncoderOptions::typedArrays : 0));
+    for (auto _ : state) {
+        DefaultFixedDepthThingSetBinaryEncoder encoder(buffer.data(), buffer.size(), 1, options);
+        ThingSetEncoder &polymorphic = encoder;
+        benchmark::DoNotOptimize(polymorphic.encode(voltages));
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations() * CellCount);
+}
+BENCHMARK(BM_EncodeFloatArray)->Arg(false)->Arg(true);
+
+// Decodes the same array from each form
+static void BM_DecodeFloatArray(benchmark::State &state)
+{
+    std::array<float, CellCount> voltages;
+    for (size_t i = 0; i < CellCount; i++) {
+        voltages[i] = 3.2f + i * 0.001f;
+    }
+    std::array<uint8_t, 4096> buffer;
+    ThingSetBinaryEncoderOptions options = (ThingSetBinaryEncoderOptions)(
+        ThingSetBinaryEncoderOptions::encodeKeysAsIds | (state.range(0) ? ThingSetBinaryEncoderOptions::typedArrays : 0));
+    DefaultFixedDepthThingSetBinaryEncoder encoder(buffer.data(), buffer.size(), 1, options);
+    encoder.encode(voltages);
+    size_t length = encoder.getEncodedLength();
+    for (auto _ : state) {
+        DefaultFixedDepthThingSetBinaryDecoder decoder(buffer.data(), length);
+        benchmark::DoNotOptimize(decoder.decode(&voltages));
+        benchmark::DoNotOptimize(voltages.data());
+    }
+    state.SetItemsProcessed(state.iterations() * CellCount);
+}
+BENCHMARK(BM_DecodeFloatArray)->Arg(false)->Arg(true);
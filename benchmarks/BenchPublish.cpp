@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "PropertySet.hpp"
+#include <benchmark/benchmark.h>
+#include <thingset++/ThingSetServer.hpp>
+
+using namespace ThingSet;
+
+static const size_t PublishFrameSize = 1024;
+
+namespace {
+
+/// Encodes reports into a buffer which is then discarded.
+class DiscardingEncoder : public StreamingThingSetBinaryEncoder<PublishFrameSize>
+{
+public:
+    DiscardingEncoder()
+    {
+        zcbor_new_encode_state(_state, BINARY_ENCODER_DEFAULT_MAX_DEPTH, _buffer.data(), _buffer.size(), 1);
+    }
+
+protected:
+    bool write(size_t length, bool) override
+    {
+        benchmark::DoNotOptimize(_buffer[length - 1]);
+        return true;
+    }
+};
+
+/// Publishes reports without any underlying transport.
+class DiscardingServerTransport : public ThingSetServerTransport<int, PublishFrameSize, DiscardingEncoder>
+{
+public:
+    bool listen(Delegate<int(const int &, uint8_t *, size_t, uint8_t *, size_t)>) override
+    {
+        return true;
+    }
+
+    DiscardingEncoder getPublishingEncoder(bool) override
+    {
+        return DiscardingEncoder();
+    }
+};
+
+} // namespace
+
+// Publishes a fixed number of live properties from registries of increasing
+// size; the cost of publishing should not depend on the non-live properties
+static void BM_PublishSubset(benchmark::State &state)
+{
+    PropertySet<float, Subset::live> live(10, 0x1000);
+    PropertySet<float> others(state.range(0), 0x2000);
+    DiscardingServerTransport transport;
+    ThingSetServer<int, PublishFrameSize, DiscardingEncoder> server(transport);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(server.publish(Subset::live));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_PublishSubset)->RangeMultiplier(4)->Range(16, 16 << 10)->Complexity();
+
+// Publishes the same subset as above, but from a compiled report
+static void BM_PublishReport(benchmark::State &state)
+{
+    PropertySet<float, Subset::live> live(10, 0x1000);
+    PropertySet<float> others(state.range(0), 0x2000);
+    DiscardingServerTransport transport;
+    ThingSetServer<int, PublishFrameSize, DiscardingEncoder> server(transport);
+    ThingSetReport report(Subset::live);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(server.publish(report));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_PublishReport)->RangeMultiplier(4)->Range(16, 16 << 10)->Complexity();
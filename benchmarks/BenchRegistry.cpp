@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "PropertySet.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace ThingSet;
+
+static void BM_FindById(benchmark::State &state)
+{
+    PropertySet<float> properties(state.range(0), 0x1000);
+    const auto &ids = properties.ids();
+    size_t i = 0;
+    for (auto _ : state) {
+        ThingSetNode *node;
+        benchmark::DoNotOptimize(ThingSetRegistry::findById(ids[i], &node));
+        i = (i + 1) % ids.size();
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_FindById)->RangeMultiplier(4)->Range(16, 16 << 10)->Complexity();
+
+static void BM_FindByIdMissing(benchmark::State &state)
+{
+    PropertySet<float> properties(state.range(0), 0x1000);
+    uint16_t id = 0x1000 + state.range(0);
+    for (auto _ : state) {
+        ThingSetNode *node;
+        benchmark::DoNotOptimize(ThingSetRegistry::findById(id, &node));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_FindByIdMissing)->RangeMultiplier(4)->Range(16, 16 << 10)->Complexity();
+
+static void BM_FindByName(benchmark::State &state)
+{
+    PropertySet<float> properties(state.range(0), 0x1000);
+    const auto &names = properties.names();
+    size_t i = 0;
+    for (auto _ : state) {
+        ThingSetNode *node;
+        benchmark::DoNotOptimize(ThingSetRegistry::findByName(names[i], &node));
+        i = (i + 1) % names.size();
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_FindByName)->RangeMultiplier(4)->Range(16, 16 << 10)->Complexity();
+
+static void BM_FindByDeepName(benchmark::State &state)
+{
+    ThingSetGroup<0x900, 0x0, "Modules"> modules;
+    ThingSetGroup<0x901, 0x900, "Cells"> cells;
+    PropertySet<float> siblings(state.range(0), 0x1000, 0x901);
+    ThingSetReadOnlyProperty<float> voltage{ 0x902, 0x901, "voltage" };
+    for (auto _ : state) {
+        ThingSetNode *node;
+        benchmark::DoNotOptimize(ThingSetRegistry::findByName("Modules/Cells/voltage", &node));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_FindByDeepName)->RangeMultiplier(4)->Range(16, 16 << 10)->Complexity();
+
+static void BM_RegisterNodes(benchmark::State &state)
+{
+    for (auto _ : state) {
+        // children are registered before their parent groups, as happens with
+        // static initialisation across translation units
+        PropertySet<float> properties(state.range(0), 0x1000, 0x900);
+        ThingSetGroup<0x900, 0x0, "Group"> group;
+        benchmark::DoNotOptimize(group.begin());
+    }
+    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RegisterNodes)->RangeMultiplier(10)->Range(10, 10000)->Complexity();
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+#include <thingset++/ThingSetClient.hpp>
+#include <thingset++/ThingSetFunction.hpp>
+#include <thingset++/ThingSetServer.hpp>
+#include <thingset++/ip/sockets/ThingSetSocketClientTransport.hpp>
+#include <thingset++/ip/sockets/ThingSetSocketServerTransport.hpp>
+#include <thread>
+#include <vector>
+
+using namespace ThingSet;
+using namespace ThingSet::Ip::Sockets;
+
+static const size_t ClientCount = 8;
+static const size_t RequestsPerClient = 4;
+
+namespace {
+
+/// A client on its own connection to the server.
+struct Client
+{
+    std::array<uint8_t, 1024> rxBuffer;
+    std::array<uint8_t, 1024> txBuffer;
+    ThingSetSocketClientTransport transport;
+    ThingSetClient client;
+
+    Client() : transport("127.0.0.1"), client(transport, rxBuffer, txBuffer)
+    {}
+};
+
+} // namespace
+
+// Executes a function which blocks for a millisecond, as one writing to flash
+// might, from several clients at once; requests per second should scale with
+// the number of workers until there is one for each client
+static void BM_ExecSlowFunction(benchmark::State &state)
+{
+    ThingSetUserFunction<0x1100, 0x0, "xWrite", int> write([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return 0;
+    });
+
+    ThingSetSocketServerTransport serverTransport;
+    if (!serverTransport.setWorkerCount(state.range(0))) {
+        state.SkipWithError("Workers need ENABLE_CONCURRENT_REGISTRY");
+        return;
+    }
+    auto server = ThingSetServerBuilder::build(serverTransport);
+    server.listen();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::vector<std::unique_ptr<Client>> clients;
+    for (size_t i = 0; i < ClientCount; i++) {
+        clients.push_back(std::make_unique<Client>());
+        if (!clients.back()->client.connect()) {
+            state.SkipWithError("Failed to connect");
+            return;
+        }
+    }
+
+    for (auto _ : state) {
+        std::vector<std::thread> threads;
+        for (auto &client : clients) {
+            threads.emplace_back([&]() {
+                for (size_t i = 0; i < RequestsPerClient; i++) {
+                    int result;
+                    client->client.exec(0x1100, &result);
+                }
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * ClientCount * RequestsPerClient);
+
+    // let the server close its ends of the connections, so that the next run
+    // can listen on the same port
+    clients.clear();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+BENCHMARK(BM_ExecSlowFunction)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "PropertySet.hpp"
+#include <benchmark/benchmark.h>
+#include <thingset++/ThingSetTextEncoder.hpp>
+
+using namespace ThingSet;
+
+static const size_t PropertiesPerType = 125;
+
+/// Encodes a group of 500 properties of mixed types, as a text GET of the
+/// group does. The argument selects shortest floats.
+static void BM_EncodeTextGroup(benchmark::State &state)
+{
+    ThingSetGroup<0x900, 0x0, "Group"> group;
+    PropertySet<float> floats(PropertiesPerType, 0x1000, 0x900);
+    PropertySet<double> doubles(PropertiesPerType, 0x1100, 0x900);
+    PropertySet<int32_t> ints(PropertiesPerType, 0x1200, 0x900);
+    PropertySet<uint64_t> longs(PropertiesPerType, 0x1300, 0x900);
+    for (size_t i = 0; i < PropertiesPerType; i++) {
+        floats[i] = 3.2f + i * 0.001f;
+        doubles[i] = 1000.0 / (i + 1);
+        ints[i] = (int32_t)(i * 7919) - 500000;
+        longs[i] = i * 0x9E3779B97F4A7C15ULL;
+    }
+
+    TextEncoderOptions options = state.range(0) ? TextEncoderOptions::shortestFloats : TextEncoderOptions::none;
+    std::vector<char> buffer(64 * 1024);
+    size_t length = 0;
+    for (auto _ : state) {
+        ThingSetTextEncoder encoder(buffer.data(), buffer.size(), options);
+        benchmark::DoNotOptimize(group.encode(encoder));
+        length = encoder.getEncodedLength();
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+    state.SetItemsProcessed(state.iterations() * PropertiesPerType * 4);
+}
+BENCHMARK(BM_EncodeTextGroup)->Arg(false)->Arg(true);
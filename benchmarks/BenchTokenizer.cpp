@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+// jsmn, for comparison, kept private to this file
+#define JSMN_STATIC
+#include <thingset++/internal/jsmn.h>
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <thingset++/internal/JsonTokenizer.hpp>
+#include <vector>
+
+using namespace ThingSet;
+
+namespace {
+
+/// An update of a few records, such as a gateway might send.
+std::string makeUpdate()
+{
+    std::string json = "{\"cells\":[";
+    for (int i = 0; i < 64; i++) {
+        json += i > 0 ? "," : "";
+        json += "{\"voltage\":3.2" + std::to_string(i) + ",\"current\":1.5,\"temperature\":24.9,"
+                "\"name\":\"cell " + std::to_string(i) + "\",\"balancing\":false}";
+    }
+    return json + "]}";
+}
+
+} // namespace
+
+static void BM_TokenizeJson_Jsmn(benchmark::State &state)
+{
+    std::string json = makeUpdate();
+    std::vector<jsmntok> tokens(json.size());
+    for (auto _ : state) {
+        jsmn_parser parser;
+        jsmn_init(&parser);
+        benchmark::DoNotOptimize(jsmn_parse(&parser, json.data(), json.size(), tokens.data(), tokens.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_TokenizeJson_Jsmn);
+
+static void BM_TokenizeJson_JsonTokenizer(benchmark::State &state)
+{
+    std::string json = makeUpdate();
+    std::vector<jsmntok> tokens(json.size());
+    for (auto _ : state) {
+        JsonTokenizer tokenizer;
+        benchmark::DoNotOptimize(tokenizer.parse(json.data(), json.size(), tokens.data(), tokens.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_TokenizeJson_JsonTokenizer);
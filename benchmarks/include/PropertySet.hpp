@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <thingset++/ThingSet.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// @brief Owns a number of dynamically-created properties, so that
+/// benchmarks can be run against registries of varying sizes.
+/// @tparam T The type of value of each property.
+template <typename T, typename ThingSet::Subset S = (ThingSet::Subset)0>
+class PropertySet
+{
+private:
+    std::vector<std::string> _names;
+    std::vector<std::unique_ptr<ThingSet::ThingSetReadWriteProperty<T, S>>> _properties;
+    std::vector<uint16_t> _ids;
+
+public:
+    /// @brief Create properties.
+    /// @param count The number of properties to create.
+    /// @param firstId The ID of the first property; subsequent properties have consecutive IDs.
+    /// @param parentId The ID of the parent of all of the properties.
+    PropertySet(size_t count, uint16_t firstId, uint16_t parentId = 0)
+    {
+        _names.reserve(count);
+        _properties.reserve(count);
+        _ids.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            _names.push_back("p" + std::to_string(i));
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint16_t id = (uint16_t)(firstId + i);
+            _ids.push_back(id);
+            _properties.push_back(std::make_unique<ThingSet::ThingSetReadWriteProperty<T, S>>(id, parentId, _names[i]));
+        }
+    }
+
+    const std::vector<uint16_t> &ids() const
+    {
+        return _ids;
+    }
+
+    const std::vector<std::string> &names() const
+    {
+        return _names;
+    }
+
+    ThingSet::ThingSetReadWriteProperty<T, S> &operator[](size_t index)
+    {
+        return *_properties[index];
+    }
+
+    size_t size() const
+    {
+        return _properties.size();
+    }
+};
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "thingset++/ThingSetBinaryEncoder.hpp"
+#include "thingset++/internal/FunctionRef.hpp"
+
+namespace ThingSet {
+
+/// @brief Forward-only binary encoder which writes its buffer out in chunks
+/// whenever it is more than half full, so that it can encode CBOR of any length
+/// in a buffer of fixed size, provided that no single item is larger than half
+/// the buffer.
+///
+/// As headers cannot be rewritten once they have been written out, lists and
+/// maps started with a number of elements must contain exactly that many, and
+/// those started without one are encoded with indefinite length.
+class ChunkedThingSetBinaryEncoder : public virtual ThingSetBinaryEncoder
+{
+private:
+    uint8_t *_buffer;
+    size_t _size;
+    size_t _reserved;
+    FunctionRef<bool(const uint8_t *, size_t)> _writer;
+    zcbor_state_t _state;
+    size_t _writtenLength;
+    const ThingSetBinaryEncoderOptions _options;
+    // one bit for each open list or map, which is set if it is of indefinite
+    // length, so must be ended with a break
+    uint64_t _indefinite;
+    size_t _depth;
+
+public:
+    /// @brief Creates an encoder.
+    /// @param buffer The buffer.
+    /// @param size The size of the buffer.
+    /// @param reserved The number of bytes at the start of the buffer which are
+    /// not encoded into, but are written out with the first chunk, such as the
+    /// header of a response.
+    /// @param writer Writes out a chunk, returning true if successful.
+    /// @param options Options for encoding.
+    ChunkedThingSetBinaryEncoder(uint8_t *buffer, size_t size, size_t reserved,
+                                 FunctionRef<bool(const uint8_t *, size_t)> writer,
+                                 ThingSetBinaryEncoderOptions options = ThingSetBinaryEncoderOptions::encodeKeysAsIds)
+        : _buffer(buffer), _size(size), _reserved(reserved), _writer(writer), _writtenLength(0), _options(options),
+          _indefinite(0), _depth(0)
+    {
+        zcbor_new_encode_state(&_state, 1, buffer + reserved, size - reserved, 1);
+    }
+
+    size_t getEncodedLength() const override
+    {
+        return _writtenLength + (_state.payload - (_buffer + _reserved));
+    }
+
+    /// @brief Gets the number of bytes written out so far, including the
+    /// reserved bytes once the first chunk has been written.
+    size_t getWrittenLength() const
+    {
+        return _writtenLength > 0 ? _reserved + _writtenLength : 0;
+    }
+
+    bool encodeKeysAsIds() const override
+    {
+        return (_options & ThingSetBinaryEncoderOptions::encodeKeysAsIds);
+    }
+
+    bool encodeTypedArrays() const override
+    {
+        // a typed array is a single byte string, which would have to fit in
+        // half the buffer, whereas the elements of a list are written out in
+        // chunks, so arrays are always encoded as lists
+        return false;
+    }
+
+    /// @brief Encode the start of a list of indefinite length.
+    bool encodeListStart() override
+    {
+        return openContainer(true) && ensureState() && CborWriter::writeIndefiniteStart(&_state, CborWriter::list);
+    }
+
+    bool encodeListStart(const uint32_t &count) override
+    {
+        return openContainer(false) && ThingSetBinaryEncoder::encodeListStart(count);
+    }
+
+    bool encodeListEnd() override
+    {
+        return closeContainer() ? ensureState() && CborWriter::writeBreak(&_state) : ThingSetBinaryEncoder::encodeListEnd();
+    }
+
+    bool encodeListEnd(const uint32_t &count) override
+    {
+        closeContainer();
+        return ThingSetBinaryEncoder::encodeListEnd(count);
+    }
+
+    /// @brief Encode the start of a map of indefinite length.
+    bool encodeMapStart() override
+    {
+        return openContainer(true) && ensureState() && CborWriter::writeIndefiniteStart(&_state, CborWriter::map);
+    }
+
+    bool encodeMapStart(const uint32_t &count) override
+    {
+        return openContainer(false) && ThingSetBinaryEncoder::encodeMapStart(count);
+    }
+
+    bool encodeMapEnd() override
+    {
+        return closeContainer() ? ensureState() && CborWriter::writeBreak(&_state) : ThingSetBinaryEncoder::encodeMapEnd();
+    }
+
+    bool encodeMapEnd(const uint32_t &count) override
+    {
+        closeContainer();
+        return ThingSetBinaryEncoder::encodeMapEnd(count);
+    }
+
+protected:
+    zcbor_state_t *getState() override
+    {
+        return &_state;
+    }
+
+    bool getIsForwardOnly() const override
+    {
+        return true;
+    }
+
+    bool encodeShortestFloats() const override
+    {
+        return (_options & ThingSetBinaryEncoderOptions::shortestFloats);
+    }
+
+    /// @brief Writes out the buffer if it is more than half full.
+    bool ensureState() override
+    {
+        uint8_t *start = _buffer + _reserved;
+        size_t length = _state.payload - start;
+        if (length <= (_size - _reserved) / 2) {
+            return true;
+        }
+        const uint8_t *chunk = start;
+        size_t total = length;
+        if (_writtenLength == 0) {
+            // the reserved bytes immediately precede the encoded ones
+            chunk -= _reserved;
+            total += _reserved;
+        }
+        if (!_writer(chunk, total)) {
+            return false;
+        }
+        _writtenLength += length;
+        _state.payload_mut = start;
+        return true;
+    }
+
+private:
+    bool openContainer(bool indefinite)
+    {
+        if (_depth >= 64) {
+            return false;
+        }
+        _indefinite = (_indefinite << 1) | indefinite;
+        _depth++;
+        return true;
+    }
+
+    /// @brief Closes the innermost list or map.
+    /// @return True if it was of indefinite length, otherwise false.
+    bool closeContainer()
+    {
+        if (_depth == 0) {
+            return false;
+        }
+        bool indefinite = _indefinite & 1;
+        _indefinite >>= 1;
+        _depth--;
+        return indefinite;
+    }
+};
+
+} // namespace ThingSet
@@ -44,6 +44,8 @@ public:
     {
         return ParentId;
     }
+
+    constexpr static const uint32_t key = ThingSetRegistry::nodeKey(Id);
 };
 
 /// @brief Represents a ThingSet node with an ID and which may have one or more child nodes.
@@ -77,6 +79,8 @@ public:
         return ParentId;
     }
 
+    constexpr static const uint32_t key = ThingSetRegistry::nodeKey(Id);
+
     bool tryCastTo(ThingSetNodeType type, void **target) override
     {
         switch (type) {
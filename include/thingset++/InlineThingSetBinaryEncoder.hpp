@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "thingset++/ThingSetEncoder.hpp"
+#include "thingset++/internal/CborWriter.hpp"
+#include "thingset++/internal/TypedArray.hpp"
+#include "zcbor_encode.h"
+#include <algorithm>
+#include <cstring>
+
+#define BINARY_ENCODER_MAX_NULL_TERMINATED_STRING_LENGTH 256
+#define BINARY_ENCODER_DEFAULT_MAX_DEPTH                 8
+
+namespace ThingSet {
+
+template <typename Sink>
+class ThingSetBinaryEncoderAdapter;
+
+/// @brief Binary protocol encoder for ThingSet whose methods are resolved at
+/// compile time, so that they can be inlined wherever the concrete type of the
+/// encoder is known.
+///
+/// The sink, which derives from this class, supplies the encoder state:
+/// - zcbor_state_t *getState()
+/// - bool ensureState(), which makes room for the next item
+/// - bool getIsForwardOnly() const, which is true if the encoding cannot be
+///   revisited to write the size of a list or map once it is complete
+/// - CborWriter::Container *pushContainer() and *popContainer(), which open and
+///   close lists and maps; only called if the encoding is not forward-only
+/// - bool encodeKeysAsIds() const
+/// - bool encodeShortestFloats() const, which is true if floats and doubles
+///   should be encoded in the shortest form which represents them exactly
+/// - bool encodeTypedArrays() const, which is true if arrays of numbers should
+///   be encoded as RFC 8746 typed arrays rather than as lists
+/// - size_t getEncodedLength() const
+///
+/// ThingSetBinaryEncoder implements the polymorphic ThingSetEncoder interface
+/// on top of this class, and FixedDepthInlineThingSetBinaryEncoder is a sink
+/// which writes to a fixed buffer; include ThingSetBinaryEncoder.hpp to use either.
+/// @tparam Sink The type of the derived class.
+template <typename Sink>
+class InlineThingSetBinaryEncoder
+{
+private:
+    Sink &sink()
+    {
+        return static_cast<Sink &>(*this);
+    }
+
+    /// @brief Makes room for the next item, then gets the state to encode it with.
+    zcbor_state_t *next()
+    {
+        return sink().ensureState() ? sink().getState() : nullptr;
+    }
+
+public:
+    bool encode(const std::string_view &value)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeString(state, CborWriter::textString, (const uint8_t *)value.data(), value.size());
+    }
+
+    bool encode(const std::string &value)
+    {
+        return encode(std::string_view(value));
+    }
+
+    bool encode(const char *value)
+    {
+        return encode(std::string_view(value, strnlen(value, BINARY_ENCODER_MAX_NULL_TERMINATED_STRING_LENGTH)));
+    }
+
+    bool encode(const float &value)
+    {
+        zcbor_state_t *state = next();
+        if (!state) {
+            return false;
+        }
+        return sink().encodeShortestFloats() ? CborWriter::writeShortestFloat(state, value)
+                                             : CborWriter::writeFloat(state, value);
+    }
+
+    bool encode(const double &value)
+    {
+        zcbor_state_t *state = next();
+        if (!state) {
+            return false;
+        }
+        return sink().encodeShortestFloats() ? CborWriter::writeShortestDouble(state, value)
+                                             : CborWriter::writeDouble(state, value);
+    }
+
+    bool encode(const bool &value)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeBool(state, value);
+    }
+
+    bool encode(const uint8_t &value)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeUnsigned(state, value);
+    }
+
+    bool encode(const uint16_t &value)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeUnsigned(state, value);
+    }
+
+    bool encode(const uint32_t &value)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeUnsigned(state, value);
+    }
+
+    bool encode(const uint64_t &value)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeUnsigned(state, value);
+    }
+
+    bool encode(const int8_t &value)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeSigned(state, value);
+    }
+
+    bool encode(const int16_t &value)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeSigned(state, value);
+    }
+
+    bool encode(const int32_t &value)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeSigned(state, value);
+    }
+
+    bool encode(const int64_t &value)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeSigned(state, value);
+    }
+
+    /// @brief Encode a primitive value through a pointer to it.
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    bool encode(const T *value)
+    {
+        return encode(*value);
+    }
+
+    /// @brief Encode a value which can only be encoded through the polymorphic
+    /// encoder interface, such as a property or group.
+    bool encode(const ThingSetEncodable &value)
+    {
+        if constexpr (std::is_base_of_v<ThingSetEncoder, Sink>) {
+            return value.encode(sink());
+        }
+        else {
+            ThingSetBinaryEncoderAdapter<Sink> adapter(sink());
+            return value.encode(adapter);
+        }
+    }
+
+    bool encode(const ThingSetEncodable *value)
+    {
+        return encode(*value);
+    }
+
+    bool encodeNull()
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeNull(state);
+    }
+
+    bool encodePreamble()
+    {
+        return encodeNull();
+    }
+
+    bool encodeListStart()
+    {
+        return encodeListStart(UINT8_MAX);
+    }
+
+    bool encodeListStart(const uint32_t &count)
+    {
+        return encodeContainerStart(CborWriter::list, count);
+    }
+
+    bool encodeListEnd()
+    {
+        return encodeListEnd(UINT8_MAX);
+    }
+
+    bool encodeListEnd(const uint32_t &count)
+    {
+        return encodeContainerEnd(CborWriter::list, count);
+    }
+
+    bool encodeMapStart()
+    {
+        return encodeMapStart(UINT8_MAX);
+    }
+
+    bool encodeMapStart(const uint32_t &count)
+    {
+        return encodeContainerStart(CborWriter::map, count);
+    }
+
+    bool encodeMapEnd()
+    {
+        return encodeMapEnd(UINT8_MAX);
+    }
+
+    bool encodeMapEnd(const uint32_t &count)
+    {
+        return encodeContainerEnd(CborWriter::map, count);
+    }
+
+    /// @brief Encode an array of bytes of length @see size.
+    /// @param buffer The array to encode.
+    /// @param size The number of bytes in the array.
+    /// @return True if encoding succeeded, otherwise false.
+    bool encodeBytes(const uint8_t *buffer, const size_t &size)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeString(state, CborWriter::byteString, buffer, size);
+    }
+
+    /// @brief Encode an array of numbers as an RFC 8746 typed array.
+    /// @param tag The tag identifying the type and byte order of the elements.
+    /// @param buffer The elements, as they are laid out in memory.
+    /// @param length The length of the elements in bytes.
+    /// @return True if encoding succeeded, otherwise false.
+    bool encodeTypedArray(const uint8_t tag, const uint8_t *buffer, const size_t &length)
+    {
+        zcbor_state_t *state = next();
+        return state && CborWriter::writeTag(state, tag)
+               && CborWriter::writeString(state, CborWriter::byteString, buffer, length);
+    }
+
+    /// @brief Write data which is already CBOR-encoded, as is.
+    /// @param buffer The encoded data.
+    /// @param size The length of the data.
+    /// @return True if writing succeeded, otherwise false.
+    bool encodeEncoded(const uint8_t *buffer, size_t size)
+    {
+        while (size > 0) {
+            zcbor_state_t *state = next();
+            if (!state) {
+                return false;
+            }
+            size_t available = state->payload_end - state->payload;
+            if (available == 0) {
+                return false;
+            }
+            // fill at most half of the remaining space at a time, so that a
+            // streaming encoder, which writes out a message once more than one
+            // is buffered, always has room to keep the remainder
+            size_t length = std::min(size, std::max<size_t>(available / 2, 1));
+            memcpy(state->payload_mut, buffer, length);
+            state->payload += length;
+            buffer += length;
+            size -= length;
+        }
+        return true;
+    }
+
+    /// @brief Encodes an enum as its underlying value.
+    template <typename T, typename U = std::underlying_type_t<T>>
+        requires std::is_enum_v<T>
+    bool encode(const T &value)
+    {
+        return encode(static_cast<U>(value));
+    }
+
+    /// @brief Encode a linked list.
+    template <typename T> bool encode(const std::list<T> &value)
+    {
+        if (!encodeListStart(value.size())) {
+            return false;
+        }
+        for (const T &item : value) {
+            if (!encode(item)) {
+                return false;
+            }
+        }
+        return encodeListEnd(value.size());
+    }
+
+    /// @brief Encode a map.
+    template <typename K, typename V> bool encode(const std::map<K, V> &map)
+    {
+        if (!encodeMapStart(map.size())) {
+            return false;
+        }
+        for (const std::pair<K, V> &pair : map) {
+            if (!encode(pair)) {
+                return false;
+            }
+        }
+        return encodeMapEnd(map.size());
+    }
+
+    /// @brief Encode a pair, as a key and value.
+    template <typename K, typename V> bool encode(const std::pair<K, V> &pair)
+    {
+        return encode(pair.first) && encode(pair.second);
+    }
+
+    /// @brief Encode an array as a list.
+    template <typename T, size_t size> bool encode(const std::array<T, size> &value)
+    {
+        return encode(value.data(), value.size());
+    }
+
+    template <typename T> bool encode(const T *value, const size_t &size)
+    {
+        if constexpr (TypedArray::isElement<T>) {
+            if (sink().encodeTypedArrays()) {
+                return encodeTypedArray(TypedArray::tag<T>(), (const uint8_t *)value, size * sizeof(T));
+            }
+        }
+        bool result = encodeListStart(size);
+        for (size_t i = 0; i < size; i++) {
+            result &= encode(value[i]);
+        }
+        return result && encodeListEnd(size);
+    }
+
+    /// @brief Encode an object (structure or class) as a map of its record members.
+    template <typename T>
+        requires std::is_class_v<T> && (!IsEncodable<T>)
+    bool encode(const T &value)
+    {
+        auto bound = internal::bind_to_tuple(value, [](auto &x) { return std::addressof(x); });
+        return std::apply(
+            [this]<typename... P>(P... members) {
+                // only fields that are ThingSet properties are encoded; anything else is skipped
+                constexpr uint32_t count = (0 + ... + (isRecordMember<P>() ? 1 : 0));
+                bool result = encodeMapStart(count);
+                ((result = result && encodeRecordMember(members)), ...);
+                return result && encodeMapEnd(count);
+            },
+            bound);
+    }
+
+    template <typename... TArgs> bool encodeList(TArgs... args)
+    {
+        const size_t count = sizeof...(TArgs);
+        return encodeListStart(count) && (encode(args) && ...) && encodeListEnd(count);
+    }
+
+private:
+    template <typename P> static constexpr bool isRecordMember()
+    {
+        return std::is_convertible_v<P, const ThingSetEncodable *> && std::is_convertible_v<P, const ThingSetNode *>;
+    }
+
+    template <typename P> bool encodeRecordMember(P member)
+    {
+        if constexpr (isRecordMember<P>()) {
+            using Member = std::remove_pointer_t<P>;
+            bool key = sink().encodeKeysAsIds() ? encode(Member::id) : encode(Member::name);
+            return key && encode(member->getValue());
+        }
+        else {
+            return true;
+        }
+    }
+
+    bool encodeContainerStart(CborWriter::MajorType major, uint32_t count)
+    {
+        zcbor_state_t *state = next();
+        if (!state) {
+            return false;
+        }
+        if (sink().getIsForwardOnly()) {
+            return CborWriter::writeContainerStart(state, major, count, nullptr);
+        }
+        CborWriter::Container *container = sink().pushContainer();
+        if (!container) {
+            return false;
+        }
+        if (!CborWriter::writeContainerStart(state, major, count, container)) {
+            sink().popContainer();
+            return false;
+        }
+        return true;
+    }
+
+    bool encodeContainerEnd(CborWriter::MajorType major, uint32_t count)
+    {
+        zcbor_state_t *state = next();
+        if (!state) {
+            return false;
+        }
+        // a forward-only encoding has already written the number of elements,
+        // so there is nothing to do
+        if (sink().getIsForwardOnly()) {
+            return CborWriter::writeContainerEnd(state, major, count, nullptr);
+        }
+        CborWriter::Container *container = sink().popContainer();
+        return container && CborWriter::writeContainerEnd(state, major, count, container);
+    }
+};
+
+} // namespace ThingSet
@@ -37,6 +37,81 @@ public:
         return true;
     }
 
+    /// @brief Whether to encode floats in their shortest exact form. This
+    /// follows CONFIG_THINGSET_PLUS_PLUS_SHORTEST_FLOATS, as reports do.
+    bool encodeShortestFloats() const override
+    {
+        return BINARY_ENCODER_DEFAULT_SHORTEST_FLOATS;
+    }
+
+    /// @brief A view of a streaming encoder whose encoding methods are
+    /// resolved at compile time; see @ref InlineThingSetBinaryEncoder.
+    /// Values written through the view are flushed by the underlying encoder.
+    class Inline : public InlineThingSetBinaryEncoder<Inline>
+    {
+    private:
+        StreamingThingSetBinaryEncoder &_encoder;
+        const bool _shortestFloats;
+
+    public:
+        Inline(StreamingThingSetBinaryEncoder &encoder)
+            : _encoder(encoder), _shortestFloats(encoder.encodeShortestFloats())
+        {}
+
+        zcbor_state_t *getState()
+        {
+            return _encoder._state;
+        }
+
+        bool ensureState()
+        {
+            return _encoder.writeIfNecessary();
+        }
+
+        bool getIsForwardOnly() const
+        {
+            return true;
+        }
+
+        CborWriter::Container *pushContainer()
+        {
+            return nullptr;
+        }
+
+        CborWriter::Container *popContainer()
+        {
+            return nullptr;
+        }
+
+        bool encodeKeysAsIds() const
+        {
+            return true;
+        }
+
+        bool encodeShortestFloats() const
+        {
+            return _shortestFloats;
+        }
+
+        bool encodeTypedArrays() const
+        {
+            // a typed array is a single byte string, which a streaming
+            // decoder can only decode if it fits in one chunk
+            return false;
+        }
+
+        size_t getEncodedLength() const
+        {
+            return _encoder._exportedLength;
+        }
+    };
+
+    /// @brief Gets a view of this encoder whose encoding methods can be inlined.
+    Inline inlined()
+    {
+        return Inline(*this);
+    }
+
     template <typename T> bool encodePair(uint32_t id, T &value)
     {
         return encode(id) && encode(value);
@@ -84,19 +159,22 @@ private:
     /// @return True if writing succeeded or was not necessary; false if writing failed.
     bool writeIfNecessary()
     {
+        // the data size is the chunk size less the header, so the buffer
+        // only needs writing once data extends beyond the first chunk
+        if (_state->payload <= &_buffer[Size]) {
+            return true;
+        }
         size_t headerSize = this->headerSize();
         size_t dataSize = Size - headerSize;
         size_t currentPos = _state->payload - &_buffer[headerSize];
-        if (currentPos > dataSize) {
-            if (!write(dataSize, false)) {
-                // not sure what else to do with this for now
-                return false;
-            }
-            memmove(&_buffer[headerSize], &_buffer[Size], Size); // move to start
-            _exportedLength += dataSize; // keep track
-            size_t newPos = currentPos - dataSize;
-            zcbor_update_state(_state, &_buffer[headerSize + newPos], _buffer.size() - newPos);
+        if (!write(dataSize, false)) {
+            // not sure what else to do with this for now
+            return false;
         }
+        memmove(&_buffer[headerSize], &_buffer[Size], Size); // move to start
+        _exportedLength += dataSize; // keep track
+        size_t newPos = currentPos - dataSize;
+        zcbor_update_state(_state, &_buffer[headerSize + newPos], _buffer.size() - newPos);
         return true;
     }
 };
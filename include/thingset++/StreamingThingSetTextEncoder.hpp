@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "thingset++/ThingSetTextEncoder.hpp"
+#include "thingset++/internal/FunctionRef.hpp"
+
+namespace ThingSet {
+
+/// @brief Text encoder which writes its buffer out in chunks whenever it fills,
+/// so that it can encode JSON of any length in a buffer of fixed size.
+class StreamingThingSetTextEncoder : public ThingSetTextEncoder
+{
+private:
+    FunctionRef<bool(const uint8_t *, size_t)> _writer;
+    size_t _reserved;
+    size_t _writtenLength;
+
+public:
+    /// @brief Creates an encoder.
+    /// @param buffer The buffer.
+    /// @param size The size of the buffer.
+    /// @param reserved The number of bytes at the start of the buffer which are
+    /// not encoded into, but are written out with the first chunk, such as the
+    /// header of a response.
+    /// @param writer Writes out a chunk, returning true if successful.
+    /// @param opts Options for rendering.
+    StreamingThingSetTextEncoder(char *buffer, size_t size, size_t reserved,
+                                 FunctionRef<bool(const uint8_t *, size_t)> writer,
+                                 TextEncoderOptions opts = TextEncoderOptions::none)
+        : ThingSetTextEncoder(buffer + reserved, size - reserved, opts), _writer(writer), _reserved(reserved),
+          _writtenLength(0)
+    {}
+
+    size_t getEncodedLength() const override
+    {
+        return _writtenLength + ThingSetTextEncoder::getEncodedLength();
+    }
+
+    /// @brief Gets the number of bytes written out so far, including the
+    /// reserved bytes once the first chunk has been written.
+    size_t getWrittenLength() const
+    {
+        return _writtenLength > 0 ? _reserved + _writtenLength : 0;
+    }
+
+protected:
+    bool writeChunk(const char *buffer, size_t length) override
+    {
+        const uint8_t *start = reinterpret_cast<const uint8_t *>(buffer);
+        size_t total = length;
+        if (_writtenLength == 0) {
+            // the reserved bytes immediately precede the encoded ones
+            start -= _reserved;
+            total += _reserved;
+        }
+        if (!_writer(start, total)) {
+            return false;
+        }
+        _writtenLength += length;
+        return true;
+    }
+};
+
+} // namespace ThingSet
@@ -8,6 +8,8 @@
 #include "thingset++/ThingSetGroup.hpp"
 #include "thingset++/ThingSetProperty.hpp"
 #include "thingset++/ThingSetRecordMember.hpp"
+#include "thingset++/ThingSetReportingPolicy.hpp"
+#include "thingset++/ThingSetStaticRegistry.hpp"
 
 #ifdef __ZEPHYR__
 #ifdef CONFIG_THINGSET_PLUS_PLUS_SERVER
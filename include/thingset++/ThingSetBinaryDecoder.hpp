@@ -62,6 +62,7 @@ public:
 
     using ThingSetDecoder::decode;
     bool decode(std::string *value) override;
+    bool decode(std::string_view *value) override;
     bool decode(char *value, size_t size) override;
     bool decode(float *value) override;
     bool decode(double *value) override;
@@ -88,6 +89,8 @@ protected:
     bool isInMap() const override;
     bool isInList() const override;
     bool ensureListSize(const size_t size, size_t &elementCount) override;
+    bool peekTypedArray() override;
+    bool decodeTypedArray(const uint8_t tag, uint8_t *buffer, const size_t elementSize, const size_t size) override;
 };
 
 template <int depth = BINARY_DECODER_DEFAULT_MAX_DEPTH>
@@ -5,24 +5,47 @@
  */
 #pragma once
 
+#include "thingset++/InlineThingSetBinaryEncoder.hpp"
 #include "thingset++/ThingSetEncoder.hpp"
 #include "zcbor_encode.h"
 
-#define BINARY_ENCODER_MAX_NULL_TERMINATED_STRING_LENGTH 256
-#define BINARY_ENCODER_DEFAULT_MAX_DEPTH                 8
+#ifdef CONFIG_THINGSET_PLUS_PLUS_SHORTEST_FLOATS
+#define BINARY_ENCODER_DEFAULT_SHORTEST_FLOATS true
+#else
+#define BINARY_ENCODER_DEFAULT_SHORTEST_FLOATS false
+#endif
+
+#ifdef CONFIG_THINGSET_PLUS_PLUS_TYPED_ARRAYS
+#define BINARY_ENCODER_DEFAULT_TYPED_ARRAYS true
+#else
+#define BINARY_ENCODER_DEFAULT_TYPED_ARRAYS false
+#endif
 
 namespace ThingSet {
 
-/// @brief Binary protocol encoder for ThingSet.
-class ThingSetBinaryEncoder : public ThingSetEncoder
+/// @brief Binary protocol encoder for ThingSet. This adapts the inline encoder
+/// to the polymorphic encoder interface.
+class ThingSetBinaryEncoder : public ThingSetEncoder, protected InlineThingSetBinaryEncoder<ThingSetBinaryEncoder>
 {
+    friend class InlineThingSetBinaryEncoder<ThingSetBinaryEncoder>;
+    using Inline = InlineThingSetBinaryEncoder<ThingSetBinaryEncoder>;
+
 protected:
     virtual bool ensureState();
     virtual zcbor_state_t *getState() = 0;
     virtual bool getIsForwardOnly() const;
+    /// @brief Whether floats and doubles are encoded in the shortest of half,
+    /// single or double precision which represents each value exactly.
+    virtual bool encodeShortestFloats() const;
+    /// @brief Opens a list or map. Encoders which are not forward-only must
+    /// implement this and @ref popContainer.
+    /// @return The container, or null if too many are open.
+    virtual CborWriter::Container *pushContainer();
+    virtual CborWriter::Container *popContainer();
 
 public:
     using ThingSetEncoder::encode;
+    using ThingSetEncoder::encodeList;
     bool encode(const std::string_view &value) override;
     bool encode(std::string_view &value) override;
     bool encode(const std::string &value) override;
@@ -86,10 +109,16 @@ public:
     /// @param size The number of bytes in the array.
     /// @return True if encoding succeeded, otherwise false.
     bool encodeBytes(const uint8_t *buffer, const size_t &size) override;
+    /// @brief Write data which is already CBOR-encoded, as is.
+    /// @param buffer The encoded data.
+    /// @param size The length of the data.
+    /// @return True if writing succeeded, otherwise false.
+    bool encodeEncoded(const uint8_t *buffer, size_t size);
 
 protected:
     bool encodeListSeparator() override;
     bool encodeKeyValuePairSeparator() override;
+    bool encodeTypedArray(const uint8_t tag, const uint8_t *buffer, const size_t &length) override;
 };
 
 /// @brief Options to control the behaviour of the encoder.
@@ -97,6 +126,14 @@ enum ThingSetBinaryEncoderOptions
 {
     /// @brief If set, encodes keys as integer IDs. If unset, keys are encoded as string names.
     encodeKeysAsIds = 1 << 0,
+    /// @brief If set, encodes each float or double as a half-, single- or double-precision
+    /// float, whichever is the shortest to represent it exactly. If unset, floats are always
+    /// encoded in single precision and doubles in double precision.
+    shortestFloats = 1 << 1,
+    /// @brief If set, encodes arrays of integers and floats as RFC 8746 typed arrays, which
+    /// are copied to and from memory in bulk. If unset, arrays are encoded as lists, which
+    /// any peer can decode.
+    typedArrays = 1 << 2,
 };
 
 template <int depth = BINARY_ENCODER_DEFAULT_MAX_DEPTH>
@@ -105,13 +142,24 @@ class FixedDepthThingSetBinaryEncoder : public virtual ThingSetBinaryEncoder
 private:
     // The start of the buffer
     const uint8_t *_buffer;
-    zcbor_state_t _state[depth];
+    zcbor_state_t _state;
+    CborContainerStack<depth> _containers;
     const ThingSetBinaryEncoderOptions _options;
 
 protected:
     zcbor_state_t *getState() override
     {
-        return _state;
+        return &_state;
+    }
+
+    CborWriter::Container *pushContainer() override
+    {
+        return _containers.push();
+    }
+
+    CborWriter::Container *popContainer() override
+    {
+        return _containers.pop();
     }
 
     bool encodeKeysAsIds() const override
@@ -119,6 +167,16 @@ protected:
         return (_options & ThingSetBinaryEncoderOptions::encodeKeysAsIds);
     }
 
+    bool encodeShortestFloats() const override
+    {
+        return (_options & ThingSetBinaryEncoderOptions::shortestFloats);
+    }
+
+    bool encodeTypedArrays() const override
+    {
+        return (_options & ThingSetBinaryEncoderOptions::typedArrays);
+    }
+
 public:
     template <size_t Size>
     FixedDepthThingSetBinaryEncoder(std::array<uint8_t, Size> &buffer) : FixedDepthThingSetBinaryEncoder(buffer.data(), Size)
@@ -136,15 +194,152 @@ public:
 
     FixedDepthThingSetBinaryEncoder(uint8_t *buffer, size_t size, size_t elementCount, ThingSetBinaryEncoderOptions options) : _buffer(buffer), _options(options)
     {
-        zcbor_new_encode_state(_state, depth, buffer, size, elementCount);
+        zcbor_new_encode_state(&_state, 1, buffer, size, elementCount);
     }
 
     size_t getEncodedLength() const override
     {
-        return _state->payload - _buffer;
+        return _state.payload - _buffer;
     }
 };
 
 using DefaultFixedDepthThingSetBinaryEncoder = FixedDepthThingSetBinaryEncoder<BINARY_ENCODER_DEFAULT_MAX_DEPTH>;
 
+/// @brief Binary protocol encoder for ThingSet which writes to a fixed buffer.
+/// Unlike @ref FixedDepthThingSetBinaryEncoder, it has no virtual methods, so
+/// encoding calls can be inlined.
+/// @tparam depth The maximum depth of nesting of lists and maps.
+template <int depth = BINARY_ENCODER_DEFAULT_MAX_DEPTH>
+class FixedDepthInlineThingSetBinaryEncoder
+    : public InlineThingSetBinaryEncoder<FixedDepthInlineThingSetBinaryEncoder<depth>>
+{
+private:
+    // The start of the buffer
+    const uint8_t *_buffer;
+    zcbor_state_t _state;
+    CborContainerStack<depth> _containers;
+    const ThingSetBinaryEncoderOptions _options;
+
+public:
+    template <size_t Size>
+    FixedDepthInlineThingSetBinaryEncoder(std::array<uint8_t, Size> &buffer) : FixedDepthInlineThingSetBinaryEncoder(buffer.data(), Size)
+    {}
+
+    FixedDepthInlineThingSetBinaryEncoder(uint8_t *buffer, size_t size) : FixedDepthInlineThingSetBinaryEncoder(buffer, size, 1)
+    {}
+
+    FixedDepthInlineThingSetBinaryEncoder(uint8_t *buffer, size_t size, size_t elementCount) : FixedDepthInlineThingSetBinaryEncoder(buffer, size, elementCount, ThingSetBinaryEncoderOptions::encodeKeysAsIds)
+    {}
+
+    FixedDepthInlineThingSetBinaryEncoder(uint8_t *buffer, size_t size, size_t elementCount, ThingSetBinaryEncoderOptions options) : _buffer(buffer), _options(options)
+    {
+        zcbor_new_encode_state(&_state, 1, buffer, size, elementCount);
+    }
+
+    zcbor_state_t *getState()
+    {
+        return &_state;
+    }
+
+    CborWriter::Container *pushContainer()
+    {
+        return _containers.push();
+    }
+
+    CborWriter::Container *popContainer()
+    {
+        return _containers.pop();
+    }
+
+    bool ensureState()
+    {
+        return true;
+    }
+
+    bool getIsForwardOnly() const
+    {
+        return false;
+    }
+
+    bool encodeKeysAsIds() const
+    {
+        return (_options & ThingSetBinaryEncoderOptions::encodeKeysAsIds);
+    }
+
+    bool encodeShortestFloats() const
+    {
+        return (_options & ThingSetBinaryEncoderOptions::shortestFloats);
+    }
+
+    bool encodeTypedArrays() const
+    {
+        return (_options & ThingSetBinaryEncoderOptions::typedArrays);
+    }
+
+    size_t getEncodedLength() const
+    {
+        return _state.payload - _buffer;
+    }
+};
+
+/// @brief Presents an inline encoder through the polymorphic encoder interface,
+/// for values, such as properties and groups, which can only be encoded that way.
+/// @tparam Sink The type of the inline encoder.
+template <typename Sink>
+class ThingSetBinaryEncoderAdapter : public ThingSetBinaryEncoder
+{
+private:
+    Sink &_sink;
+
+public:
+    ThingSetBinaryEncoderAdapter(Sink &sink) : _sink(sink)
+    {}
+
+    size_t getEncodedLength() const override
+    {
+        return _sink.getEncodedLength();
+    }
+
+    bool encodeKeysAsIds() const override
+    {
+        return _sink.encodeKeysAsIds();
+    }
+
+    bool encodeTypedArrays() const override
+    {
+        return _sink.encodeTypedArrays();
+    }
+
+protected:
+    bool ensureState() override
+    {
+        return _sink.ensureState();
+    }
+
+    zcbor_state_t *getState() override
+    {
+        return _sink.getState();
+    }
+
+    bool getIsForwardOnly() const override
+    {
+        return _sink.getIsForwardOnly();
+    }
+
+    bool encodeShortestFloats() const override
+    {
+        return _sink.encodeShortestFloats();
+    }
+
+    CborWriter::Container *pushContainer() override
+    {
+        return _sink.pushContainer();
+    }
+
+    CborWriter::Container *popContainer() override
+    {
+        return _sink.popContainer();
+    }
+};
+
 }; // namespace ThingSet
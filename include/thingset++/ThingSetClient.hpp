@@ -115,12 +115,12 @@ private:
     /// @tparam T The type of the value returned by an invocation, if any.
     /// @param id The integer identifier of the value to get or function to invoke, etc.
     /// @param type The request type.
-    /// @param encode A function to encode any additional data in a request.
+    /// @param encode A function to encode any additional data in a request, which is passed a pointer to the encoder.
     /// @param value A pointer to a variable which will contain the decoded result, if any. Pass null if no result is expected.
     /// @return True if invocation succeeded, otherwise false.
-    template <typename Id, typename T>
+    template <typename Id, typename Encode, typename T>
         requires std::is_integral_v<Id> or std::is_convertible_v<Id, std::string_view>
-    ThingSetResult doRequest(const Id &id, ThingSetBinaryRequestType type, std::function<bool (ThingSetBinaryEncoder *)> encode, T *value)
+    ThingSetResult doRequest(const Id &id, ThingSetBinaryRequestType type, Encode encode, T *value)
     {
         uint8_t *responseBuffer;
         size_t responseSize;
@@ -136,21 +136,22 @@ private:
         return result;
     }
 
-    template <typename Id>
+    template <typename Id, typename Encode>
         requires std::is_integral_v<Id> or std::is_convertible_v<Id, std::string_view>
-    ThingSetResult doRequest(const Id &id, ThingSetBinaryRequestType type, std::function<bool (ThingSetBinaryEncoder *)> encode)
+    ThingSetResult doRequest(const Id &id, ThingSetBinaryRequestType type, Encode encode)
     {
         uint8_t *responseBuffer;
         size_t responseSize;
         return doRequestCore(id, type, encode, &responseBuffer, responseSize);
     }
 
-    template <typename Id>
+    template <typename Id, typename Encode>
         requires std::is_integral_v<Id> or std::is_convertible_v<Id, std::string_view>
-    ThingSetResult doRequestCore(const Id &id, ThingSetBinaryRequestType type, std::function<bool (ThingSetBinaryEncoder *)> encode, uint8_t **responseBuffer, size_t &responseSize)
+    ThingSetResult doRequestCore(const Id &id, ThingSetBinaryRequestType type, Encode &encode, uint8_t **responseBuffer, size_t &responseSize)
     {
         _txBuffer[0] = (uint8_t)type;
-        FixedDepthThingSetBinaryEncoder encoder(_txBuffer + 1, _txBufferSize - 1);
+        // the encoder's type is known to the callback, so its calls can be inlined
+        FixedDepthInlineThingSetBinaryEncoder encoder(_txBuffer + 1, _txBufferSize - 1);
         if (!encoder.encode(id) || !encode(&encoder)) {
             return ThingSetResult(ThingSetStatusCode::requestIncomplete);
         }
@@ -7,8 +7,11 @@
 
 #include <cstdint>
 #include <string>
-#include <functional>
+#include <string_view>
 #include <optional>
+#include <vector>
+#include "internal/FunctionRef.hpp"
+#include "internal/TypedArray.hpp"
 #include "internal/bind_to_tuple.hpp"
 
 namespace ThingSet {
@@ -32,6 +35,12 @@ class ThingSetDecoder
 {
 public:
     virtual bool decode(std::string *value) = 0;
+    /// @brief Decode a string without copying it.
+    /// @param value When the method returns, points to the string in the
+    /// buffer being decoded, so is only valid for as long as that buffer is.
+    /// Streaming decoders may reuse the buffer once the next item is decoded.
+    /// @return True if decoding succeeded, otherwise false.
+    virtual bool decode(std::string_view *value) = 0;
     virtual bool decode(char *value, size_t size) = 0;
     virtual bool decode(float *value) = 0;
     virtual bool decode(double *value) = 0;
@@ -51,7 +60,7 @@ public:
     /// index of the current element. The callback should decode the value and return true
     /// if successful, otherwise false.
     /// @return True if decoding succeeded, otherwise false.
-    bool decodeList(std::function<bool(size_t)> callback);
+    bool decodeList(FunctionRef<bool(size_t)> callback);
     virtual bool decodeListStart() = 0;
     virtual bool decodeListEnd() = 0;
 
@@ -94,13 +103,20 @@ public:
         return false;
     }
 
-    /// @brief Decode a list into an array of the specified length.
+    /// @brief Decode a list into an array of the specified length. Arrays of
+    /// numbers may also be decoded from RFC 8746 typed arrays.
     /// @tparam T The type of items in the array.
     /// @param value A pointer to the start of the array into which list elements should be decoded.
     /// @param size The length of the array.
     /// @return True if decoding succeeded, otherwise false.
     template <typename T> bool decode(T *value, size_t size)
     {
+        if constexpr (TypedArray::isElement<T>) {
+            if (peekTypedArray()) {
+                return decodeTypedArray(TypedArray::tag<T>(), (uint8_t *)value, sizeof(T), size);
+            }
+        }
+
         if (!decodeListStart()) {
             return false;
         }
@@ -175,7 +191,7 @@ public:
     /// @param callback The callback to be invoked each time a key is decoded. This callback should decode the value and
     /// return true, or fail and return false.
     /// @return True if decoding succeeded, otherwise false.
-    template <typename K> bool decodeMap(std::function<bool(K &)> callback)
+    template <typename K> bool decodeMap(FunctionRef<bool(K &)> callback)
     {
         if (!decodeMapStart()) {
             return false;
@@ -194,17 +210,18 @@ public:
     }
 
     /// @brief Decodes a map by iterating over its keys and invoking a callback for each key, where the key may
-    /// be an integer or a string.
+    /// be an integer or a string. Names point into the buffer being decoded, as
+    /// with @ref decode(std::string_view *), so should not be kept beyond the callback.
     /// @param callback The callback to be invoked each time a key is decoded. This callback should decode the value and
     /// return true, or fail and return false.
     /// @return True if decoding succeeded, otherwise false.
-    bool decodeMap(std::function<bool(std::optional<std::uint32_t>, std::optional<std::string>)> callback)
+    bool decodeMap(FunctionRef<bool(std::optional<std::uint32_t>, std::optional<std::string_view>)> callback)
     {
         if (!decodeMapStart()) {
             return false;
         }
         std::optional<uint32_t> id;
-        std::optional<std::string> name;
+        std::optional<std::string_view> name;
         while (decodeKey(id, name)) {
             if (!callback(id, name)) {
                 return false;
@@ -233,8 +250,28 @@ protected:
     virtual bool isInList() const = 0;
     virtual bool ensureListSize(const size_t size, size_t &elementCount) = 0;
 
+    /// @brief Whether the next item is an RFC 8746 typed array.
+    virtual bool peekTypedArray()
+    {
+        return false;
+    }
+
+    /// @brief Decode a typed array into an array of numbers. Only called if
+    /// @ref peekTypedArray returns true.
+    /// @param tag The tag of the array being decoded into, in the byte order of
+    /// this machine.
+    /// @param buffer The array into which elements should be decoded.
+    /// @param elementSize The size of each element in bytes.
+    /// @param size The length of the array.
+    /// @return True if decoding succeeded, otherwise false.
+    virtual bool decodeTypedArray([[maybe_unused]] const uint8_t tag, [[maybe_unused]] uint8_t *buffer,
+                                  [[maybe_unused]] const size_t elementSize, [[maybe_unused]] const size_t size)
+    {
+        return false;
+    }
+
 private:
-    bool decodeKey(std::optional<uint32_t> &id, std::optional<std::string> &name);
+    bool decodeKey(std::optional<uint32_t> &id, std::optional<std::string_view> &name);
 
     // thanks to https://stackoverflow.com/questions/75163129/convert-variadic-template-ints-to-switch-statement?rq=3
     // adapted from https://stackoverflow.com/questions/46278997/variadic-templates-and-switch-statement
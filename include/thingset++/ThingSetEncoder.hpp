@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include "internal/TypedArray.hpp"
 #include "internal/bind_to_tuple.hpp"
 #include <array>
 #include <cstdint>
@@ -22,6 +23,10 @@ class ThingSetNode;
 template<typename T>
 concept IsEncodable = std::is_base_of_v<ThingSetEncodable, T>;
 
+/// Specifies a type which is probably a ThingSet property.
+template <typename T>
+concept EncodableNode = std::is_base_of_v<ThingSetNode, T> && std::is_base_of_v<ThingSetEncodable, T>;
+
 enum class TextEncoderOptions : uint32_t
 {
     none             = 0,
@@ -32,6 +37,9 @@ enum class TextEncoderOptions : uint32_t
     /// child groups (structure) and suppress leaf values. A direct
     /// query against the group itself still renders fully
     outlineGroups    = 1U << 1,
+    /// Encode floats and doubles with the fewest digits which read back as
+    /// the same value, rather than with a fixed number of decimal places
+    shortestFloats   = 1U << 2,
 
     displayFriendly  = abbreviateArrays | outlineGroups,
 };
@@ -243,6 +251,11 @@ public:
 
     template <typename T> bool encode(const T *value, const size_t &size)
     {
+        if constexpr (TypedArray::isElement<T>) {
+            if (encodeTypedArrays()) {
+                return encodeTypedArray(TypedArray::tag<T>(), (const uint8_t *)value, size * sizeof(T));
+            }
+        }
         const size_t rendered = renderedListLength(size);
         bool result = encodeListStart(size);
         for (size_t i = 0; i < rendered; i++) {
@@ -266,6 +279,14 @@ public:
     /// choose the right key form when emitting nested maps
     virtual bool encodeKeysAsIds() const = 0;
 
+    /// @brief Whether this encoder emits arrays of numbers as RFC 8746 typed
+    /// arrays, rather than as lists. Only peers which decode typed arrays can
+    /// read the result, so encoders must opt in
+    virtual bool encodeTypedArrays() const
+    {
+        return false;
+    }
+
     /// @brief Hook that lets encoders request groups be rendered as an
     /// outline (sub-groups only, leaf values suppressed) when they appear
     /// nested inside a larger response
@@ -295,6 +316,18 @@ protected:
     virtual bool encodeListSeparator() = 0;
     virtual bool encodeKeyValuePairSeparator() = 0;
 
+    /// @brief Encode an array of numbers as a typed array. Only called if
+    /// @ref encodeTypedArrays returns true.
+    /// @param tag The tag identifying the type and byte order of the elements.
+    /// @param buffer The elements, as they are laid out in memory.
+    /// @param length The length of the elements in bytes.
+    /// @return True if encoding succeeded, otherwise false.
+    virtual bool encodeTypedArray([[maybe_unused]] const uint8_t tag, [[maybe_unused]] const uint8_t *buffer,
+                                  [[maybe_unused]] const size_t &length)
+    {
+        return false;
+    }
+
 private:
     inline bool encodeAndShift()
     {
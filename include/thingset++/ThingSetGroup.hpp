@@ -9,6 +9,7 @@
 #include "thingset++/IdentifiableThingSetNode.hpp"
 #include "thingset++/ThingSetEncoder.hpp"
 #include "thingset++/ThingSetParentNode.hpp"
+#include <functional>
 
 namespace ThingSet {
 
@@ -73,31 +74,18 @@ public:
         const bool outline = encoder.renderGroupAsOutline();
         void *target;
 
-        auto shouldInclude = [&](ThingSetNode *child) {
-            if (!child->tryCastTo(ThingSetNodeType::encodable, &target)) {
-                return false;
-            }
-            if (outline && !child->tryCastTo(ThingSetNodeType::group, &target)) {
-                return false;
-            }
-            return true;
-        };
-
-        size_t count = 0;
-        for (ThingSetNode *child : *self) {
-            if (shouldInclude(child)) {
-                count++;
-            }
-        }
+        const uint32_t count = outline ? self->getGroupChildCount() : self->getEncodableChildCount();
         if (!encoder.encodeMapStart(count)) {
             return false;
         }
         for (ThingSetNode *child : *self) {
-            if (!shouldInclude(child)) {
+            if (!child->tryCastTo(ThingSetNodeType::encodable, &target)) {
                 continue;
             }
-            child->tryCastTo(ThingSetNodeType::encodable, &target);
             ThingSetEncodable *encodable = reinterpret_cast<ThingSetEncodable *>(target);
+            if (outline && !child->tryCastTo(ThingSetNodeType::group, &target)) {
+                continue;
+            }
             bool ok = encoder.encodeKeysAsIds()
                 ? encoder.encode(std::make_pair(child->getId(), encodable))
                 : encoder.encode(std::make_pair(child->getName(), encodable));
@@ -18,18 +18,28 @@ class ThingSetListener
 {
 private:
     ThingSetSubscriptionTransport<Identifier> &_transport;
+    Delegate<void(const Identifier &, uint16_t &)> _callback;
 
 public:
     ThingSetListener(ThingSetSubscriptionTransport<Identifier> &transport) : _transport(transport)
     {}
 
-    bool subscribe(std::function<void(const Identifier &, uint16_t &)> callback) {
-        _transport.subscribe([&](const Identifier &identifier, ThingSetBinaryDecoder &decoder) {
+    /// @brief Subscribe to reports, updating local nodes with the values they contain.
+    /// Each value is applied individually, so reports which include only some of the
+    /// nodes in a subset, such as those containing only changed values, are handled
+    /// like any other.
+    /// @param callback Invoked with the sender and ID of each node updated.
+    /// @return True.
+    bool subscribe(Delegate<void(const Identifier &, uint16_t &)> callback) {
+        // keep the callback here, so that the transport need only hold this listener
+        _callback = std::move(callback);
+        _transport.subscribe([this](const Identifier &identifier, ThingSetBinaryDecoder &decoder) {
             uint16_t subsetId;
             if (!decoder.decode(&subsetId)) {
                 return;
             }
 
+            ThingSetRegistry::ReadGuard guard;
             if (!decoder.decodeMap<uint16_t>([&](uint16_t id) {
                 ThingSetNode *node;
                 if (!ThingSetRegistry::findById(id, &node)) {
@@ -39,7 +49,7 @@ public:
                 if (node->tryCastTo(ThingSetNodeType::decodable, &target)) {
                     ThingSetBinaryDecodable *decodable = reinterpret_cast<ThingSetBinaryDecodable *>(target);
                     if (decodable->decode(decoder)) {
-                        callback(identifier, id);
+                        _callback(identifier, id);
                         return true;
                     } else {
                         return false;
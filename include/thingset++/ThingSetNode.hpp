@@ -23,7 +23,8 @@ enum ThingSetNodeType
     function = 64 | hasChildren,
     group = 128 | hasChildren,
     record = 256 | hasChildren | requestHandler,
-    recordMember = 512 | value
+    recordMember = 512 | value,
+    reportable = 1024
 };
 
 class ThingSetRegistry;
@@ -38,6 +39,7 @@ friend class ThingSetParentNode;
 private:
     IntrusiveLinkedListNode list;
     IntrusiveLinkedListNode children;
+    IntrusiveLinkedListNode subset;
 
 public:
     constexpr ThingSetNode()
@@ -8,7 +8,7 @@
 
 #include "thingset++/ThingSetNode.hpp"
 #include "thingset++/internal/IntrusiveLinkedList.hpp"
-#include <list>
+#include <string_view>
 
 namespace ThingSet {
 
@@ -34,6 +34,14 @@ friend class ThingSetRegistry;
 
 private:
     IntrusiveLinkedList<ThingSetNode, &ThingSetNode::children> _children;
+    /// @brief Incremented whenever a child is added or removed.
+    uint32_t _generation = 0;
+    /// @brief The number of encodable children (bits 0-15) and of child
+    /// groups (bits 16-31), tagged with the generation in which they were
+    /// counted (bits 32-63). Children are counted lazily because nodes
+    /// register from base class constructors, before their final type is
+    /// known. Counts which do not fit in 16 bits are not cached.
+    uint64_t _childCounts = 0;
 
 public:
     typedef IntrusiveLinkedList<ThingSetNode, &ThingSetNode::children>::iterator ChildIterator;
@@ -48,13 +56,22 @@ public:
     /// @param node When the method returns, contains a pointer to the node if it was found.
     /// @param index When the method returns, contains the array index if relevant.
     /// @return True if the node was found, otherwise false.
-    virtual bool findByName(const std::string &name, ThingSetNode **node, size_t *index);
+    virtual bool findByName(std::string_view name, ThingSetNode **node, size_t *index);
 
     virtual bool invokeCallback(ThingSetNode *node, ThingSetCallbackReason reason) const = 0;
 
+    /// @brief Gets the number of children which are encodable, so that they
+    /// can be encoded in a single pass.
+    uint32_t getEncodableChildCount();
+
+    /// @brief Gets the number of children which are groups.
+    uint32_t getGroupChildCount();
+
 private:
     bool addChild(ThingSetNode *child);
     bool removeChild(ThingSetNode *child);
+    bool unlinkChild(ThingSetNode *child);
+    void getChildCounts(uint32_t &encodable, uint32_t &groups);
 };
 
 } // namespace ThingSet
\ No newline at end of file
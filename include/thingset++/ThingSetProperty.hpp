@@ -9,6 +9,7 @@
 #include "thingset++/ThingSetCustomRequestHandler.hpp"
 #include "thingset++/ThingSetType.hpp"
 #include "thingset++/ThingSetValue.hpp"
+#include <charconv>
 
 namespace ThingSet {
 
@@ -319,13 +320,12 @@ public:
         return Access;
     }
 
-    bool findByName(const std::string &name, ThingSetNode **node, size_t *index) override
+    bool findByName(std::string_view name, ThingSetNode **node, size_t *index) override
     {
         bool foundChild = ThingSetParentNode::findByName(name, node, index);
-        // atoi is useless - it returns 0 on failure - so we check that the string actually
-        // contains a number before trying to parse it
-        if (name.c_str()[0] >= '0' && name.c_str()[0] <= '9') {
-            *index = std::atoi(name.c_str());
+        // check that the string actually contains a number before trying to parse it
+        if (!name.empty() && name[0] >= '0' && name[0] <= '9') {
+            std::from_chars(name.data(), name.data() + name.size(), *index);
             return *index < Size;
         }
 
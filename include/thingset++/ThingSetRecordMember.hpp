@@ -139,6 +139,7 @@ public:
 
     constexpr static const unsigned id = Id;
     constexpr static const std::string_view &name = Name.string_view();
+    constexpr static const uint32_t key = ThingSetRegistry::nodeKey(Id, ParentId);
 };
 
 template <uint16_t Id, uint16_t ParentId, StringLiteral Name, ThingSetAccess Access, typename T, typename SubsetType, SubsetType Subset>
@@ -271,6 +272,7 @@ public:
 
     constexpr static const uint16_t id = Id;
     constexpr static const std::string_view &name = Name.string_view();
+    constexpr static const uint32_t key = ThingSetRegistry::nodeKey(Id, ParentId);
 };
 
 template <uint16_t Id, uint16_t ParentId, StringLiteral Name, ThingSetAccess Access, typename T, typename SubsetType, SubsetType Subset>
@@ -414,13 +416,12 @@ public:
         return Access;
     }
 
-    bool findByName(const std::string &name, ThingSetNode **node, size_t *index) override
+    bool findByName(std::string_view name, ThingSetNode **node, size_t *index) override
     {
         bool foundChild = ThingSetParentNode::findByName(name, node, index);
-        // atoi is useless - it returns 0 on failure - so we check that the string actually
-        // contains a number before trying to parse it
-        if (name.c_str()[0] >= '0' && name.c_str()[0] <= '9') {
-            *index = std::atoi(name.c_str());
+        // check that the string actually contains a number before trying to parse it
+        if (!name.empty() && name[0] >= '0' && name[0] <= '9') {
+            std::from_chars(name.data(), name.data() + name.size(), *index);
             return true;
         }
 
@@ -439,6 +440,7 @@ public:
 
     constexpr static const unsigned id = Id;
     constexpr static const std::string_view &name = Name.string_view();
+    constexpr static const uint32_t key = ThingSetRegistry::nodeKey(Id, ParentId);
 };
 
 template <uint16_t Id, uint16_t ParentId, StringLiteral Name, ThingSetAccess Access, typename Element, std::size_t Size, typename SubsetType, SubsetType Subset>
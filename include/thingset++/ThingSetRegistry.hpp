@@ -5,26 +5,63 @@
  */
 #pragma once
 
-#include "thingset++/FlatteningIterator.hpp"
 #include "thingset++/StringLiteral.hpp"
 #include "thingset++/ThingSetParentNode.hpp"
+#include "thingset++/internal/FunctionRef.hpp"
+#include "thingset++/internal/OpenAddressedIndex.hpp"
+#include "thingset++/internal/PathCache.hpp"
+#include "thingset++/internal/Snapshot.hpp"
+#include "thingset++/internal/shared.hpp"
 #include <array>
-#include <functional>
-#include <list>
-#include <ranges>
+#include <bit>
+#ifdef ENABLE_CONCURRENT_REGISTRY
+#include "thingset++/internal/EpochDomain.hpp"
+#include <vector>
+#endif
 
-#define NODE_MAP_LOOKUP_BUCKETS 8
+#ifndef CONFIG_THINGSET_PLUS_PLUS_PATH_CACHE_SIZE
+#define CONFIG_THINGSET_PLUS_PLUS_PATH_CACHE_SIZE 16
+#endif
+
+#ifndef CONFIG_THINGSET_PLUS_PLUS_PATH_CACHE_MAX_LENGTH
+#define CONFIG_THINGSET_PLUS_PLUS_PATH_CACHE_MAX_LENGTH 48
+#endif
 
 namespace ThingSet {
 
 /// @brief Repository of all current ThingSet nodes.
+///
+/// If ENABLE_CONCURRENT_REGISTRY is defined, nodes may be registered and
+/// unregistered on one thread while others look nodes up. Lookups take no
+/// locks; a thread which uses the nodes it finds, or iterates the registry
+/// or a node's children, should hold a ReadGuard while it does so. Nodes
+/// registered or unregistered meanwhile may or may not be visited.
 class ThingSetRegistry
 {
+#ifdef ENABLE_CONCURRENT_REGISTRY
+friend struct ReaderState;
+#endif
+
 public:
     typedef IntrusiveLinkedList<ThingSetNode, &ThingSetNode::list> NodeList;
-    typedef std::array<NodeList, NODE_MAP_LOOKUP_BUCKETS> NodeMap;
+    typedef OpenAddressedIndex<ThingSetNode> NodeIndex;
+    typedef Snapshot<NodeIndex> NodeIndexSnapshot;
+    typedef IntrusiveLinkedList<ThingSetNode, &ThingSetNode::children> OrphanList;
+    typedef IntrusiveLinkedList<ThingSetNode, &ThingSetNode::subset> SubsetList;
+    typedef PathCache<ThingSetNode, CONFIG_THINGSET_PLUS_PLUS_PATH_CACHE_SIZE,
+                      CONFIG_THINGSET_PLUS_PLUS_PATH_CACHE_MAX_LENGTH> NodePathCache;
 
 private:
+    /// @brief Registered nodes which share the same subsets.
+    struct SubsetMembers
+    {
+        uint32_t subsets;
+        SubsetList nodes;
+        /// @brief Members with other subsets. Groups are only ever appended,
+        /// never removed, so readers can follow this without a lock.
+        SubsetMembers *next;
+    };
+
     template <uint16_t Id, uint16_t ParentId, StringLiteral Name>
     class OverlayNode : public ThingSetParentNode
     {
@@ -71,25 +108,189 @@ private:
         }
     };
 
-    NodeMap _nodeMap;
+    /// @brief All registered nodes, in order of registration.
+    NodeList _nodes;
+    /// @brief Index of registered nodes by effective ID. If the static registry
+    /// is enabled, nodes in it are indexed there instead.
+    NodeIndexSnapshot _index;
+    /// @brief Index of child nodes by parent and name.
+    NodeIndexSnapshot _childIndex;
+    /// @brief Nodes whose parents have not been registered, by parent ID.
+    /// Orphans are linked via the same member as children, since a node
+    /// can never be both.
+    OpenAddressedIndex<OrphanList> _orphans;
+    /// @brief The number of registered nodes in each single-bit subset.
+    std::array<uint32_t, 32> _subsetCounts;
+    /// @brief Registered nodes in any subset, grouped by their subsets.
+    SubsetMembers *_subsetMembers;
+    /// @brief Incremented whenever a node is registered or unregistered.
+    uint32_t _generation;
+#ifdef ENABLE_CONCURRENT_REGISTRY
+    /// @brief Tracks readers, so that writers know when unpublished indexes
+    /// and unlinked nodes are no longer in use.
+    EpochDomain _epochs;
+    /// @brief Nodes unlinked from the list of all nodes whose links must be
+    /// cleared once no reader can be traversing them.
+    std::vector<ThingSetNode *> _unlinkedNodes;
+    /// @brief As above, but unlinked from the children of a parent.
+    std::vector<ThingSetNode *> _unlinkedChildren;
+    /// @brief As above, but unlinked from the members of their subsets.
+    std::vector<ThingSetNode *> _unlinkedMembers;
+    /// @brief Children of an unregistered parent which become orphans once
+    /// their links have been cleared.
+    std::vector<ThingSetNode *> _pendingOrphans;
+#else
+    /// @brief Results of recent lookups by full path.
+    NodePathCache _pathCache;
+#endif
     OverlayNode<0, 0, ""> _rootNode;
     OverlayNode<25, 0, "_Metadata"> _metadataNode;
 
     ThingSetRegistry();
 
 public:
+    /// @brief Marks a read-side critical section, during which nodes found in
+    /// the registry will not be unregistered from under the caller; that is,
+    /// unregistering a node waits for any such sections to end. Read guards
+    /// may be nested, and take no locks unless the configured maximum number
+    /// of reader threads has been exceeded.
+    class ReadGuard
+    {
+    public:
+#ifdef ENABLE_CONCURRENT_REGISTRY
+        ReadGuard();
+        ~ReadGuard();
+#else
+        ReadGuard()
+        {}
+#endif
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+    };
+
+    /// @brief Iterates the nodes in a subset, visiting only nodes which are
+    /// members of it.
+    class SubsetIterator
+    {
+    private:
+        SubsetMembers *_members;
+        SubsetList::iterator _node;
+        uint32_t _subset;
+
+        /// @brief Moves to the first node in the current or a subsequent
+        /// group of members of the subset.
+        void settle()
+        {
+            for (; _members != nullptr; _members = sharedLoad(_members->next)) {
+                if ((_members->subsets & _subset) == _subset) {
+                    _node = _members->nodes.begin();
+                    if (_node != _members->nodes.end()) {
+                        return;
+                    }
+                }
+            }
+        }
+
+    public:
+        using value_type = ThingSetNode *;
+        using difference_type = ptrdiff_t;
+
+        SubsetIterator() : _members(nullptr), _subset(0)
+        {}
+        SubsetIterator(SubsetMembers *members, uint32_t subset) : _members(members), _subset(subset)
+        {
+            settle();
+        }
+
+        bool operator==(const SubsetIterator &rhs) const
+        {
+            return _members == rhs._members && (_members == nullptr || _node == rhs._node);
+        }
+
+        bool operator!=(const SubsetIterator &rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+        SubsetIterator &operator++()
+        {
+            if (++_node == _members->nodes.end()) {
+                _members = sharedLoad(_members->next);
+                settle();
+            }
+            return *this;
+        }
+
+        SubsetIterator operator++(int)
+        {
+            SubsetIterator previous = *this;
+            ++(*this);
+            return previous;
+        }
+
+        ThingSetNode *operator*() const
+        {
+            return *_node;
+        }
+    };
+
+    /// @brief The nodes in a subset.
+    class SubsetRange
+    {
+    private:
+        SubsetMembers *_members;
+        uint32_t _subset;
+
+    public:
+        SubsetRange(SubsetMembers *members, uint32_t subset) : _members(members), _subset(subset)
+        {}
+
+        SubsetIterator begin() const
+        {
+            return SubsetIterator(_members, _subset);
+        }
+
+        SubsetIterator end() const
+        {
+            return SubsetIterator();
+        }
+    };
+
     ThingSetRegistry(ThingSetRegistry const &) = delete;
     void operator=(ThingSetRegistry const &) = delete;
 
     static ThingSetNode *getMetadataNode();
 
-    static bool findByName(const std::string &name, ThingSetNode **node);
+    /// @brief Calculates the key under which a node is indexed.
+    /// @param id The ID of the node.
+    static constexpr uint32_t nodeKey(const uint16_t id)
+    {
+        return id;
+    }
+
+    /// @brief Calculates the key under which a record member is indexed. Record
+    /// members are scoped by their parent record, and parent IDs of records are
+    /// never zero, so these keys cannot collide with those of ordinary nodes.
+    /// @param id The ID of the record member.
+    /// @param parentId The ID of the parent record.
+    static constexpr uint32_t nodeKey(const uint16_t id, const uint16_t parentId)
+    {
+        return ((uint32_t)parentId << 16) | id;
+    }
+
+    static bool findByName(std::string_view name, ThingSetNode **node);
     /// @brief Find a node by its fully-qualified name.
     /// @param name The full string path of the node that is sought.
     /// @param node When the method returns, contains a pointer to the node if it was found.
     /// @param index When the method returns, contains the array index if relevant.
     /// @return True if the node was found, otherwise false.
-    static bool findByName(const std::string &name, ThingSetNode **node, size_t *index);
+    static bool findByName(std::string_view name, ThingSetNode **node, size_t *index);
+    /// @brief Find an immediate child of a node by name.
+    /// @param parent The parent of the node that is sought.
+    /// @param name The name of the node that is sought.
+    /// @param node When the method returns, contains a pointer to the node if it was found.
+    /// @return True if the node was found, otherwise false.
+    static bool findChildByName(const ThingSetParentNode *parent, std::string_view name, ThingSetNode **node);
     /// @brief Find a node by its integer ID.
     /// @param id The integer ID of the node that is sought.
     /// @param node When the method returns, contains a pointer to the node if it was found.
@@ -98,20 +299,53 @@ public:
     static bool findById(const unsigned id, const unsigned parentId, ThingSetNode **node);
     static bool findParentById(const unsigned id, ThingSetParentNode **parent);
 
-    FlatteningIterator<NodeMap::iterator> begin();
-    FlatteningIterator<NodeMap::iterator> end();
-    FlatteningIterator<NodeMap::const_iterator, std::iterator_traits<NodeMap::const_iterator>::value_type::const_iterator> cbegin() const;
-    FlatteningIterator<NodeMap::const_iterator, std::iterator_traits<NodeMap::const_iterator>::value_type::const_iterator> cend() const;
-    FlatteningIterator<NodeMap::const_iterator, std::iterator_traits<NodeMap::const_iterator>::value_type::const_iterator> begin() const;
-    FlatteningIterator<NodeMap::const_iterator, std::iterator_traits<NodeMap::const_iterator>::value_type::const_iterator> end() const;
+    NodeList::iterator begin();
+    NodeList::iterator end();
+    NodeList::const_iterator cbegin() const;
+    NodeList::const_iterator cend() const;
+    NodeList::const_iterator begin() const;
+    NodeList::const_iterator end() const;
+
+    /// @brief Get the nodes in a subset. Only members of the subset are
+    /// visited, so this does not depend on the total number of nodes.
+    /// Nodes are visited grouped by their subsets, and otherwise in
+    /// order of registration.
+    /// @param subset The subset, which should have at least one bit set.
+    /// @return The nodes whose subsets include every bit of the subset.
+    template <typename SubsetType> requires std::is_enum_v<SubsetType>
+    static SubsetRange nodesInSubset(SubsetType subset)
+    {
+        return nodesInSubset((uint32_t)subset);
+    }
+
+    static SubsetRange nodesInSubset(uint32_t subset)
+    {
+        return SubsetRange(sharedLoad(instance()._subsetMembers), subset);
+    }
 
+    /// @brief Count the nodes in a subset. This is constant-time for
+    /// subsets with a single bit set.
+    /// @param subset The subset.
+    /// @return The number of nodes whose subsets include every bit of the subset.
     template <typename SubsetType> requires std::is_enum_v<SubsetType>
-    static auto nodesInSubset(SubsetType subset)
+    static size_t countInSubset(SubsetType subset)
     {
         uint32_t s = (uint32_t)subset;
-        return instance() | std::views::filter([s](auto n) { return (n->getSubsets() & s) == s; });
+        if (std::has_single_bit(s)) {
+            return sharedLoad(instance()._subsetCounts[std::countr_zero(s)]);
+        }
+        size_t count = 0;
+        for ([[maybe_unused]] ThingSetNode *node : nodesInSubset(subset)) {
+            count++;
+        }
+        return count;
     }
 
+    /// @brief Get a number which changes whenever a node is registered or
+    /// unregistered, so that anything derived from the set of registered
+    /// nodes can tell when it is out of date.
+    static uint32_t getGeneration();
+
     static void registerNode(ThingSetNode *node);
     static void unregisterNode(ThingSetNode *node);
 
@@ -119,9 +353,22 @@ public:
 
 private:
     void registerOrUnregisterNode(ThingSetNode *node,
-                                  std::function<void(NodeList &, ThingSetNode *)> nodeListAction,
-                                  std::function<bool(ThingSetParentNode *, ThingSetNode *)> parentNodeAction);
-    static bool findByIdInNodeList(NodeList list, const unsigned id, ThingSetNode **node);
+                                  FunctionRef<bool(ThingSetRegistry &, uint32_t, ThingSetNode *)> registryAction,
+                                  FunctionRef<bool(ThingSetRegistry &, ThingSetParentNode *, ThingSetNode *)> parentNodeAction);
+    bool attachChild(ThingSetParentNode *parent, ThingSetNode *child);
+    void addOrphan(ThingSetNode *node);
+    bool removeOrphan(ThingSetNode *node);
+    void adoptOrphans(ThingSetParentNode *parent);
+    bool detachChild(ThingSetParentNode *parent, ThingSetNode *child);
+    void unlinkNode(ThingSetNode *node);
+    void countSubsets(ThingSetNode *node, int delta);
+    void addSubsetMember(ThingSetNode *node);
+    void removeSubsetMember(ThingSetNode *node);
+    bool isShared() const;
+    void commit();
+    bool indexNode(uint32_t key, ThingSetNode *node, ThingSetNode **existing);
+    bool unindexNode(uint32_t key, ThingSetNode *node);
+    ThingSetNode *findInIndex(uint32_t key) const;
 };
 
 } // namespace ThingSet
\ No newline at end of file
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "thingset++/ThingSetEncoder.hpp"
+#include "thingset++/ThingSetNode.hpp"
+#include "thingset++/ThingSetReportingPolicy.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#ifndef CONFIG_THINGSET_PLUS_PLUS_REPORT_MAX_SIZE
+#define CONFIG_THINGSET_PLUS_PLUS_REPORT_MAX_SIZE 4096
+#endif
+
+namespace ThingSet {
+
+/// @brief A report which is encoded in full only once. The EUI, subset ID,
+/// map header and keys are the same every time the report is published, so
+/// updating the report re-encodes only the values, in place. If the encoded
+/// width of any value changes, or nodes in the subset are registered or
+/// unregistered, the whole report is encoded afresh.
+///
+/// The encoding is identical to that produced by ThingSetServer::publish()
+/// for the same subset or properties. A report is not thread-safe.
+///
+/// Optionally, a report may include only those values which have changed
+/// since the previous update, with a full report (a keyframe) at a fixed
+/// interval, so that subscribers which miss a report, or join late, still
+/// converge. Listeners apply such partial reports as they would any other.
+/// Properties with a reporting policy (see ThingSetReportedProperty) are
+/// always reported that way, and only as their policies allow.
+class ThingSetReport
+{
+private:
+    /// @brief The location of the encoded value of a node in the report.
+    struct Slot
+    {
+        ThingSetNode *node;
+        ThingSetEncodable *encodable;
+        /// @brief The offset of the key.
+        size_t key = 0;
+        size_t offset = 0;
+        size_t length = 0;
+        /// @brief True if the value is included in the current report.
+        bool included = false;
+        /// @brief The reporting policy of the node, if it has one.
+        ThingSetReportable *reportable = nullptr;
+        /// @brief True if the value has changed significantly since it was last reported.
+        bool pending = false;
+        double reportedValue = 0;
+        std::chrono::steady_clock::time_point reportedAt = {};
+    };
+
+    std::vector<uint8_t> _buffer;
+    std::vector<Slot> _slots;
+    size_t _length;
+    /// @brief The offset of the map header.
+    size_t _mapOffset;
+    /// @brief The values included in the last update, encoded as a report,
+    /// if that update was not a keyframe.
+    std::vector<uint8_t> _delta;
+    size_t _deltaLength;
+    bool _partial;
+    /// @brief Space in which to encode values before comparing them with
+    /// their previous encoding.
+    std::vector<uint8_t> _scratch;
+    uint16_t _keyframeInterval;
+    uint16_t _sinceKeyframe;
+    /// @brief True if any node in the report has a reporting policy.
+    bool _hasPolicies;
+    uint32_t _subset;
+    /// @brief If true, the nodes in the report are those in the subset;
+    /// otherwise, they were specified when the report was created.
+    bool _fromRegistry;
+    bool _compiled;
+    /// @brief The registry generation at which the nodes were collected.
+    uint32_t _generation;
+
+public:
+    /// @brief Create a report of every node in a subset.
+    /// @param subset The subset.
+    template <typename SubsetType> requires std::is_enum_v<SubsetType>
+    ThingSetReport(SubsetType subset) : ThingSetReport((uint32_t)subset, true)
+    {}
+
+    /// @brief Create a report of one or more properties.
+    /// @param ...properties The properties. These must outlive the report.
+    template <EncodableNode... Property>
+    ThingSetReport(Property &...properties) : ThingSetReport(0, false)
+    {
+        _slots.reserve(sizeof...(properties));
+        (_slots.push_back(Slot { std::addressof(properties), std::addressof(properties) }), ...);
+    }
+
+    ThingSetReport(const ThingSetReport &) = delete;
+    ThingSetReport &operator=(const ThingSetReport &) = delete;
+
+    /// @brief Include only changed values in all but every nth update.
+    /// @param interval The number of updates between keyframes, which
+    /// include every value; 0, the default, disables partial reports.
+    void setKeyframeInterval(uint16_t interval)
+    {
+        _keyframeInterval = interval;
+        _sinceKeyframe = 0;
+    }
+
+    /// @brief Encode the current values of the nodes in the report.
+    /// @return True if encoding succeeded, otherwise false.
+    bool update()
+    {
+        // only read the clock if it is needed
+        bool timed = _hasPolicies || !isCurrent();
+        return update(timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point());
+    }
+
+    /// @brief Encode the current values of the nodes in the report.
+    /// @param now The current time, against which reporting policies are applied.
+    /// @return True if encoding succeeded, otherwise false.
+    bool update(std::chrono::steady_clock::time_point now);
+
+    /// @brief Get the encoded report, as of the last successful update.
+    const uint8_t *data() const
+    {
+        return _partial ? _delta.data() : _buffer.data();
+    }
+
+    /// @brief Get the length of the encoded report. This is zero if the
+    /// report includes only some values and none are due.
+    size_t size() const
+    {
+        return _partial ? _deltaLength : _length;
+    }
+
+private:
+    ThingSetReport(uint32_t subset, bool fromRegistry);
+
+    bool collect();
+    bool compile();
+    bool encode();
+    bool isCurrent() const;
+    bool isPartial() const;
+    bool patch(Slot &slot);
+    bool compare(Slot &slot, bool *changed);
+    void select(Slot &slot, bool changed, std::chrono::steady_clock::time_point now);
+    void markReported(Slot &slot, std::chrono::steady_clock::time_point now);
+    bool encodeDelta();
+};
+
+} // namespace ThingSet
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "thingset++/ThingSetReport.hpp"
+#include "thingset++/ThingSetServer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#ifdef __ZEPHYR__
+#include <zephyr/kernel.h>
+#else
+#ifndef __linux__
+#include <condition_variable>
+#endif
+#include <mutex>
+#include <thread>
+#endif
+
+namespace ThingSet {
+
+/// @brief Timing statistics for one scheduled report.
+struct ThingSetReportStatistics
+{
+    /// @brief The number of times the report has been published.
+    uint32_t count;
+    /// @brief The number of times publishing the report failed.
+    uint32_t failed;
+    /// @brief The number of deadlines skipped because the scheduler fell
+    /// more than a whole period behind.
+    uint32_t missed;
+    /// @brief The smallest delay between a deadline and publishing.
+    std::chrono::microseconds minJitter;
+    /// @brief The largest delay between a deadline and publishing.
+    std::chrono::microseconds maxJitter;
+    /// @brief The sum of all delays, from which the mean is derived.
+    std::chrono::microseconds totalJitter;
+
+    /// @brief Get the mean delay between a deadline and publishing.
+    std::chrono::microseconds meanJitter() const
+    {
+        return count > 0 ? totalJitter / count : std::chrono::microseconds(0);
+    }
+};
+
+/// @brief Publishes subsets periodically, each at its own rate.
+///
+/// Each subset is compiled into a ThingSetReport. When the scheduler starts,
+/// the first deadline of each report is offset by a fraction of its period,
+/// so that reports of equal rate are spread across the period rather than
+/// sent in a burst. Whenever the scheduler wakes, every report which is due
+/// is published in the same pass, in descending order of priority. Reports
+/// are published without holding the scheduler's lock, so statistics can be
+/// read while a slow transport is sending.
+///
+/// On Linux, the scheduler waits on a timerfd in a thread of its own; on
+/// other POSIX systems, that thread waits on a condition variable until the
+/// next deadline instead. On Zephyr, it runs as delayable work on the system
+/// work queue.
+class _ThingSetReportScheduler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<ThingSetReport> report;
+        uint32_t subset;
+        Clock::duration period;
+        uint8_t priority;
+        Clock::time_point deadline;
+        ThingSetReportStatistics statistics;
+    };
+
+    /// @brief A report found to be due in a pass, and the result of publishing it.
+    struct Due
+    {
+        ThingSetReport *report;
+        Clock::time_point deadline;
+        bool published;
+        std::chrono::microseconds jitter;
+    };
+
+    /// @brief Entries, in descending order of priority.
+    std::vector<Entry> _entries;
+    /// @brief The reports due in the current pass, in order of publication.
+    std::vector<Due> _due;
+    std::atomic<bool> _running;
+#ifdef __ZEPHYR__
+    struct WorkItem
+    {
+        k_work_delayable work;
+        _ThingSetReportScheduler *instance;
+    };
+
+    WorkItem _work;
+    k_mutex _lock;
+#else
+    std::thread _thread;
+#ifdef __linux__
+    int _timerFd;
+#else
+    /// @brief Wakes the thread early when the scheduler stops.
+    std::condition_variable _wake;
+#endif
+    std::mutex _lock;
+#endif
+
+protected:
+    _ThingSetReportScheduler();
+
+public:
+    _ThingSetReportScheduler(const _ThingSetReportScheduler &) = delete;
+    _ThingSetReportScheduler &operator=(const _ThingSetReportScheduler &) = delete;
+    virtual ~_ThingSetReportScheduler();
+
+    /// @brief Publish a subset periodically. Reports may only be added
+    /// while the scheduler is stopped.
+    /// @param subset The subset to publish.
+    /// @param period The interval between reports.
+    /// @param priority Among reports which are due at the same time, those
+    /// of higher priority are published first.
+    /// @return True if the report was added.
+    template <typename SubsetType>
+        requires std::is_enum_v<SubsetType>
+    bool add(SubsetType subset, std::chrono::milliseconds period, uint8_t priority = 0)
+    {
+        if (_running || period.count() <= 0) {
+            return false;
+        }
+        return add((uint32_t)subset, std::make_unique<ThingSetReport>(subset), period, priority);
+    }
+
+    /// @brief Get the timing statistics of a scheduled subset.
+    /// @param subset The subset.
+    /// @param statistics Receives the statistics.
+    /// @return True if the subset is scheduled.
+    template <typename SubsetType>
+        requires std::is_enum_v<SubsetType>
+    bool getStatistics(SubsetType subset, ThingSetReportStatistics *statistics)
+    {
+        return getStatistics((uint32_t)subset, statistics);
+    }
+
+    /// @brief Start publishing reports in the background.
+    /// @return True if the scheduler started.
+    bool start();
+
+    /// @brief Stop publishing reports, waiting for any pass in progress to finish.
+    void stop();
+
+    /// @brief Set the first deadline of every report, staggered from now.
+    /// Called by start(); only needed when driving run() directly.
+    /// @param now The current time.
+    void schedule(Clock::time_point now);
+
+    /// @brief Publish every report which is due.
+    /// @param now The current time.
+    /// @return The time at which the next report is due.
+    Clock::time_point run(Clock::time_point now);
+
+protected:
+    virtual bool publish(ThingSetReport &report) = 0;
+
+private:
+    bool add(uint32_t subset, std::unique_ptr<ThingSetReport> report, std::chrono::milliseconds period,
+             uint8_t priority);
+    bool getStatistics(uint32_t subset, ThingSetReportStatistics *statistics);
+    void lock();
+    void unlock();
+#ifdef __ZEPHYR__
+    static void runWork(k_work *work);
+#else
+    void runTimer();
+#endif
+};
+
+/// @brief Publishes subsets periodically through a server.
+/// @tparam Identifier Type of client identifier
+/// @tparam Size Size of broadcast message frames
+/// @tparam Encoder Type of streaming encoder
+template <typename Identifier, size_t Size, StreamingBinaryEncoder<Size> Encoder>
+class ThingSetReportScheduler : public _ThingSetReportScheduler
+{
+private:
+    ThingSetServer<Identifier, Size, Encoder> &_server;
+
+public:
+    ThingSetReportScheduler(ThingSetServer<Identifier, Size, Encoder> &server) : _server(server)
+    {}
+
+    ~ThingSetReportScheduler()
+    {
+        // once this destructor returns, the background pass can no longer
+        // call publish(), so stop it here rather than in the base class
+        stop();
+    }
+
+protected:
+    bool publish(ThingSetReport &report) override
+    {
+        return _server.publish(report);
+    }
+};
+
+} // namespace ThingSet
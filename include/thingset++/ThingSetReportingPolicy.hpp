@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "thingset++/ThingSetNode.hpp"
+#include <chrono>
+#include <type_traits>
+#include <utility>
+
+namespace ThingSet {
+
+/// @brief Determines when the value of a property is included in a report.
+/// A value is reported once it has changed by more than either deadband,
+/// but no sooner than the minimum interval after it was last reported, and
+/// in any case no later than the maximum interval after it was last reported.
+struct ThingSetReportingPolicy
+{
+    /// @brief The smallest absolute change in value which is reported.
+    double deadband = 0;
+    /// @brief The smallest change in value, relative to the value last
+    /// reported, which is reported; for example, 0.01 for 1%.
+    double relativeDeadband = 0;
+    /// @brief The shortest time between successive reports of the value.
+    std::chrono::milliseconds minInterval { 0 };
+    /// @brief The longest time between successive reports of the value,
+    /// whether or not it has changed; zero for no limit.
+    std::chrono::milliseconds maxInterval { 0 };
+};
+
+/// @brief Interface for nodes which have a reporting policy.
+class ThingSetReportable
+{
+public:
+    virtual const ThingSetReportingPolicy &getReportingPolicy() const = 0;
+
+    /// @brief Get the value to which deadbands apply.
+    /// @param value When the method returns, contains the value, if it is numeric.
+    /// @return True if the value is numeric, otherwise false, in which case
+    /// any change in value is significant.
+    virtual bool getReportingValue(double *value) const = 0;
+};
+
+/// @brief A property with a reporting policy, which compiled reports apply
+/// when it is included in them.
+/// @tparam Property The type of the property.
+template <typename Property>
+class ThingSetReportedProperty : public Property, public ThingSetReportable
+{
+private:
+    const ThingSetReportingPolicy _policy;
+
+public:
+    /// @brief Create a property with a reporting policy.
+    /// @param policy The reporting policy.
+    /// @param ...args Arguments to the constructor of the property.
+    template <typename... Args>
+    ThingSetReportedProperty(const ThingSetReportingPolicy &policy, Args &&...args)
+        : Property(std::forward<Args>(args)...), _policy(policy)
+    {}
+
+    using Property::operator=;
+
+    const ThingSetReportingPolicy &getReportingPolicy() const override
+    {
+        return _policy;
+    }
+
+    bool getReportingValue(double *value) const override
+    {
+        using T = std::remove_cvref_t<decltype(this->getValue())>;
+        if constexpr (std::is_arithmetic_v<T>) {
+            *value = (double)this->getValue();
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    bool tryCastTo(ThingSetNodeType type, void **target) override
+    {
+        if (type == ThingSetNodeType::reportable) {
+            *target = static_cast<ThingSetReportable *>(this);
+            return true;
+        }
+        return Property::tryCastTo(type, target);
+    }
+};
+
+} // namespace ThingSet
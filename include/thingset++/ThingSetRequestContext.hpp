@@ -6,13 +6,15 @@
 
 #pragma once
 
+#include "thingset++/ChunkedThingSetBinaryEncoder.hpp"
 #include "thingset++/ThingSetBinaryEncoder.hpp"
 #include "thingset++/ThingSetBinaryDecoder.hpp"
-#include "thingset++/ThingSetTextEncoder.hpp"
+#include "thingset++/StreamingThingSetTextEncoder.hpp"
 #include "thingset++/ThingSetTextDecoder.hpp"
 #include "thingset++/ThingSetNode.hpp"
 #include "thingset++/ThingSetStatus.hpp"
 #include <optional>
+#include <string_view>
 
 namespace ThingSet {
 
@@ -23,8 +25,9 @@ protected:
     /// @brief Pointer to the buffer into which the response will be written.
     uint8_t *_response;
     std::optional<uint16_t> _id;
-    /// @brief The path to the node to which this request relates.
-    std::optional<std::string> _path;
+    /// @brief The path to the node to which this request relates. Points
+    /// into the request buffer, so is only valid while the request is.
+    std::optional<std::string_view> _path;
 
     ThingSetRequestContext(uint8_t *response);
 
@@ -43,7 +46,7 @@ public:
     /// @brief If true, keys in responses will be encoded as integer IDs; if false, as strings.
     bool useIds();
 
-    std::string &path();
+    std::string_view path();
     uint16_t &id();
 
     virtual ThingSetEncoder &encoder() = 0;
@@ -61,9 +64,20 @@ public:
 
     constexpr virtual size_t getHeaderLength() const = 0;
 
+    /// @brief Moves the part of a response which has yet to be written out to
+    /// the start of the response buffer.
+    /// @param responseLength The length of the whole response.
+    /// @return The length of the part, or -1 if the request failed after part
+    /// of the response had been written out, which leaves it incomplete.
+    int finishResponse(int responseLength);
+
 protected:
     bool tryGetNodeId(std::string &nodeId);
 
+    /// @brief Gets the number of bytes of the response, including the header,
+    /// which have been written out before the response was complete.
+    virtual size_t getWrittenLength() const;
+
     virtual bool isForward() = 0;
 };
 
@@ -107,19 +121,17 @@ protected:
     }
 };
 
-class ThingSetBinaryRequestContext : public _ThingSetRequestContext<ThingSetBinaryRequestType>
+/// @brief Decodes a binary request and writes the status of its response,
+/// leaving the encoding of the rest of the response to derived classes.
+class _ThingSetBinaryRequestContext : public _ThingSetRequestContext<ThingSetBinaryRequestType>
 {
 private:
-    DefaultFixedDepthThingSetBinaryEncoder _encoder;
     DefaultFixedDepthThingSetBinaryDecoder _decoder;
 
-public:
-    ThingSetBinaryRequestContext(uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize);
-
-    inline ThingSetEncoder &encoder() override {
-        return _encoder;
-    }
+protected:
+    _ThingSetBinaryRequestContext(uint8_t *request, size_t requestLen, uint8_t *response);
 
+public:
     inline ThingSetDecoder &decoder() override {
         return _decoder;
     }
@@ -134,17 +146,57 @@ public:
     }
 };
 
+class ThingSetBinaryRequestContext : public _ThingSetBinaryRequestContext
+{
+private:
+    DefaultFixedDepthThingSetBinaryEncoder _encoder;
+
+public:
+    ThingSetBinaryRequestContext(uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize);
+
+    inline ThingSetEncoder &encoder() override {
+        return _encoder;
+    }
+};
+
+/// @brief Context for a binary request whose response is written out in parts
+/// as it is encoded, so may be larger than the response buffer.
+class StreamingThingSetBinaryRequestContext : public _ThingSetBinaryRequestContext
+{
+private:
+    ChunkedThingSetBinaryEncoder _encoder;
+
+public:
+    /// @param writer Sends part of the response.
+    StreamingThingSetBinaryRequestContext(uint8_t *request, size_t requestLen, uint8_t *response,
+                                          size_t responseSize, FunctionRef<bool(const uint8_t *, size_t)> writer);
+
+    inline ThingSetEncoder &encoder() override {
+        return _encoder;
+    }
+
+protected:
+    size_t getWrittenLength() const override;
+};
+
 #ifdef ENABLE_TEXT_MODE
 class ThingSetTextRequestContext : public _ThingSetRequestContext<ThingSetTextRequestType>
 {
 private:
-    ThingSetTextEncoder _encoder;
-    DefaultFixedSizeThingSetTextDecoder _decoder;
+    StreamingThingSetTextEncoder _encoder;
+    DefaultThingSetTextDecoder _decoder;
 
 public:
     ThingSetTextRequestContext(uint8_t *request, size_t requestLen,
                                uint8_t *response, size_t responseSize,
                                TextEncoderOptions opts = TextEncoderOptions::none);
+    /// @brief Creates a context whose response is written out in parts whenever
+    /// the response buffer fills, so may be larger than the buffer.
+    /// @param writer Sends part of the response.
+    ThingSetTextRequestContext(uint8_t *request, size_t requestLen,
+                               uint8_t *response, size_t responseSize,
+                               FunctionRef<bool(const uint8_t *, size_t)> writer,
+                               TextEncoderOptions opts = TextEncoderOptions::none);
 
     inline ThingSetEncoder &encoder() override {
         return _encoder;
@@ -162,6 +214,9 @@ public:
     {
         return 4;
     }
+
+protected:
+    size_t getWrittenLength() const override;
 };
 #endif // ENABLE_TEXT_MODE
 
@@ -9,6 +9,7 @@
 #include "thingset++/StringLiteral.hpp"
 #include "thingset++/ThingSetProperty.hpp"
 #include "thingset++/ThingSetRegistry.hpp"
+#include "thingset++/ThingSetReport.hpp"
 #include "thingset++/ThingSetRequestContext.hpp"
 #include "thingset++/ThingSetServerTransport.hpp"
 #include "thingset++/ThingSetStatus.hpp"
@@ -16,10 +17,6 @@
 
 namespace ThingSet {
 
-/// Specifies a type which is probably a ThingSet property.
-template <typename T>
-concept EncodableNode = std::is_base_of_v<ThingSetNode, T> && std::is_base_of_v<ThingSetEncodable, T>;
-
 class ThingSetForwarder
 {
 public:
@@ -56,20 +53,32 @@ private:
 
 protected:
     int handleBinaryRequest(uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize);
+    /// @brief Handles a binary request, writing the response out in parts if it
+    /// does not fit in the response buffer.
+    /// @return The length of the rest of the response, which remains in the
+    /// buffer, or -1 if the response could not be completed.
+    int handleBinaryRequest(uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize,
+                            ThingSetResponseWriter writer);
 #ifdef ENABLE_TEXT_MODE
     int handleTextRequest(uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize);
+    /// @brief Handles a text request, writing the response out in parts if it
+    /// does not fit in the response buffer.
+    /// @return The length of the rest of the response, which remains in the
+    /// buffer, or -1 if the response could not be completed.
+    int handleTextRequest(uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize,
+                          ThingSetResponseWriter writer);
 #endif // ENABLE_TEXT_MODE
 
-    template <typename T, ThingSetAccess Access, typename SubsetType, SubsetType Subset,
+    template <typename Encoder, typename T, ThingSetAccess Access, typename SubsetType, SubsetType Subset,
               EncodableNode... Property>
-    bool encode(ThingSetEncoder &encoder, ThingSetProperty<T, Access, SubsetType, Subset> &property,
+    bool encode(Encoder &encoder, ThingSetProperty<T, Access, SubsetType, Subset> &property,
                 Property &...properties)
     {
         return encode(encoder, property) && encode(encoder, properties...);
     }
 
-    template <typename T, ThingSetAccess Access, typename SubsetType, SubsetType Subset>
-    bool encode(ThingSetEncoder &encoder, ThingSetProperty<T, Access, SubsetType, Subset> &property)
+    template <typename Encoder, typename T, ThingSetAccess Access, typename SubsetType, SubsetType Subset>
+    bool encode(Encoder &encoder, ThingSetProperty<T, Access, SubsetType, Subset> &property)
     {
         return encoder.encode(property.getId()) && encoder.encode(property.getValue());
     }
@@ -95,9 +104,13 @@ public:
 
     bool listen() override
     {
-        return _transport.listen([this](auto sender, auto req, auto reql, auto res, auto resl) {
-            return requestCallback(sender, req, reql, res, resl);
-        });
+        return _transport.listen(
+            [this](auto sender, auto req, auto reql, auto res, auto resl) {
+                return requestCallback(sender, req, reql, res, resl);
+            },
+            [this](auto sender, auto req, auto reql, auto res, auto resl, auto writer) {
+                return requestCallback(sender, req, reql, res, resl, writer);
+            });
     }
 
     /// @brief Broadcasts one or more properties as a report.
@@ -112,19 +125,22 @@ public:
         bool enhanced = false;
 #endif
         Encoder encoder = _transport.getPublishingEncoder(enhanced);
+        // the types of the properties are known here, so encode them without
+        // going through the virtual encoder interface
+        auto inlined = encoder.inlined();
 
         if (enhanced) {
-            if (!encoder.encode(ThingSet::Eui::getValue())) {
+            if (!inlined.encode(ThingSet::Eui::getValue())) {
                 return false;
             }
         }
 
-        if (!encoder.encode(0)) { // fake subset ID
+        if (!inlined.encode(0)) { // fake subset ID
             return false;
         }
 
-        if (!encoder.encodeMapStart(sizeof...(properties)) || !encode(encoder, properties...)
-            || !encoder.encodeMapEnd())
+        if (!inlined.encodeMapStart(sizeof...(properties)) || !encode(inlined, properties...)
+            || !inlined.encodeMapEnd())
         {
             return false;
         }
@@ -157,12 +173,8 @@ public:
             return false;
         }
 
-        size_t count = 0;
-        for (auto *n : ThingSetRegistry::nodesInSubset(subset)) {
-            (void)n;
-            ++count;
-        }
-
+        ThingSetRegistry::ReadGuard guard;
+        size_t count = ThingSetRegistry::countInSubset(subset);
         if (!encoder.encodeMapStart(count)) {
             return false;
         }
@@ -185,6 +197,28 @@ public:
         return encoder.flush();
     }
 
+    /// @brief Broadcasts a compiled report, re-encoding only those parts of it
+    /// which have changed since it was last published.
+    /// @param report The report to publish.
+    /// @return True if publishing succeeded.
+    bool publish(ThingSetReport &report)
+    {
+#ifdef ENABLE_ENHANCED_REPORTING
+        bool enhanced = true;
+#else
+        bool enhanced = false;
+#endif
+        if (!report.update()) {
+            return false;
+        }
+        if (report.size() == 0) {
+            // nothing has changed since the last report
+            return true;
+        }
+        Encoder encoder = _transport.getPublishingEncoder(enhanced);
+        return encoder.encodeEncoded(report.data(), report.size()) && encoder.flush();
+    }
+
 private:
     int requestCallback(Identifier &, uint8_t *request, size_t requestLen, uint8_t *response, size_t responseLen)
     {
@@ -205,6 +239,22 @@ private:
             return 1;
         }
     }
+
+    int requestCallback(Identifier &sender, uint8_t *request, size_t requestLen, uint8_t *response, size_t responseLen,
+                        ThingSetResponseWriter writer)
+    {
+        if (request[0] >= ThingSetBinaryRequestType::get && request[0] <= ThingSetBinaryRequestType::update)
+        {
+            return handleBinaryRequest(request, requestLen, response, responseLen, writer);
+        }
+#ifdef ENABLE_TEXT_MODE
+        else if (request[0] >= (uint8_t)ThingSetTextRequestType::exec && request[0] <= (uint8_t)ThingSetTextRequestType::desire)
+        {
+            return handleTextRequest(request, requestLen, response, responseLen, writer);
+        }
+#endif // ENABLE_TEXT_MODE
+        return requestCallback(sender, request, requestLen, response, responseLen);
+    }
 };
 
 class ThingSetServerBuilder
@@ -7,11 +7,18 @@
 
 #include <cstdint>
 #include <cstdio>
-#include <functional>
 #include "thingset++/StreamingThingSetBinaryEncoder.hpp"
+#include "thingset++/internal/Delegate.hpp"
+#include "thingset++/internal/FunctionRef.hpp"
 
 namespace ThingSet {
 
+/// @brief Sends part of a response to the client which made the request, before
+/// the rest of the response has been encoded. It is called while the registry
+/// is being read, so that unregistering nodes waits for it, and should give up
+/// and return false rather than wait indefinitely for a slow client.
+using ThingSetResponseWriter = FunctionRef<bool(const uint8_t *, size_t)>;
+
 /// @brief Interface for transports for ThingSet servers.
 /// @tparam Identifier Type of client identifier
 /// @tparam Size Size of broadcast message frames
@@ -24,7 +31,24 @@ public:
     /// is received.
     /// @param callback The callback to be invoked when a request is received.
     /// @return True.
-    virtual bool listen(std::function<int(const Identifier &, uint8_t *, size_t, uint8_t *, size_t)> callback) = 0;
+    virtual bool listen(Delegate<int(const Identifier &, uint8_t *, size_t, uint8_t *, size_t)> callback) = 0;
+
+    /// @brief Listening method for transports which can send a response in parts
+    /// as it is encoded, so that it is not limited by the size of the response
+    /// buffer. Transports which cannot need not override this.
+    /// @param callback The callback to be invoked when a request is received.
+    /// @param streamingCallback The callback to be invoked instead, if the transport
+    /// can send responses in parts. It is passed a writer which sends part of the
+    /// response, and returns the length of the rest of the response, which is left
+    /// in the buffer, or a negative value if the response could not be completed
+    /// after part of it was sent.
+    /// @return True.
+    virtual bool listen(Delegate<int(const Identifier &, uint8_t *, size_t, uint8_t *, size_t)> callback,
+                        [[maybe_unused]] Delegate<int(const Identifier &, uint8_t *, size_t, uint8_t *, size_t,
+                                                      ThingSetResponseWriter)> streamingCallback)
+    {
+        return listen(callback);
+    }
 
     virtual Encoder getPublishingEncoder(bool enhanced) = 0;
 };
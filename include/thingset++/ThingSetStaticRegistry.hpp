@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace ThingSet {
+
+class ThingSetNode;
+
+/// @brief Read-only view of a perfect hash over the keys of statically
+/// declared nodes. The key and displacement tables live in read-only
+/// memory; only the node pointers themselves are filled in at runtime,
+/// as each node is constructed.
+struct ThingSetStaticIndex
+{
+    /// @brief Marks free slots in the key table. This is the key of a record
+    /// member with ID 0xFFFF in a record with ID 0xFFFF, so such a member
+    /// cannot be statically registered.
+    static constexpr uint32_t emptyKey = UINT32_MAX;
+
+    const uint16_t *displacements;
+    uint32_t bucketMask;
+    const uint32_t *keys;
+    ThingSetNode **nodes;
+    uint32_t slotMask;
+
+    static constexpr uint32_t hash(uint32_t key, uint32_t seed)
+    {
+        uint32_t h = key ^ (seed * 0x9E3779B9u);
+        h ^= h >> 16;
+        h *= 0x7FEB352Du;
+        h ^= h >> 15;
+        h *= 0x846CA68Bu;
+        h ^= h >> 16;
+        return h;
+    }
+
+    /// @brief Find the slot that holds the node with the given key.
+    /// @param key The key of the node sought.
+    /// @return A pointer to the slot, or nullptr if the key is not part of the index.
+    ThingSetNode **slot(uint32_t key) const
+    {
+        if (key == emptyKey) {
+            // would otherwise match any free slot
+            return nullptr;
+        }
+        uint32_t s = hash(key, displacements[hash(key, 0) & bucketMask]) & slotMask;
+        return keys[s] == key ? &nodes[s] : nullptr;
+    }
+};
+
+/// @brief Builds a perfect hash over a set of keys at compile time, using
+/// hash-and-displace: keys are grouped into buckets by a first hash, then
+/// each bucket, largest first, is assigned a seed for a second hash that
+/// places all of its keys in free slots.
+/// @tparam N The number of keys.
+template <size_t N>
+struct ThingSetPerfectHash
+{
+    static constexpr size_t slotCount = std::bit_ceil(N + N / 4 + 1);
+    static constexpr size_t bucketCount = std::bit_ceil(N / 4 + 1);
+
+    std::array<uint16_t, bucketCount> displacements;
+    std::array<uint32_t, slotCount> keys;
+    /// @brief False if the keys contained duplicates or the empty key, or no
+    /// perfect hash could be found.
+    bool valid;
+
+    constexpr ThingSetPerfectHash(const std::array<uint32_t, N> &input) : displacements(), keys(), valid(true)
+    {
+        keys.fill(ThingSetStaticIndex::emptyKey);
+
+        std::array<size_t, bucketCount + 1> bucketStart{};
+        for (size_t i = 0; i < N; i++) {
+            if (input[i] == ThingSetStaticIndex::emptyKey) {
+                valid = false;
+                return;
+            }
+            for (size_t j = 0; j < i; j++) {
+                if (input[i] == input[j]) {
+                    valid = false;
+                    return;
+                }
+            }
+            bucketStart[(ThingSetStaticIndex::hash(input[i], 0) & (bucketCount - 1)) + 1]++;
+        }
+
+        // group the keys by bucket
+        std::array<size_t, bucketCount> order{};
+        for (size_t b = 0; b < bucketCount; b++) {
+            order[b] = b;
+            bucketStart[b + 1] += bucketStart[b];
+        }
+        std::array<uint32_t, N> members{};
+        std::array<size_t, bucketCount> filled{};
+        for (size_t i = 0; i < N; i++) {
+            size_t b = ThingSetStaticIndex::hash(input[i], 0) & (bucketCount - 1);
+            members[bucketStart[b] + filled[b]++] = input[i];
+        }
+
+        // place the largest buckets first, while there are still plenty of free slots
+        for (size_t i = 1; i < bucketCount; i++) {
+            for (size_t j = i; j > 0 && filled[order[j - 1]] < filled[order[j]]; j--) {
+                std::swap(order[j - 1], order[j]);
+            }
+        }
+
+        std::array<uint32_t, N> placed{};
+        for (size_t b : order) {
+            const size_t first = bucketStart[b];
+            const size_t count = filled[b];
+            if (count == 0) {
+                break;
+            }
+            bool found = false;
+            for (uint32_t seed = 1; seed <= UINT16_MAX && !found; seed++) {
+                found = true;
+                for (size_t i = 0; i < count && found; i++) {
+                    uint32_t s = ThingSetStaticIndex::hash(members[first + i], seed) & (slotCount - 1);
+                    found = keys[s] == ThingSetStaticIndex::emptyKey;
+                    for (size_t k = 0; k < i && found; k++) {
+                        found = placed[k] != s;
+                    }
+                    placed[i] = s;
+                }
+                if (found) {
+                    displacements[b] = (uint16_t)seed;
+                    for (size_t i = 0; i < count; i++) {
+                        keys[placed[i]] = members[first + i];
+                    }
+                }
+            }
+            if (!found) {
+                valid = false;
+                return;
+            }
+        }
+    }
+};
+
+/// @brief Compile-time index of statically declared nodes, such as those
+/// derived from IdentifiableThingSetNode and ThingSetRecordMember.
+/// @tparam Nodes The types of the nodes; each must expose a constexpr static key.
+template <typename... Nodes>
+class ThingSetStaticRegistry
+{
+private:
+    static_assert(((Nodes::key != ThingSetStaticIndex::emptyKey) && ...),
+                  "Record member 0xFFFF of record 0xFFFF cannot be statically registered");
+    static constexpr ThingSetPerfectHash<sizeof...(Nodes)> _hash{ std::array<uint32_t, sizeof...(Nodes)>{ Nodes::key... } };
+    static_assert(_hash.valid, "Statically registered nodes must have unique IDs");
+
+    static inline ThingSetNode *_nodes[_hash.slotCount];
+
+public:
+    static constexpr ThingSetStaticIndex index()
+    {
+        return ThingSetStaticIndex{
+            _hash.displacements.data(), (uint32_t)(_hash.bucketCount - 1),
+            _hash.keys.data(),          _nodes,
+            (uint32_t)(_hash.slotCount - 1),
+        };
+    }
+};
+
+#ifdef ENABLE_STATIC_REGISTRY
+/// @brief The static index consulted by the registry. Applications which
+/// enable the static registry must define this exactly once, using
+/// THINGSET_STATIC_REGISTRY.
+extern const ThingSetStaticIndex thingSetStaticIndex;
+#endif
+
+} // namespace ThingSet
+
+/// @brief Defines the compile-time index of statically declared nodes.
+/// Nodes listed here are found with a single table probe, and are never
+/// hashed or rehashed at runtime; any other nodes use the runtime index.
+/// For example:
+///     THINGSET_STATIC_REGISTRY(decltype(group), decltype(Record::member))
+#define THINGSET_STATIC_REGISTRY(...)                                                                                 \
+    constinit const ThingSet::ThingSetStaticIndex ThingSet::thingSetStaticIndex =                                     \
+        ThingSet::ThingSetStaticRegistry<__VA_ARGS__>::index();
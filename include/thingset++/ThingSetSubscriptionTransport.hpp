@@ -6,10 +6,10 @@
 #pragma once
 
 #include <cstdint>
-#include <functional>
 #include "thingset++/Streaming.hpp"
 #include "thingset++/ThingSetBinaryDecoder.hpp"
 #include "thingset++/ThingSetStatus.hpp"
+#include "thingset++/internal/Delegate.hpp"
 
 namespace ThingSet {
 
@@ -23,7 +23,7 @@ public:
     /// broadcast mechanism.
     /// @param callback A callback that is invoked when a published message
     /// is received.
-    virtual bool subscribe(std::function<void(const Identifier &, ThingSetBinaryDecoder &)> callback) = 0;
+    virtual bool subscribe(Delegate<void(const Identifier &, ThingSetBinaryDecoder &)> callback) = 0;
 };
 
 /// @brief Interface for client subscription transports receiving multi-frame reports.
@@ -39,7 +39,7 @@ protected:
     {
     public:
         template <typename Decoder, typename Message, typename Key = Identifier, StreamingMessageType MessageType = Decoder::message_type>
-        static bool handle(Message &frame, const Identifier &identifier, const Key &key, std::map<Key, Decoder> &decodersBySender, std::function<void(const Identifier &, ThingSetBinaryDecoder &)>& callback)
+        static bool handle(Message &frame, const Identifier &identifier, const Key &key, std::map<Key, Decoder> &decodersBySender, Delegate<void(const Identifier &, ThingSetBinaryDecoder &)>& callback)
         {
             Decoder *decoder = nullptr;
             MessageType messageType = getMessageType(frame);
@@ -7,16 +7,20 @@
 
 #include "thingset++/ThingSetDecoder.hpp"
 #include "internal/bind_to_tuple.hpp"
-#define JSMN_HEADER
-#include "internal/jsmn.h"
+#include "internal/JsonTokenizer.hpp"
 #include "zcbor_decode.h"
 #include <array>
 #include <map>
 #include <optional>
 #include <tuple>
+#include <vector>
+
+#ifndef CONFIG_THINGSET_PLUS_PLUS_TEXT_DECODER_MAX_TOKENS
+#define CONFIG_THINGSET_PLUS_PLUS_TEXT_DECODER_MAX_TOKENS 64
+#endif
 
 #define TEXT_ENCODER_BUFFER_SIZE 1024
-#define TEXT_DECODER_DEFAULT_MAX_TOKENS 64
+#define TEXT_DECODER_DEFAULT_MAX_TOKENS CONFIG_THINGSET_PLUS_PLUS_TEXT_DECODER_MAX_TOKENS
 
 namespace ThingSet {
 
@@ -28,7 +32,8 @@ protected:
     size_t _bufferSize;
     size_t _bufferElemPtr;
     size_t _tokenIndex;
-    jsmn_parser _parser;
+    JsonTokenizer _tokenizer;
+    jsmntok _endToken;
 
     ThingSetTextDecoder(const char *buffer, const size_t size);
 
@@ -42,6 +47,7 @@ protected:
 public:
     using ThingSetDecoder::decode;
     bool decode(std::string *value) override;
+    bool decode(std::string_view *value) override;
     bool decode(char *value, size_t size) override;
     bool decode(float *value) override;
     bool decode(double *value) override;
@@ -70,6 +76,8 @@ protected:
     bool ensureListSize(const size_t size, size_t &elementCount) override;
 
 private:
+    /// @brief Gets the current token, or an undefined one if all have been decoded.
+    jsmntok *getToken();
     bool expectType(const jsmntype_t &type, jsmntok **token);
     bool isLiteral(const char* literal);
 
@@ -97,8 +105,8 @@ private:
 protected:
     jsmntok *getTokens() override
     {
-        if (_parser.toknext == 0) {
-            jsmn_parse(&_parser, _inputBuffer, _bufferSize, _tokens.data(), tokens);
+        if (_tokenizer.getTokenCount() == 0) {
+            _tokenizer.parse(_inputBuffer, _bufferSize, _tokens.data(), tokens);
         }
         return _tokens.data();
     }
@@ -115,4 +123,41 @@ public:
 
 using DefaultFixedSizeThingSetTextDecoder = FixedSizeThingSetTextDecoder<TEXT_DECODER_DEFAULT_MAX_TOKENS>;
 
+/// @brief Text protocol decoder whose tokens are allocated on the heap, and
+/// grow with the input, so that there is no limit on the size of a request.
+class GrowableThingSetTextDecoder : public virtual ThingSetTextDecoder
+{
+private:
+    std::vector<jsmntok> _tokens;
+
+protected:
+    jsmntok *getTokens() override
+    {
+        if (_tokenizer.getTokenCount() == 0) {
+            _tokens.resize(TEXT_DECODER_DEFAULT_MAX_TOKENS);
+            while (_tokenizer.parse(_inputBuffer, _bufferSize, _tokens.data(), _tokens.size()) == JSMN_ERROR_NOMEM) {
+                // the tokenizer resumes from where it ran out
+                _tokens.resize(_tokens.size() * 2);
+            }
+        }
+        return _tokens.data();
+    }
+
+public:
+    GrowableThingSetTextDecoder(const char *buffer, const size_t size) : ThingSetTextDecoder(buffer, size)
+    {}
+
+    template <size_t Size>
+    GrowableThingSetTextDecoder(const std::array<char, Size> &buffer) : GrowableThingSetTextDecoder(buffer.data(), Size)
+    {}
+};
+
+#if defined(__ZEPHYR__) && !defined(CONFIG_THINGSET_PLUS_PLUS_TEXT_DECODER_GROWABLE)
+/// @brief The decoder for text requests; on microcontrollers, its tokens are
+/// fixed in size, unless CONFIG_THINGSET_PLUS_PLUS_TEXT_DECODER_GROWABLE is set.
+using DefaultThingSetTextDecoder = DefaultFixedSizeThingSetTextDecoder;
+#else
+using DefaultThingSetTextDecoder = GrowableThingSetTextDecoder;
+#endif
+
 } // namespace ThingSet
\ No newline at end of file
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "thingset++/ThingSetEncoder.hpp"
+#include <charconv>
 #include <cstring>
 
 #define TEXT_ENCODER_BUFFER_SIZE 1024
@@ -116,42 +117,71 @@ protected:
     bool encodeListSeparator() override;
     bool encodeKeyValuePairSeparator() override;
 
-private:
-    /// @brief Determine the length of the value as a string
-    /// @return Number of characters in the string.
-    template <typename T> inline int ensureBufferCapacity(T value, const char *format)
+    /// @brief Called when the buffer is full, to write out its start and so
+    /// make room for more. This encoder has nowhere to write to, so fails;
+    /// see @ref StreamingThingSetTextEncoder.
+    /// @param buffer The start of the buffer.
+    /// @param length The number of characters to write.
+    /// @return True if the characters were written, otherwise false.
+    virtual bool writeChunk(const char *, size_t)
     {
-        int bytesRequired = snprintf(nullptr, 0, format, value); // get size of value as a string
+        return false;
+    }
+
+private:
+    /// @brief Writes out all but the last character in the buffer, which may be
+    /// a separator that the end of a list or map will remove.
+    bool makeRoom();
 
-        if (_responseSize < _responsePosition + bytesRequired) {
+    inline bool append(const char value)
+    {
+        if (_responsePosition >= _responseSize && !makeRoom()) {
             return false;
         }
+        _responseBuffer[_responsePosition++] = value;
         return true;
     }
 
-    inline bool append(const char value)
+    inline bool append(const char *value, size_t length)
     {
-        if (_responsePosition >= _responseSize) {
-            return false;
+        while (_responseSize - _responsePosition < length) {
+            // copy as much as fits, then make room for the rest
+            size_t available = _responseSize - _responsePosition;
+            memcpy(_responseBuffer + _responsePosition, value, available);
+            _responsePosition += available;
+            value += available;
+            length -= available;
+            if (!makeRoom()) {
+                return false;
+            }
         }
-        _responseBuffer[_responsePosition++] = value;
+        memcpy(_responseBuffer + _responsePosition, value, length);
+        _responsePosition += length;
         return true;
     }
 
-    /// @brief Add a value to the response buffer as a string
+    /// @brief Add a number to the response buffer as a string, formatted in a
+    /// single pass by std::to_chars, which fails if it does not fit.
     /// @return True if successful, false otherwise
-    template <typename T> bool appendFormat(const T &value, const char *format)
+    template <typename T, typename... Args> bool appendNumber(const T &value, Args... args)
     {
-        if (!ensureBufferCapacity(value, format)) {
-            return false;
+        char *end = _responseBuffer + _responseSize;
+        std::to_chars_result result = std::to_chars(_responseBuffer + _responsePosition, end, value, args...);
+        if (result.ec != std::errc()) {
+            // try once more with the buffer written out
+            if (!makeRoom()) {
+                return false;
+            }
+            result = std::to_chars(_responseBuffer + _responsePosition, end, value, args...);
+            if (result.ec != std::errc()) {
+                return false;
+            }
         }
-
-        int bytesWritten =
-            snprintf(_responseBuffer + getEncodedLength(), _responseSize - getEncodedLength(), format, value);
-        _responsePosition += bytesWritten;
-
+        _responsePosition = result.ptr - _responseBuffer;
         return true;
     }
+
+    template <typename T> bool appendFloat(const T &value);
 };
 
 }; // namespace ThingSet
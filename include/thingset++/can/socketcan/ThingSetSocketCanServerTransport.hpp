@@ -20,7 +20,7 @@ private:
 public:
     ThingSetSocketCanServerTransport(ThingSetSocketCanInterface &canInterface);
 
-    bool listen(std::function<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback) override;
+    bool listen(Delegate<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback) override;
 
 protected:
     ThingSetCanInterface &getInterface() override;
@@ -5,8 +5,8 @@
  */
 #pragma once
 
-#include <functional>
 #include <thingset++/can/CanID.hpp>
+#include <thingset++/internal/Delegate.hpp>
 #include <zephyr/kernel.h>
 extern "C" {
 #include <canbus/isotp_fast.h>
@@ -27,7 +27,7 @@ private:
     size_t _rxBufferSize;
     uint8_t *_txBuffer;
     size_t _txBufferSize;
-    std::function<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> _inboundRequestCallback;
+    Delegate<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> _inboundRequestCallback;
 
 public:
     template<size_t RxSize, size_t TxSize>
@@ -42,8 +42,8 @@ public:
 
     ThingSetZephyrCanInterface &getInterface();
 
-    bool bind(std::function<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback);
-    bool bind(uint8_t otherNodeAddress, std::function<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback);
+    bool bind(Delegate<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback);
+    bool bind(uint8_t otherNodeAddress, Delegate<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback);
 
     bool send(const uint8_t otherNodeAddress, uint8_t *buffer, size_t len);
 
@@ -27,7 +27,7 @@ public:
     {}
     ~ThingSetZephyrCanServerTransport();
 
-    bool listen(std::function<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback) override;
+    bool listen(Delegate<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback) override;
 
 protected:
     ThingSetCanInterface &getInterface() override;
@@ -10,7 +10,6 @@
 #include "thingset++/can/zephyr/CanFrame.hpp"
 #include "thingset++/zephyr/MessageQueue.hpp"
 #include "thingset++/internal/logging.hpp"
-#include <functional>
 
 namespace ThingSet::Can::Zephyr {
 
@@ -28,7 +27,7 @@ protected:
 
     protected:
         ThingSet::Zephyr::MessageQueue<can_frame, CONFIG_THINGSET_PLUS_PLUS_CAN_SUBSCRIPTION_QUEUE_DEPTH> _frameQueue;
-        std::function<void(const CanID &, ThingSetBinaryDecoder &)> _callback;
+        Delegate<void(const CanID &, ThingSetBinaryDecoder &)> _callback;
         K_KERNEL_STACK_MEMBER(_threadStack, CONFIG_THINGSET_PLUS_PLUS_CAN_SUBSCRIPTION_THREAD_STACK_SIZE);
 
     public:
@@ -42,7 +41,7 @@ protected:
             }
         }
 
-        bool run(std::function<void(const CanID &, ThingSetBinaryDecoder &)> callback)
+        bool run(Delegate<void(const CanID &, ThingSetBinaryDecoder &)> callback)
         {
             const CanID &canId = getCanIdForFilter();
             const can_filter canFilter = {
@@ -114,7 +113,7 @@ private:
 public:
     ThingSetZephyrCanSubscriptionTransport(ThingSetZephyrCanInterface &canInterface);
 
-    bool subscribe(std::function<void(const CanID &, ThingSetBinaryDecoder &)> callback) override;
+    bool subscribe(Delegate<void(const CanID &, ThingSetBinaryDecoder &)> callback) override;
 };
 
 class ThingSetZephyrCanControlSubscriptionTransport : public _ThingSetZephyrCanSubscriptionTransport<ThingSetCanControlSubscriptionTransport>
@@ -135,7 +134,7 @@ private:
 public:
     ThingSetZephyrCanControlSubscriptionTransport(ThingSetZephyrCanInterface &canInterface);
 
-    bool subscribe(std::function<void(const CanID &, ThingSetBinaryDecoder &)> callback) override;
+    bool subscribe(Delegate<void(const CanID &, ThingSetBinaryDecoder &)> callback) override;
 };
 
 } // namespace ThingSet::Can::Zephyr
\ No newline at end of file
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "zcbor_common.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ThingSet {
+
+/// @brief Writes the subset of CBOR used by ThingSet directly into the payload
+/// of an encoder state. The output is identical to that of zcbor built with
+/// ZCBOR_CANONICAL, but containers need no backup states; forward-only
+/// containers need no state at all.
+class CborWriter
+{
+public:
+    enum MajorType : uint8_t
+    {
+        unsignedInteger = 0,
+        negativeInteger = 1,
+        byteString = 2,
+        textString = 3,
+        list = 4,
+        map = 5,
+        tag = 6,
+        simple = 7,
+    };
+
+    /// @brief A container whose header is rewritten with the number of elements
+    /// it actually contains when it ends.
+    struct Container
+    {
+        /// @brief Where the header of the container was written.
+        uint8_t *header;
+        /// @brief The number of elements in the enclosing container.
+        size_t elemCount;
+    };
+
+    /// @brief Gets the length of the header encoding a value or length.
+    /// @param value The value to encode.
+    /// @return 1 if the value fits in the initial byte, otherwise 2, 3, 5 or 9.
+    static constexpr size_t headerLength(uint64_t value)
+    {
+        // the number of bytes following the initial byte, by bit width
+        constexpr uint8_t following[65] = {
+            1, 1, 1, 1, 1, 1, 1, 1, 1,             // 0-8 bits
+            2, 2, 2, 2, 2, 2, 2, 2,                // 9-16 bits
+            4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, // 17-32 bits
+            8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, // 33-64 bits
+            8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+        };
+        return 1 + following[std::bit_width(value)] * (value > ZCBOR_VALUE_IN_HEADER);
+    }
+
+    /// @brief Writes the initial byte of an item, followed by its value or
+    /// length in as few bytes as possible.
+    static bool writeHeader(zcbor_state_t *state, MajorType major, uint64_t value)
+    {
+        size_t length = headerLength(value);
+        if ((size_t)(state->payload_end - state->payload) < length) {
+            return false;
+        }
+        writeHeader(state->payload_mut, major, value, length);
+        state->payload_mut += length;
+        state->elem_count++;
+        return true;
+    }
+
+    static bool writeUnsigned(zcbor_state_t *state, uint64_t value)
+    {
+        return writeHeader(state, unsignedInteger, value);
+    }
+
+    static bool writeSigned(zcbor_state_t *state, int64_t value)
+    {
+        // all ones if negative, in which case the value written is -1 - value
+        uint64_t sign = (uint64_t)(value >> 63);
+        return writeHeader(state, (MajorType)(sign & negativeInteger), (uint64_t)value ^ sign);
+    }
+
+    static bool writeFloat(zcbor_state_t *state, float value)
+    {
+        uint32_t bits = std::bit_cast<uint32_t>(value);
+        uint8_t bytes[] = { 0xFA, (uint8_t)(bits >> 24), (uint8_t)(bits >> 16), (uint8_t)(bits >> 8), (uint8_t)bits };
+        return writeRaw(state, bytes, sizeof(bytes));
+    }
+
+    static bool writeDouble(zcbor_state_t *state, double value)
+    {
+        uint64_t bits = std::bit_cast<uint64_t>(value);
+        uint8_t bytes[] = { 0xFB,
+                            (uint8_t)(bits >> 56),
+                            (uint8_t)(bits >> 48),
+                            (uint8_t)(bits >> 40),
+                            (uint8_t)(bits >> 32),
+                            (uint8_t)(bits >> 24),
+                            (uint8_t)(bits >> 16),
+                            (uint8_t)(bits >> 8),
+                            (uint8_t)bits };
+        return writeRaw(state, bytes, sizeof(bytes));
+    }
+
+    /// @brief Writes a float as a half-precision float if that represents it
+    /// exactly, otherwise as a single-precision float.
+    static bool writeShortestFloat(zcbor_state_t *state, float value)
+    {
+        uint16_t half;
+        if (toHalf(value, half)) {
+            uint8_t bytes[] = { 0xF9, (uint8_t)(half >> 8), (uint8_t)half };
+            return writeRaw(state, bytes, sizeof(bytes));
+        }
+        return writeFloat(state, value);
+    }
+
+    /// @brief Writes a double as the shortest of a half-, single- or
+    /// double-precision float which represents it exactly.
+    static bool writeShortestDouble(zcbor_state_t *state, double value)
+    {
+        float single = (float)value;
+        if (std::bit_cast<uint64_t>((double)single) == std::bit_cast<uint64_t>(value)) {
+            return writeShortestFloat(state, single);
+        }
+        return writeDouble(state, value);
+    }
+
+    /// @brief Converts a float to a half-precision float, if it can be
+    /// represented exactly, including infinities, NaN payloads and signed zeros.
+    /// @param value The value to convert.
+    /// @param half The half-precision bits, if the conversion is exact.
+    /// @return True if the conversion is exact, otherwise false.
+    static constexpr bool toHalf(float value, uint16_t &half)
+    {
+        uint32_t bits = std::bit_cast<uint32_t>(value);
+        uint16_t sign = (bits >> 16) & 0x8000;
+        int exponent = (int)((bits >> 23) & 0xFF) - 127;
+        uint32_t mantissa = bits & 0x7FFFFF;
+        if (exponent == 128) {
+            // infinity or NaN; only the top 10 bits of the mantissa survive
+            half = sign | 0x7C00 | (mantissa >> 13);
+            return (mantissa & 0x1FFF) == 0;
+        }
+        if (exponent == -127) {
+            // zero or a subnormal float, which is too small for a half
+            half = sign;
+            return mantissa == 0;
+        }
+        if (exponent >= -14 && exponent <= 15) {
+            half = sign | ((exponent + 15) << 10) | (mantissa >> 13);
+            return (mantissa & 0x1FFF) == 0;
+        }
+        if (exponent >= -24 && exponent < -14) {
+            // a subnormal half, in units of 2^-24
+            uint32_t significand = mantissa | 0x800000;
+            int shift = -1 - exponent;
+            half = sign | (uint16_t)(significand >> shift);
+            return (significand & ((1U << shift) - 1)) == 0;
+        }
+        return false;
+    }
+
+    static bool writeBool(zcbor_state_t *state, bool value)
+    {
+        uint8_t byte = 0xF4 | value;
+        return writeRaw(state, &byte, 1);
+    }
+
+    static bool writeNull(zcbor_state_t *state)
+    {
+        uint8_t byte = 0xF6;
+        return writeRaw(state, &byte, 1);
+    }
+
+    /// @brief Writes a text or byte string.
+    static bool writeString(zcbor_state_t *state, MajorType major, const uint8_t *value, size_t length)
+    {
+        size_t header = headerLength(length);
+        if ((size_t)(state->payload_end - state->payload) < header + length) {
+            return false;
+        }
+        writeHeader(state->payload_mut, major, length, header);
+        if (length > 0) {
+            memmove(state->payload_mut + header, value, length);
+        }
+        state->payload_mut += header + length;
+        state->elem_count++;
+        return true;
+    }
+
+    /// @brief Writes a tag, which together with the item which follows it
+    /// counts as a single element.
+    static bool writeTag(zcbor_state_t *state, uint64_t value)
+    {
+        if (!writeHeader(state, tag, value)) {
+            return false;
+        }
+        state->elem_count--;
+        return true;
+    }
+
+    /// @brief Starts a list or map of definite length.
+    /// @param major Either @ref list or @ref map.
+    /// @param maxCount The greatest number of elements the container will hold.
+    /// @param container If not null, records where the container starts, so that
+    /// its header can be rewritten when it ends. Pass null if the encoding is
+    /// forward-only, in which case maxCount must be the actual number of elements.
+    /// @return True if writing succeeded, otherwise false.
+    static bool writeContainerStart(zcbor_state_t *state, MajorType major, size_t maxCount, Container *container)
+    {
+        if (container == nullptr) {
+            return writeHeader(state, major, maxCount);
+        }
+        container->header = state->payload_mut;
+        container->elemCount = state->elem_count;
+        if (!writeHeader(state, major, maxCount)) {
+            return false;
+        }
+        state->elem_count = 0;
+        return true;
+    }
+
+    /// @brief Ends a list or map of definite length.
+    /// @param major Either @ref list or @ref map.
+    /// @param maxCount The number of elements passed when the container was started.
+    /// @param container The container, as recorded when it was started, or null if
+    /// the encoding is forward-only.
+    /// @return True if writing succeeded, otherwise false.
+    static bool writeContainerEnd(zcbor_state_t *state, MajorType major, size_t maxCount, Container *container)
+    {
+        if (container == nullptr) {
+            return true;
+        }
+        size_t count = major == map ? state->elem_count / 2 : state->elem_count;
+        size_t reserved = headerLength(maxCount);
+        size_t length = headerLength(count);
+        if (length > reserved) {
+            return false;
+        }
+        writeHeader(container->header, major, count, length);
+        if (length != reserved) {
+            // the header is shorter than the one written at the start, so move
+            // the elements back to meet it
+            uint8_t *body = container->header + reserved;
+            memmove(container->header + length, body, state->payload_mut - body);
+            state->payload_mut -= reserved - length;
+        }
+        state->elem_count = container->elemCount + 1;
+        return true;
+    }
+
+    /// @brief Starts a list or map of indefinite length, which is ended by
+    /// @ref writeBreak.
+    static bool writeIndefiniteStart(zcbor_state_t *state, MajorType major)
+    {
+        uint8_t byte = (major << 5) | 31;
+        return writeRaw(state, &byte, 1);
+    }
+
+    static bool writeBreak(zcbor_state_t *state)
+    {
+        uint8_t byte = 0xFF;
+        return writeRaw(state, &byte, 1);
+    }
+
+private:
+    static void writeHeader(uint8_t *p, MajorType major, uint64_t value, size_t length)
+    {
+        switch (length) {
+            case 1:
+                p[0] = (major << 5) | (uint8_t)value;
+                break;
+            case 2:
+                p[0] = (major << 5) | 24;
+                p[1] = (uint8_t)value;
+                break;
+            case 3:
+                p[0] = (major << 5) | 25;
+                p[1] = (uint8_t)(value >> 8);
+                p[2] = (uint8_t)value;
+                break;
+            case 5:
+                p[0] = (major << 5) | 26;
+                p[1] = (uint8_t)(value >> 24);
+                p[2] = (uint8_t)(value >> 16);
+                p[3] = (uint8_t)(value >> 8);
+                p[4] = (uint8_t)value;
+                break;
+            default:
+                p[0] = (major << 5) | 27;
+                for (int i = 0; i < 8; i++) {
+                    p[1 + i] = (uint8_t)(value >> (56 - 8 * i));
+                }
+                break;
+        }
+    }
+
+    static bool writeRaw(zcbor_state_t *state, const uint8_t *bytes, size_t length)
+    {
+        if ((size_t)(state->payload_end - state->payload) < length) {
+            return false;
+        }
+        memcpy(state->payload_mut, bytes, length);
+        state->payload_mut += length;
+        state->elem_count++;
+        return true;
+    }
+};
+
+/// @brief The containers open in an encoder which rewrites container headers.
+/// @tparam Depth The greatest number of containers which can be open at once.
+template <size_t Depth> class CborContainerStack
+{
+private:
+    CborWriter::Container _containers[Depth];
+    size_t _count = 0;
+
+public:
+    /// @brief Gets the next container to open, or null if too many are open.
+    CborWriter::Container *push()
+    {
+        return _count < Depth ? &_containers[_count++] : nullptr;
+    }
+
+    /// @brief Gets the innermost open container, and closes it.
+    CborWriter::Container *pop()
+    {
+        return _count > 0 ? &_containers[--_count] : nullptr;
+    }
+};
+
+} // namespace ThingSet
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifndef CONFIG_THINGSET_PLUS_PLUS_DELEGATE_SIZE
+#define CONFIG_THINGSET_PLUS_PLUS_DELEGATE_SIZE 32
+#endif
+
+namespace ThingSet {
+
+template <typename Signature, size_t Size = CONFIG_THINGSET_PLUS_PLUS_DELEGATE_SIZE>
+class Delegate;
+
+/// @brief An owning wrapper around a callable, for callbacks which are kept
+/// after the function taking them returns. The callable is always stored
+/// inline, so unlike std::function, a delegate never allocates; a callable
+/// whose captures exceed the inline storage is rejected at compile time.
+template <typename Result, typename... Args, size_t Size>
+class Delegate<Result(Args...), Size>
+{
+private:
+    enum class Operation
+    {
+        copy,
+        move,
+        destroy,
+    };
+
+    alignas(std::max_align_t) std::byte _storage[Size];
+    Result (*_invoke)(void *, Args...);
+    /// @brief Copies, moves or destroys the callable; null if the callable
+    /// is trivially copyable, in which case its bytes are simply copied.
+    void (*_manage)(Operation, void *, void *);
+
+public:
+    Delegate() : _invoke(nullptr), _manage(nullptr)
+    {}
+
+    template <typename Callable>
+        requires(!std::is_same_v<std::remove_cvref_t<Callable>, Delegate>)
+                && std::is_invocable_r_v<Result, std::decay_t<Callable> &, Args...>
+    Delegate(Callable &&callable)
+    {
+        using Target = std::decay_t<Callable>;
+        static_assert(sizeof(Target) <= Size, "Callable is too large to store in a delegate");
+        static_assert(alignof(Target) <= alignof(std::max_align_t), "Callable is over-aligned");
+        new (_storage) Target(std::forward<Callable>(callable));
+        _invoke = [](void *target, Args... args) -> Result {
+            return (*static_cast<Target *>(target))(std::forward<Args>(args)...);
+        };
+        if constexpr (std::is_trivially_copyable_v<Target>) {
+            _manage = nullptr;
+        }
+        else {
+            _manage = [](Operation operation, void *to, void *from) {
+                switch (operation) {
+                    case Operation::copy:
+                        new (to) Target(*static_cast<const Target *>(from));
+                        break;
+                    case Operation::move:
+                        new (to) Target(std::move(*static_cast<Target *>(from)));
+                        break;
+                    case Operation::destroy:
+                        static_cast<Target *>(to)->~Target();
+                        break;
+                }
+            };
+        }
+    }
+
+    Delegate(const Delegate &other) : _invoke(other._invoke), _manage(other._manage)
+    {
+        assign(Operation::copy, const_cast<Delegate &>(other));
+    }
+
+    Delegate(Delegate &&other) : _invoke(other._invoke), _manage(other._manage)
+    {
+        assign(Operation::move, other);
+    }
+
+    ~Delegate()
+    {
+        reset();
+    }
+
+    Delegate &operator=(const Delegate &other)
+    {
+        if (this != &other) {
+            reset();
+            _invoke = other._invoke;
+            _manage = other._manage;
+            assign(Operation::copy, const_cast<Delegate &>(other));
+        }
+        return *this;
+    }
+
+    Delegate &operator=(Delegate &&other)
+    {
+        if (this != &other) {
+            reset();
+            _invoke = other._invoke;
+            _manage = other._manage;
+            assign(Operation::move, other);
+        }
+        return *this;
+    }
+
+    /// @brief Whether the delegate holds a callable.
+    explicit operator bool() const
+    {
+        return _invoke != nullptr;
+    }
+
+    Result operator()(Args... args) const
+    {
+        return _invoke(const_cast<std::byte *>(_storage), std::forward<Args>(args)...);
+    }
+
+private:
+    void assign(Operation operation, Delegate &other)
+    {
+        if (_manage) {
+            _manage(operation, _storage, other._storage);
+        }
+        else if (_invoke) {
+            std::memcpy(_storage, other._storage, Size);
+        }
+    }
+
+    void reset()
+    {
+        if (_manage) {
+            _manage(Operation::destroy, _storage, nullptr);
+        }
+        _invoke = nullptr;
+        _manage = nullptr;
+    }
+};
+
+} // namespace ThingSet
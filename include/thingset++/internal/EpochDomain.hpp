@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __ZEPHYR__
+#include <zephyr/kernel.h>
+#else
+#include <mutex>
+#include <thread>
+#endif
+
+#ifndef CONFIG_THINGSET_PLUS_PLUS_CONCURRENT_REGISTRY_MAX_READERS
+#define CONFIG_THINGSET_PLUS_PLUS_CONCURRENT_REGISTRY_MAX_READERS 16
+#endif
+
+namespace ThingSet {
+
+/// @brief Epoch-based read-copy-update domain.
+///
+/// Readers announce the epoch in which they entered a read-side critical
+/// section in a per-thread slot; entering and leaving take no locks. Writers
+/// serialise on a recursive mutex and, once they have unpublished some data, call
+/// synchronize() to wait until every reader which might still hold a
+/// reference to it has left its critical section.
+class EpochDomain
+{
+public:
+    static constexpr size_t maxReaders = CONFIG_THINGSET_PLUS_PLUS_CONCURRENT_REGISTRY_MAX_READERS;
+
+private:
+    std::atomic<uint64_t> _epoch;
+    /// @brief Epoch in which each reader entered, or zero if it is quiescent.
+    std::array<std::atomic<uint64_t>, maxReaders> _readers;
+    std::array<bool, maxReaders> _allocated;
+    /// @brief True once any reader slot has been allocated; until then,
+    /// writers may safely modify data in place.
+    bool _shared;
+#ifdef __ZEPHYR__
+    k_mutex _lock;
+#else
+    std::recursive_mutex _lock;
+#endif
+
+public:
+    EpochDomain() : _epoch(1), _readers(), _allocated(), _shared(false)
+    {
+#ifdef __ZEPHYR__
+        k_mutex_init(&_lock);
+#endif
+    }
+
+    void lock()
+    {
+#ifdef __ZEPHYR__
+        k_mutex_lock(&_lock, K_FOREVER);
+#else
+        _lock.lock();
+#endif
+    }
+
+    void unlock()
+    {
+#ifdef __ZEPHYR__
+        k_mutex_unlock(&_lock);
+#else
+        _lock.unlock();
+#endif
+    }
+
+    /// @brief Whether readers may be active. Only valid with the lock held.
+    bool isShared() const
+    {
+        return _shared;
+    }
+
+    /// @brief Allocate a slot for a reader thread. Takes the writer lock, so
+    /// that writers which saw no readers can finish modifying data in place.
+    /// @return The slot index, or -1 if all slots are in use.
+    int allocate()
+    {
+        lock();
+        int slot = -1;
+        for (size_t i = 0; i < maxReaders; i++) {
+            if (!_allocated[i]) {
+                _allocated[i] = true;
+                _shared = true;
+                slot = (int)i;
+                break;
+            }
+        }
+        unlock();
+        return slot;
+    }
+
+    void release(int slot)
+    {
+        lock();
+        _allocated[slot] = false;
+        unlock();
+    }
+
+    void enter(int slot)
+    {
+        _readers[slot].store(_epoch.load());
+        // order the announcement before any reads of shared data, so that a
+        // concurrent synchronize() either waits for this reader or the reader
+        // sees everything unpublished before it
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void exit(int slot)
+    {
+        _readers[slot].store(0, std::memory_order_release);
+    }
+
+    /// @brief Wait for all readers which entered before the call to leave
+    /// their critical sections.
+    /// @param self The slot of the calling thread, if it is itself inside a
+    /// critical section, otherwise -1. That slot is not waited for.
+    void synchronize(int self)
+    {
+        // pairs with the fence in enter()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const uint64_t epoch = _epoch.fetch_add(1) + 1;
+        for (size_t i = 0; i < maxReaders; i++) {
+            if ((int)i == self) {
+                continue;
+            }
+            for (uint64_t e = _readers[i].load(); e != 0 && e < epoch; e = _readers[i].load()) {
+#ifdef __ZEPHYR__
+                k_yield();
+#else
+                std::this_thread::yield();
+#endif
+            }
+        }
+    }
+};
+
+} // namespace ThingSet
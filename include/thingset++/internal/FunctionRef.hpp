@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ThingSet {
+
+template <typename Signature>
+class FunctionRef;
+
+/// @brief A non-owning reference to a callable. Unlike std::function, this
+/// never allocates and is two pointers in size, so it is suitable for
+/// callbacks which are only invoked before the function taking them returns.
+/// The callable must outlive the reference.
+template <typename Result, typename... Args>
+class FunctionRef<Result(Args...)>
+{
+private:
+    void *_callable;
+    Result (*_invoke)(void *, Args...);
+
+public:
+    template <typename Callable>
+        requires(!std::is_same_v<std::remove_cvref_t<Callable>, FunctionRef>)
+                && std::is_invocable_r_v<Result, Callable &, Args...>
+    FunctionRef(Callable &&callable)
+        : _callable(const_cast<void *>(static_cast<const void *>(std::addressof(callable)))),
+          _invoke([](void *target, Args... args) -> Result {
+              return (*static_cast<std::remove_reference_t<Callable> *>(target))(std::forward<Args>(args)...);
+          })
+    {}
+
+    Result operator()(Args... args) const
+    {
+        return _invoke(_callable, std::forward<Args>(args)...);
+    }
+};
+
+} // namespace ThingSet
@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include "thingset++/internal/shared.hpp"
 #include <cstddef>
 #include <new>
 
@@ -15,21 +16,32 @@ class IntrusiveLinkedListNode;
 template <typename T, IntrusiveLinkedListNode T::*Member>
 class IntrusiveLinkedList;
 
-/// @brief Holds a pointer to the next member of an intrusive
-/// linked list.
+/// @brief Holds pointers to the next and previous members of an
+/// intrusive linked list.
 class IntrusiveLinkedListNode
 {
     template <typename T, IntrusiveLinkedListNode T::*Member>
     friend class IntrusiveLinkedList;
 
     IntrusiveLinkedListNode *next;
+    IntrusiveLinkedListNode *prev;
 
 public:
-    constexpr IntrusiveLinkedListNode() : next(nullptr)
+    constexpr IntrusiveLinkedListNode() : next(nullptr), prev(nullptr)
     {}
+
+    /// @brief Copies of an element are not members of any list.
+    constexpr IntrusiveLinkedListNode(const IntrusiveLinkedListNode &) : next(nullptr), prev(nullptr)
+    {}
+
+    IntrusiveLinkedListNode &operator=(const IntrusiveLinkedListNode &)
+    {
+        return *this;
+    }
 };
 
-/// @brief Intrusive linked list.
+/// @brief Intrusive doubly-linked list. Adding and removing elements
+/// are constant-time operations.
 /// @tparam T The type of elements in the list.
 /// @tparam Member The member in the type which contains the list
 /// member pointer.
@@ -70,10 +82,17 @@ public:
 
         IntrusiveLinkedListIterator &operator++()
         {
-            _node = _node->next;
+            _node = sharedLoad(_node->next);
             return *this;
         }
 
+        IntrusiveLinkedListIterator operator++(int)
+        {
+            IntrusiveLinkedListIterator previous = *this;
+            ++(*this);
+            return previous;
+        }
+
         Element *operator*() const
         {
             // https://github.com/boostorg/intrusive/blob/master/include/boost/intrusive/detail/parent_from_member.hpp
@@ -97,7 +116,7 @@ public:
 
     IntrusiveLinkedListIterator<T> begin()
     {
-        return IntrusiveLinkedListIterator<T>(this, _head);
+        return IntrusiveLinkedListIterator<T>(this, sharedLoad(_head));
     }
 
     IntrusiveLinkedListIterator<T> end()
@@ -107,7 +126,7 @@ public:
 
     IntrusiveLinkedListIterator<const T> cbegin() const
     {
-        return IntrusiveLinkedListIterator<const T>(this, _head);
+        return IntrusiveLinkedListIterator<const T>(this, sharedLoad(_head));
     }
 
     IntrusiveLinkedListIterator<const T> cend() const
@@ -143,16 +162,16 @@ public:
     void push_back(T *object)
     {
         IntrusiveLinkedListNode *node = &(object->*Member);
-        if (node->next) {
-            // what is the right behaviour here?
-            // we could just set it to null and carry on, but...
+        if (isHead(node) || node->next || node->prev) {
+            // already in this or another list
             return;
         }
         if (_tail == nullptr) {
             _tail = node;
-            _head = node;
+            sharedStore(_head, node);
         } else {
-            _tail->next = node;
+            node->prev = _tail;
+            sharedStore(_tail->next, node);
             _tail = node;
         }
     }
@@ -162,32 +181,57 @@ public:
         return remove(&object);
     }
 
+    /// @brief Remove an element from the list. The element is assumed to
+    /// be in this list if it is linked into any list via this member.
+    /// @param object The element to remove.
+    /// @return True if the element was removed, otherwise false.
     bool remove(T *object)
+    {
+        if (!unlink(object)) {
+            return false;
+        }
+        reset(object);
+        return true;
+    }
+
+    /// @brief Remove an element from the list, but leave its own links
+    /// intact, so that anyone currently traversing the list from that
+    /// element can carry on. Call reset() once that is no longer possible.
+    /// @param object The element to unlink.
+    /// @return True if the element was unlinked, otherwise false.
+    bool unlink(T *object)
     {
         IntrusiveLinkedListNode *node = &(object->*Member);
+        if (!isHead(node) && node->prev == nullptr) {
+            return false;
+        }
 
-        IntrusiveLinkedListNode *prev = nullptr;
-        IntrusiveLinkedListNode *test;
-        for (test = _head; test != nullptr; test = test->next) {
-            if (test == node) {
-                // remove
-                if (prev == nullptr) {
-                    _head = node->next;
-                    if (_tail == node) {
-                        _tail = _head;
-                    }
-                } else {
-                    prev->next = node->next;
-                    if (_tail == node) {
-                        _tail = prev;
-                    }
-                }
-                node->next = nullptr;
-                return true;
-            }
-            prev = test;
+        if (node->prev) {
+            sharedStore(node->prev->next, node->next);
+        } else {
+            sharedStore(_head, node->next);
         }
-        return false;
+        if (node->next) {
+            node->next->prev = node->prev;
+        } else {
+            _tail = node->prev;
+        }
+        return true;
+    }
+
+    /// @brief Clear the links of an element which has been unlinked.
+    /// @param object The element.
+    static void reset(T *object)
+    {
+        IntrusiveLinkedListNode *node = &(object->*Member);
+        sharedStore(node->next, nullptr);
+        node->prev = nullptr;
+    }
+
+private:
+    bool isHead(const IntrusiveLinkedListNode *node) const
+    {
+        return _head == node;
     }
 };
 
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#ifndef JSMN_HEADER
+#define JSMN_HEADER
+#endif
+#include "thingset++/internal/jsmn.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace ThingSet {
+
+/// @brief Splits JSON into the same tokens as jsmn, but, in the manner of the
+/// first stage of simdjson, classifies 64 bytes at a time to find structural
+/// characters, using AVX2, SSE2 or NEON where available and plain loops
+/// otherwise, then visits only those characters.
+///
+/// Malformed input does not always split the same way when classified a block
+/// at a time: jsmn, for instance, carries a primitive on through quotes and
+/// brackets, and reports a bad escape before it finds whether the string is
+/// closed. So whenever the tokenizer meets an error, or a primitive which runs
+/// into a quote or bracket, it hands the input to jsmn, which decides the tokens
+/// or the error from then on. Valid JSON never takes this path.
+///
+/// Parsing can be resumed. If there are not enough tokens for the next token,
+/// @ref parse returns JSMN_ERROR_NOMEM where jsmn would, and can be called
+/// again with a larger array holding the tokens parsed so far.
+class JsonTokenizer
+{
+private:
+    static const size_t noString = SIZE_MAX;
+
+    // the offset of the block being visited, or of the next one to classify
+    size_t _position;
+    // the structural characters in the block at _position not yet visited
+    uint64_t _structurals;
+    // true if the block at _position has been classified
+    bool _classified;
+    // true once the input has been handed to jsmn
+    bool _fallenBack;
+    // 1 if the first character of the next block is escaped
+    uint64_t _escaped;
+    // all ones if the next block starts inside a string
+    uint64_t _inString;
+    // 1 if the previous block ended inside a primitive
+    uint64_t _inPrimitive;
+    unsigned int _tokenCount;
+    // the token to which the next token belongs, as in jsmn
+    int _super;
+    // the innermost open object or array
+    int _open;
+    // the offset of the opening quote of the current string, if in one
+    size_t _stringStart;
+
+public:
+    JsonTokenizer();
+
+    /// @brief Parses JSON into tokens.
+    /// @param json The JSON, which ends at the first null character, if any.
+    /// @param length The length of the JSON.
+    /// @param tokens The tokens, which must begin with any from previous calls.
+    /// @param capacity The number of tokens in the array.
+    /// @return The number of tokens, or a negative @ref jsmnerr.
+    int parse(const char *json, size_t length, jsmntok *tokens, unsigned int capacity);
+
+    /// @brief Gets the number of tokens parsed so far.
+    unsigned int getTokenCount() const;
+
+private:
+    int visit(const char *json, size_t length, size_t offset, jsmntok *tokens, unsigned int capacity);
+    jsmntok *allocate(jsmntok *tokens, unsigned int capacity, jsmntype_t type, size_t start, size_t end);
+    int fallBack(const char *json, size_t length, jsmntok *tokens, unsigned int capacity);
+};
+
+} // namespace ThingSet
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifndef THINGSET_PLUS_PLUS_INDEX_INITIAL_CAPACITY
+#define THINGSET_PLUS_PLUS_INDEX_INITIAL_CAPACITY 16
+#endif
+
+namespace ThingSet {
+
+/// @brief Growable open-addressed hash index mapping 32-bit keys to
+/// object pointers. Uses linear probing with backward-shift deletion,
+/// so lookups never have to step over tombstones.
+/// @tparam T The type of object indexed.
+template <typename T>
+class OpenAddressedIndex
+{
+private:
+    struct Slot
+    {
+        uint32_t key;
+        T *value;
+    };
+
+    std::vector<Slot> _slots;
+    size_t _count;
+    unsigned _shift;
+
+public:
+    OpenAddressedIndex() : _count(0), _shift(32)
+    {}
+
+    size_t size() const
+    {
+        return _count;
+    }
+
+    size_t capacity() const
+    {
+        return _slots.size();
+    }
+
+    /// @brief Find the object with the given key.
+    /// @param key The key of the object sought.
+    /// @return A pointer to the object, or nullptr if no object has that key.
+    T *find(uint32_t key) const
+    {
+        if (_count == 0) {
+            return nullptr;
+        }
+        const size_t mask = _slots.size() - 1;
+        for (size_t i = hash(key);; i = (i + 1) & mask) {
+            const Slot &slot = _slots[i];
+            if (slot.value == nullptr) {
+                return nullptr;
+            }
+            if (slot.key == key) {
+                return slot.value;
+            }
+        }
+    }
+
+    /// @brief Find an object with the given key which also satisfies a predicate.
+    /// Use this if more than one object may share a key.
+    /// @param key The key of the object sought.
+    /// @param predicate Returns true if the candidate object is the one sought.
+    /// @return A pointer to the object, or nullptr if there was no match.
+    template <typename Predicate>
+    T *find(uint32_t key, Predicate predicate) const
+    {
+        if (_count == 0) {
+            return nullptr;
+        }
+        const size_t mask = _slots.size() - 1;
+        for (size_t i = hash(key);; i = (i + 1) & mask) {
+            const Slot &slot = _slots[i];
+            if (slot.value == nullptr) {
+                return nullptr;
+            }
+            if (slot.key == key && predicate(slot.value)) {
+                return slot.value;
+            }
+        }
+    }
+
+    /// @brief Add an object to the index.
+    /// @param key The key of the object.
+    /// @param value A pointer to the object.
+    /// @param existing If the key is already present, contains the object
+    /// already indexed under it when the method returns.
+    /// @return True if the object was added, false if the key was already present.
+    bool insert(uint32_t key, T *value, T **existing = nullptr)
+    {
+        if ((_count + 1) * 4 > _slots.size() * 3) {
+            grow();
+        }
+        const size_t mask = _slots.size() - 1;
+        for (size_t i = hash(key);; i = (i + 1) & mask) {
+            Slot &slot = _slots[i];
+            if (slot.value == nullptr) {
+                slot.key = key;
+                slot.value = value;
+                _count++;
+                return true;
+            }
+            if (slot.key == key) {
+                if (existing) {
+                    *existing = slot.value;
+                }
+                return false;
+            }
+        }
+    }
+
+    /// @brief Add an object to the index, even if other objects share its key.
+    /// @param key The key of the object.
+    /// @param value A pointer to the object.
+    void add(uint32_t key, T *value)
+    {
+        if ((_count + 1) * 4 > _slots.size() * 3) {
+            grow();
+        }
+        const size_t mask = _slots.size() - 1;
+        size_t i = hash(key);
+        while (_slots[i].value != nullptr) {
+            i = (i + 1) & mask;
+        }
+        _slots[i] = Slot{ key, value };
+        _count++;
+    }
+
+    /// @brief Remove the object with the given key from the index.
+    /// @param key The key of the object to remove.
+    /// @return True if an object was removed, otherwise false.
+    bool remove(uint32_t key)
+    {
+        return remove(key, nullptr);
+    }
+
+    /// @brief Remove an object from the index.
+    /// @param key The key of the object to remove.
+    /// @param value The object to remove, or nullptr to remove whichever
+    /// object has the key.
+    /// @return True if the object was removed, otherwise false.
+    bool remove(uint32_t key, const T *value)
+    {
+        if (_count == 0) {
+            return false;
+        }
+        const size_t mask = _slots.size() - 1;
+        size_t i = hash(key);
+        while (_slots[i].key != key || (value != nullptr && _slots[i].value != value)) {
+            if (_slots[i].value == nullptr) {
+                return false;
+            }
+            i = (i + 1) & mask;
+        }
+        if (_slots[i].value == nullptr) {
+            return false;
+        }
+
+        // shift back any following entries in the same cluster which would
+        // otherwise become unreachable
+        for (size_t j = (i + 1) & mask; _slots[j].value != nullptr; j = (j + 1) & mask) {
+            size_t home = hash(_slots[j].key);
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                _slots[i] = _slots[j];
+                i = j;
+            }
+        }
+        _slots[i] = Slot{ 0, nullptr };
+        _count--;
+        return true;
+    }
+
+private:
+    size_t hash(uint32_t key) const
+    {
+        // Fibonacci hashing; node IDs tend to be clustered, so spread them out
+        return (size_t)((key * 2654435769u) >> _shift);
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old;
+        old.swap(_slots);
+        size_t capacity = old.empty() ? THINGSET_PLUS_PLUS_INDEX_INITIAL_CAPACITY : old.size() * 2;
+        _slots.assign(capacity, Slot{ 0, nullptr });
+        _shift = 32;
+        for (size_t c = capacity; c > 1; c >>= 1) {
+            _shift--;
+        }
+        _count = 0;
+        for (const Slot &slot : old) {
+            if (slot.value != nullptr) {
+                add(slot.key, slot.value);
+            }
+        }
+    }
+};
+
+} // namespace ThingSet
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "thingset++/internal/fnv1a.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+namespace ThingSet {
+
+/// @brief Direct-mapped cache of the results of resolving full paths.
+/// Paths are copied into fixed-size entries, so neither lookups nor
+/// insertions allocate; paths longer than MaxLength are not cached.
+/// Lookups and insertions may run on several threads at once: each entry is
+/// claimed while it is read or written, and a thread which finds it claimed
+/// treats it as a miss rather than waiting. Clearing must not overlap them.
+/// @tparam T The type of object to which paths resolve.
+/// @tparam Entries The number of entries in the cache.
+/// @tparam MaxLength The maximum length of a cached path.
+template <typename T, size_t Entries, size_t MaxLength>
+class PathCache
+{
+    static_assert(MaxLength <= UINT8_MAX);
+
+private:
+    struct Entry
+    {
+        mutable std::atomic<bool> busy;
+        T *value;
+        size_t index;
+        uint32_t generation;
+        uint32_t hash;
+        uint8_t length;
+        char path[MaxLength];
+    };
+
+    std::array<Entry, Entries> _entries;
+    /// @brief Entries from earlier generations are stale.
+    std::atomic<uint32_t> _generation;
+
+public:
+    PathCache() : _entries(), _generation(1)
+    {}
+
+    /// @brief Find a previously resolved path.
+    /// @param path The full path.
+    /// @param value When the method returns, contains the object the path resolved to.
+    /// @param index When the method returns, contains the array index the path resolved to.
+    /// @return True if the path was in the cache, otherwise false.
+    bool find(std::string_view path, T **value, size_t *index) const
+    {
+        if constexpr (Entries == 0) {
+            return false;
+        } else {
+            if (path.size() > MaxLength) {
+                return false;
+            }
+            uint32_t hash = fnv1a(path);
+            const Entry &entry = _entries[hash % Entries];
+            if (entry.busy.exchange(true, std::memory_order_acquire)) {
+                return false;
+            }
+            bool found = entry.generation == _generation.load(std::memory_order_relaxed) && entry.hash == hash
+                         && entry.length == path.size() && memcmp(entry.path, path.data(), path.size()) == 0;
+            if (found) {
+                *value = entry.value;
+                *index = entry.index;
+            }
+            entry.busy.store(false, std::memory_order_release);
+            return found;
+        }
+    }
+
+    /// @brief Store the result of resolving a path.
+    /// @param path The full path.
+    /// @param value The object the path resolved to.
+    /// @param index The array index the path resolved to.
+    void insert(std::string_view path, T *value, size_t index)
+    {
+        if constexpr (Entries > 0) {
+            if (path.size() > MaxLength) {
+                return;
+            }
+            uint32_t hash = fnv1a(path);
+            Entry &entry = _entries[hash % Entries];
+            if (entry.busy.exchange(true, std::memory_order_acquire)) {
+                return;
+            }
+            entry.value = value;
+            entry.index = index;
+            entry.generation = _generation.load(std::memory_order_relaxed);
+            entry.hash = hash;
+            entry.length = (uint8_t)path.size();
+            memcpy(entry.path, path.data(), path.size());
+            entry.busy.store(false, std::memory_order_release);
+        }
+    }
+
+    /// @brief Remove all entries from the cache.
+    void clear()
+    {
+        _generation.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+} // namespace ThingSet
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#ifdef ENABLE_CONCURRENT_REGISTRY
+#include <atomic>
+#endif
+
+namespace ThingSet {
+
+/// @brief Holds an object which readers may access concurrently with a
+/// single writer. In concurrent mode, once readers may be active, the writer
+/// modifies a private copy, which replaces the current version when it is
+/// published; the previous version must then be retained until no reader
+/// can still be using it. Otherwise, the object is modified in place.
+/// @tparam T The type of object held.
+template <typename T>
+class Snapshot
+{
+#ifdef ENABLE_CONCURRENT_REGISTRY
+private:
+    std::atomic<T *> _current;
+    T *_draft;
+    T *_retired;
+
+public:
+    Snapshot() : _current(new T()), _draft(nullptr), _retired(nullptr)
+    {}
+
+    ~Snapshot()
+    {
+        delete _current.load();
+        delete _draft;
+        delete _retired;
+    }
+
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator=(const Snapshot &) = delete;
+
+    /// @brief Get the current version of the object.
+    const T &read() const
+    {
+        return *_current.load(std::memory_order_acquire);
+    }
+
+    /// @brief Get a version of the object which the writer may modify.
+    /// @param shared True if readers may be active.
+    T &write(bool shared)
+    {
+        if (!shared) {
+            return *_current.load(std::memory_order_relaxed);
+        }
+        if (_draft == nullptr) {
+            _draft = new T(*_current.load(std::memory_order_relaxed));
+        }
+        return *_draft;
+    }
+
+    /// @brief Make any modified copy the current version.
+    /// @return True if there is a previous version to reclaim.
+    bool publish()
+    {
+        if (_draft == nullptr) {
+            return false;
+        }
+        _retired = _current.exchange(_draft);
+        _draft = nullptr;
+        return true;
+    }
+
+    /// @brief Destroy the previous version. Only call this once no reader
+    /// can still be using it.
+    void reclaim()
+    {
+        delete _retired;
+        _retired = nullptr;
+    }
+#else
+private:
+    T _current;
+
+public:
+    const T &read() const
+    {
+        return _current;
+    }
+
+    T &write(bool)
+    {
+        return _current;
+    }
+
+    bool publish()
+    {
+        return false;
+    }
+
+    void reclaim()
+    {}
+#endif
+};
+
+} // namespace ThingSet
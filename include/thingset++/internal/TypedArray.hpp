@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ThingSet {
+
+/// @brief Support for the typed arrays of RFC 8746, which encode an array of
+/// numbers as a byte string of their in-memory representation, tagged with the
+/// type and byte order of the elements.
+class TypedArray
+{
+public:
+    /// @brief Set in the tag of an array of multi-byte elements if they are
+    /// little-endian.
+    static constexpr uint8_t littleEndian = 1 << 2;
+
+    /// @brief Whether arrays of a type can be encoded as typed arrays.
+    template <typename T>
+    static constexpr bool isElement = std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>
+                                      || std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>
+                                      || std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>
+                                      || std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>
+                                      || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+    /// @brief Gets the tag of an array of elements in the byte order of this
+    /// machine, so that the array can be copied as is.
+    template <typename T>
+        requires isElement<T>
+    static constexpr uint8_t tag()
+    {
+        // the low two bits encode the element size as a power of two
+        uint8_t size = std::bit_width(sizeof(T)) - 1;
+        uint8_t order = sizeof(T) > 1 && std::endian::native == std::endian::little ? littleEndian : 0;
+        if constexpr (std::is_floating_point_v<T>) {
+            // floats start from half precision, so are one size class lower
+            return 0x50 | order | (size - 1);
+        }
+        else {
+            return 0x40 | (std::is_signed_v<T> ? 0x08 : 0) | order | size;
+        }
+    }
+
+    /// @brief Whether a tag is that of a typed array of integers or floats.
+    static constexpr bool isTag(uint64_t value)
+    {
+        return value >= 0x40 && value <= 0x57 && value != 0x4C;
+    }
+
+    /// @brief Whether a tag is that of an array of the same elements as another,
+    /// in either byte order.
+    /// @param value The tag which was decoded.
+    /// @param expected The tag of the array being decoded into, from @ref tag.
+    static constexpr bool matches(uint64_t value, uint8_t expected)
+    {
+        if (expected == 0x40 && value == 0x44) {
+            // clamped arithmetic is irrelevant once decoded
+            return true;
+        }
+        if ((expected & 0x13) == 0) {
+            // single-byte integers have no byte order
+            return value == expected;
+        }
+        return (value & ~littleEndian) == (expected & ~littleEndian);
+    }
+
+    /// @brief Copies elements between typed arrays of different byte order.
+    /// @param dest Where to copy the elements to.
+    /// @param src The elements to copy.
+    /// @param elementSize The size of each element, which is 2, 4 or 8.
+    /// @param count The number of elements.
+    static void copyReversed(uint8_t *dest, const uint8_t *src, size_t elementSize, size_t count)
+    {
+        switch (elementSize) {
+            case 2:
+                copyReversed<uint16_t>(dest, src, count);
+                break;
+            case 4:
+                copyReversed<uint32_t>(dest, src, count);
+                break;
+            case 8:
+                copyReversed<uint64_t>(dest, src, count);
+                break;
+            default:
+                memcpy(dest, src, elementSize * count);
+                break;
+        }
+    }
+
+private:
+    template <typename U> static void copyReversed(uint8_t *dest, const uint8_t *src, size_t count)
+    {
+        // simple enough for the compiler to vectorise as a byte shuffle
+        for (size_t i = 0; i < count; i++) {
+            U element;
+            memcpy(&element, src + i * sizeof(U), sizeof(U));
+            if constexpr (sizeof(U) == 2) {
+                element = __builtin_bswap16(element);
+            }
+            else if constexpr (sizeof(U) == 4) {
+                element = __builtin_bswap32(element);
+            }
+            else {
+                element = __builtin_bswap64(element);
+            }
+            memcpy(dest + i * sizeof(U), &element, sizeof(U));
+        }
+    }
+};
+
+} // namespace ThingSet
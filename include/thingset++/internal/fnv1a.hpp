@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace ThingSet {
+
+/// @brief Calculates the 32-bit FNV-1a hash of a string.
+/// @param value The string to hash.
+/// @param hash The initial hash value; pass a previous result to continue hashing.
+constexpr uint32_t fnv1a(std::string_view value, uint32_t hash = 2166136261u)
+{
+    for (char c : value) {
+        hash ^= (uint8_t)c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace ThingSet
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <type_traits>
+#ifdef ENABLE_CONCURRENT_REGISTRY
+#include <atomic>
+#endif
+
+namespace ThingSet {
+
+// In concurrent mode, registry state may be read by several threads while a
+// single writer modifies it, so such fields are accessed atomically;
+// otherwise, these are plain loads and stores
+
+/// @brief Load a field which may be modified concurrently.
+template <typename T>
+inline T sharedLoad(const T &field)
+{
+#ifdef ENABLE_CONCURRENT_REGISTRY
+    return std::atomic_ref<T>(const_cast<T &>(field)).load(std::memory_order_acquire);
+#else
+    return field;
+#endif
+}
+
+/// @brief Store to a field which may be read concurrently.
+template <typename T>
+inline void sharedStore(T &field, std::type_identity_t<T> value)
+{
+#ifdef ENABLE_CONCURRENT_REGISTRY
+    std::atomic_ref<T>(field).store(value, std::memory_order_release);
+#else
+    field = value;
+#endif
+}
+
+} // namespace ThingSet
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+#ifndef CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_SMALL_SIZE
+#define CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_SMALL_SIZE 256
+#endif
+#ifndef CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_SMALL_COUNT
+#define CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_SMALL_COUNT 32
+#endif
+#ifndef CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_MEDIUM_SIZE
+#define CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_MEDIUM_SIZE 1024
+#endif
+#ifndef CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_MEDIUM_COUNT
+#define CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_MEDIUM_COUNT 16
+#endif
+#ifndef CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_LARGE_SIZE
+#define CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_LARGE_SIZE 16384
+#endif
+#ifndef CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_LARGE_COUNT
+#define CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_LARGE_COUNT 4
+#endif
+
+namespace ThingSet::Ip {
+
+/// @brief Occupancy of one size class of a buffer pool.
+struct BufferPoolMetrics
+{
+    /// @brief The size of each buffer in the class.
+    size_t size;
+    /// @brief The number of buffers in the class.
+    size_t count;
+    /// @brief The number of buffers currently leased.
+    size_t leased;
+    /// @brief The greatest number of buffers leased at once.
+    size_t peakLeased;
+    /// @brief The number of leases for which this was the smallest class large
+    /// enough, but which could not be granted because every buffer in it, and in
+    /// every larger class, was leased.
+    size_t failedLeases;
+};
+
+class BufferPool;
+
+/// @brief A buffer leased from a pool, which is returned to the pool when the
+/// lease is destroyed.
+class BufferLease
+{
+private:
+    BufferPool *_pool;
+    uint8_t *_data;
+    size_t _size;
+
+public:
+    BufferLease();
+    BufferLease(BufferPool *pool, uint8_t *data, size_t size);
+    BufferLease(BufferLease &&other) noexcept;
+    BufferLease &operator=(BufferLease &&other) noexcept;
+    BufferLease(const BufferLease &) = delete;
+    BufferLease &operator=(const BufferLease &) = delete;
+    ~BufferLease();
+
+    uint8_t *data() const
+    {
+        return _data;
+    }
+
+    /// @brief Gets the size of the buffer, which may be larger than requested.
+    size_t size() const
+    {
+        return _size;
+    }
+
+    /// @brief Whether the lease holds a buffer.
+    explicit operator bool() const
+    {
+        return _data != nullptr;
+    }
+
+    /// @brief Returns the buffer to the pool before the lease is destroyed.
+    void release();
+};
+
+/// @brief Source of buffers for transports, which lease them only while they
+/// are handling a message, so that idle connections hold none.
+class BufferPool
+{
+    friend class BufferLease;
+
+public:
+    virtual ~BufferPool() = default;
+
+    /// @brief Leases a buffer.
+    /// @param size The least size of the buffer.
+    /// @return The lease, which holds no buffer if none large enough is free.
+    BufferLease lease(size_t size);
+
+    /// @brief Gets the size of the largest buffer which can be leased.
+    virtual size_t getMaximumSize() const = 0;
+
+    /// @brief Gets the number of size classes, in order of increasing size.
+    virtual size_t getClassCount() const = 0;
+
+    /// @brief Gets the occupancy of a size class.
+    virtual BufferPoolMetrics getMetrics(size_t sizeClass) const = 0;
+
+    /// @brief Gets the pool which transports use unless they are given another,
+    /// whose classes are set by CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_*.
+    static BufferPool &getDefault();
+
+protected:
+    /// @brief Takes a buffer from the pool.
+    /// @param size The least size of the buffer.
+    /// @param actualSize The size of the buffer taken.
+    /// @return The buffer, or null if none large enough is free.
+    virtual uint8_t *acquire(size_t size, size_t &actualSize) = 0;
+    virtual void release(uint8_t *buffer) = 0;
+};
+
+/// @brief Lock-free free list of equally sized buffers in caller-owned storage.
+/// Free buffers are linked by index, and the head carries a counter which
+/// changes with every update, so that a buffer which is taken and returned
+/// between a reader loading the head and swapping it cannot corrupt the list.
+class BufferFreeList
+{
+private:
+    static const uint32_t none = UINT32_MAX;
+
+    uint8_t *_storage;
+    std::atomic<uint32_t> *_next;
+    const size_t _size;
+    const size_t _count;
+    // the index of the first free buffer in the low half, and the counter in the high
+    std::atomic<uint64_t> _head;
+    std::atomic<size_t> _leased;
+    std::atomic<size_t> _peakLeased;
+    std::atomic<size_t> _failedLeases;
+
+public:
+    BufferFreeList(uint8_t *storage, std::atomic<uint32_t> *next, size_t size, size_t count);
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    /// @brief Takes a buffer, or returns null if all are leased.
+    uint8_t *acquire();
+    void release(uint8_t *buffer);
+    bool owns(const uint8_t *buffer) const;
+    void recordFailure();
+    BufferPoolMetrics getMetrics() const;
+};
+
+/// @brief The size and number of the buffers in one class of a
+/// @ref SizeClassedBufferPool.
+template <size_t Size, size_t Count> struct BufferClass
+{
+    static_assert(Count > 0 && Count < UINT32_MAX, "A buffer class needs at least one buffer");
+
+    alignas(std::max_align_t) std::array<uint8_t, Size * Count> storage;
+    std::array<std::atomic<uint32_t>, Count> next;
+    BufferFreeList list;
+
+    BufferClass() : list(storage.data(), next.data(), Size, Count)
+    {}
+};
+
+/// @brief Buffer pool whose buffers are divided into classes of fixed sizes,
+/// each backed by a lock-free free list in static storage. A lease is granted
+/// from the smallest class which is large enough and has a free buffer.
+/// @tparam Classes The classes, as @ref BufferClass, in order of increasing size.
+template <typename... Classes> class SizeClassedBufferPool : public BufferPool
+{
+private:
+    std::tuple<Classes...> _classes;
+    std::array<BufferFreeList *, sizeof...(Classes)> _lists;
+
+public:
+    SizeClassedBufferPool() : _lists(std::apply([](auto &...c) { return std::array{ &c.list... }; }, _classes))
+    {}
+
+    size_t getMaximumSize() const override
+    {
+        return _lists.back()->size();
+    }
+
+    size_t getClassCount() const override
+    {
+        return _lists.size();
+    }
+
+    BufferPoolMetrics getMetrics(size_t sizeClass) const override
+    {
+        return _lists[sizeClass]->getMetrics();
+    }
+
+protected:
+    uint8_t *acquire(size_t size, size_t &actualSize) override
+    {
+        BufferFreeList *fit = nullptr;
+        for (BufferFreeList *list : _lists) {
+            if (list->size() < size) {
+                continue;
+            }
+            if (fit == nullptr) {
+                fit = list;
+            }
+            if (uint8_t *buffer = list->acquire()) {
+                actualSize = list->size();
+                return buffer;
+            }
+        }
+        if (fit != nullptr) {
+            fit->recordFailure();
+        }
+        return nullptr;
+    }
+
+    void release(uint8_t *buffer) override
+    {
+        for (BufferFreeList *list : _lists) {
+            if (list->owns(buffer)) {
+                list->release(buffer);
+                return;
+            }
+        }
+    }
+};
+
+} // namespace ThingSet::Ip
@@ -5,12 +5,23 @@
  */
 #pragma once
 
+#include "thingset++/ip/BufferPool.hpp"
 #include "thingset++/ip/ThingSetIpServerTransport.hpp"
 #include <asio/awaitable.hpp>
 #include <asio/signal_set.hpp>
 #include <asio/ip/tcp.hpp>
 #include <asio/ip/udp.hpp>
 
+#ifndef THINGSET_PLUS_PLUS_ASYNC_SOCKET_SERVER_TX_BUFFER_SIZE
+#define THINGSET_PLUS_PLUS_ASYNC_SOCKET_SERVER_TX_BUFFER_SIZE 1024
+#endif
+#ifndef THINGSET_PLUS_PLUS_ASYNC_SOCKET_SERVER_RX_BUFFER_SIZE
+#define THINGSET_PLUS_PLUS_ASYNC_SOCKET_SERVER_RX_BUFFER_SIZE 1024
+#endif
+#ifndef THINGSET_PLUS_PLUS_ASYNC_SOCKET_SERVER_SEND_TIMEOUT_MS
+#define THINGSET_PLUS_PLUS_ASYNC_SOCKET_SERVER_SEND_TIMEOUT_MS 1000
+#endif
+
 namespace ThingSet::Ip::Async {
 
 class ThingSetAsyncSocketServerTransport : public ThingSetIpServerTransport<asio::ip::tcp::endpoint>
@@ -21,6 +32,9 @@ private:
     asio::ip::address_v4 _bindAddress;
     asio::ip::address_v4 _broadcastAddress;
     asio::signal_set _signals;
+    Delegate<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t, ThingSetResponseWriter)>
+        _streamingCallback;
+    BufferPool *_bufferPool;
 
 public:
     ThingSetAsyncSocketServerTransport(asio::io_context &ioContext);
@@ -28,14 +42,22 @@ public:
     ThingSetAsyncSocketServerTransport(asio::io_context &ioContext, const std::string &bindInterface);
     ~ThingSetAsyncSocketServerTransport();
 
-    bool listen(std::function<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback) override;
+    bool listen(Delegate<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback) override;
+    bool listen(Delegate<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback,
+                Delegate<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t,
+                             ThingSetResponseWriter)>
+                    streamingCallback) override;
 
     bool publish(uint8_t *buffer, size_t len) override;
 
+    /// @brief Sets the pool from which request and response buffers are leased
+    /// while each request is handled. Must be called before @ref listen.
+    void setBufferPool(BufferPool &pool);
+
 private:
     asio::awaitable<void> handle(asio::ip::tcp::socket socket,
-                                 std::function<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback);
-    asio::awaitable<void> listener(std::function<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback);
+                                 Delegate<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback);
+    asio::awaitable<void> listener(Delegate<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback);
 };
 
 } // namespace ThingSet::Ip::Async
\ No newline at end of file
@@ -23,10 +23,10 @@ public:
     ThingSetAsyncSocketSubscriptionTransport(asio::io_context &ioContext);
     ~ThingSetAsyncSocketSubscriptionTransport();
 
-    bool subscribe(std::function<void(const asio::ip::udp::endpoint &, ThingSetBinaryDecoder &)> callback) override;
+    bool subscribe(Delegate<void(const asio::ip::udp::endpoint &, ThingSetBinaryDecoder &)> callback) override;
 
 private:
-    asio::awaitable<void> listener(std::function<void(const asio::ip::udp::endpoint &, ThingSetBinaryDecoder &)> callback);
+    asio::awaitable<void> listener(Delegate<void(const asio::ip::udp::endpoint &, ThingSetBinaryDecoder &)> callback);
 };
 
 } // namespace ThingSet::Ip::Async
\ No newline at end of file
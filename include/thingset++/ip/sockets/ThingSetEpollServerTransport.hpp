@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "thingset++/ip/sockets/ThingSetSocketServerTransport.hpp"
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+namespace ThingSet::Ip::Sockets {
+
+/// @brief Server transport using POSIX sockets which accepts connections and
+/// handles requests on a single thread waiting on epoll. Unlike
+/// @ref ThingSetSocketServerTransport, it serves any number of clients, answers
+/// new connections without waiting for a poll to time out, and uses no CPU
+/// while idle. Requests are handled one at a time on that thread, so the
+/// worker count is ignored. Linux only.
+class ThingSetEpollServerTransport : public _ThingSetSocketServerTransport
+{
+private:
+    std::thread _eventThread;
+    int _epollHandle;
+    // an eventfd which is signalled to stop the event thread
+    int _stopHandle;
+    std::unordered_set<int> _connections;
+
+public:
+    ThingSetEpollServerTransport();
+    ThingSetEpollServerTransport(const std::string &interface);
+    ~ThingSetEpollServerTransport();
+
+protected:
+    void startThreads() override;
+
+private:
+    ThingSetEpollServerTransport(const std::pair<in_addr, in_addr> &ipAddressAndSubnet);
+    void runEventLoop();
+    void acceptConnections();
+    void closeConnection(int socketHandle);
+};
+
+} // namespace ThingSet::Ip::Sockets
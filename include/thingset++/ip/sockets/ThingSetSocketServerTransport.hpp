@@ -5,8 +5,10 @@
  */
 #pragma once
 
+#include "thingset++/ip/BufferPool.hpp"
 #include "thingset++/ip/ThingSetIpServerTransport.hpp"
 #include "thingset++/ip/sockets/SocketEndpoint.hpp"
+#include <atomic>
 #include <cstdint>
 #include <cstdio>
 #ifdef __ZEPHYR__
@@ -16,7 +18,10 @@
 #include <zephyr/posix/poll.h>
 #else
 #include <poll.h>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
+#include <vector>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #endif // __ZEPHYR__
@@ -25,6 +30,7 @@
 // Use Zephyr Kconfig values
 #define THINGSET_PLUS_PLUS_SOCKET_SERVER_TX_BUFFER_SIZE CONFIG_THINGSET_PLUS_PLUS_SOCKET_SERVER_TX_BUFFER_SIZE
 #define THINGSET_PLUS_PLUS_SOCKET_SERVER_RX_BUFFER_SIZE CONFIG_THINGSET_PLUS_PLUS_SOCKET_SERVER_RX_BUFFER_SIZE
+#define THINGSET_PLUS_PLUS_SOCKET_SERVER_SEND_TIMEOUT_MS CONFIG_THINGSET_PLUS_PLUS_SOCKET_SERVER_SEND_TIMEOUT_MS
 #else
 // Use CMake-defined values (set by target_compile_definitions in CMakeLists.txt)
 // If not building with CMake, fall back to defaults
@@ -34,6 +40,9 @@
 #ifndef THINGSET_PLUS_PLUS_SOCKET_SERVER_RX_BUFFER_SIZE
 #define THINGSET_PLUS_PLUS_SOCKET_SERVER_RX_BUFFER_SIZE 1024
 #endif
+#ifndef THINGSET_PLUS_PLUS_SOCKET_SERVER_SEND_TIMEOUT_MS
+#define THINGSET_PLUS_PLUS_SOCKET_SERVER_SEND_TIMEOUT_MS 1000
+#endif
 #endif // #ifdef __ZEPHYR__
 
 #define THINGSET_SERVER_MAX_CLIENTS 8
@@ -50,33 +59,114 @@ private:
         PollDescriptor();
     };
 
-    std::array<PollDescriptor, THINGSET_SERVER_MAX_CLIENTS> _socketDescriptors;
+    // one for each client, followed by one which wakes the handler when a
+    // connection is handed to it; except on Zephyr, only the handler thread
+    // changes these, as poll reads them
+    std::array<PollDescriptor, THINGSET_SERVER_MAX_CLIENTS + 1> _socketDescriptors;
 
     sockaddr_in _publishAddress;
     sockaddr_in _listenAddress;
     sockaddr_in _broadcastAddress;
     int _publishSocketHandle;
+
+protected:
     int _listenSocketHandle;
-    std::function<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t)> _callback;
-    uint8_t _rxBuf[THINGSET_PLUS_PLUS_SOCKET_SERVER_RX_BUFFER_SIZE];
-    uint8_t _txBuf[THINGSET_PLUS_PLUS_SOCKET_SERVER_TX_BUFFER_SIZE];
+
+private:
+    Delegate<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t)> _callback;
+    Delegate<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t, ThingSetResponseWriter)> _streamingCallback;
+    BufferPool *_bufferPool;
+#ifndef __ZEPHYR__
+    /// @brief A connection handed between threads.
+    struct Handover
+    {
+        size_t slot;
+        // the descriptor, or -1 if the connection has been closed
+        int fd;
+    };
+
+    size_t _workerCount;
+    std::vector<std::thread> _workers;
+    bool _runWorkers;
+    // connections with requests waiting for a worker, in a ring
+    std::array<Handover, THINGSET_SERVER_MAX_CLIENTS> _ready;
+    size_t _readyStart;
+    size_t _readyCount;
+    // connections which workers have finished with, for the handler to poll
+    // again, or free the slots of
+    std::array<Handover, THINGSET_SERVER_MAX_CLIENTS> _finished;
+    size_t _finishedCount;
+    // descriptors of connections accepted, for the handler to assign slots to
+    std::array<int, THINGSET_SERVER_MAX_CLIENTS> _accepted;
+    size_t _acceptedCount;
+    // guards all of the above
+    std::mutex _readyLock;
+    std::condition_variable _readyCondition;
+    int _wakePipe[2];
+#endif // __ZEPHYR__
 
 protected:
-    bool _runHandler;
-    bool _runAcceptor;
+    std::atomic<bool> _runHandler;
+    std::atomic<bool> _runAcceptor;
 
     _ThingSetSocketServerTransport(const std::pair<in_addr, in_addr> &ipAddressAndSubnet);
 
 public:
     ~_ThingSetSocketServerTransport();
 
-    bool listen(std::function<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback) override;
+    bool listen(Delegate<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback) override;
+    bool listen(Delegate<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback,
+                Delegate<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t, ThingSetResponseWriter)>
+                    streamingCallback) override;
     bool publish(uint8_t *buffer, size_t len) override;
 
+    /// @brief Sets the pool from which request and response buffers are leased
+    /// while each request is handled. Must be called before @ref listen.
+    void setBufferPool(BufferPool &pool);
+
+#ifndef __ZEPHYR__
+    /// @brief Sets the number of worker threads which handle requests. If zero,
+    /// the default, requests are handled on the thread which polls connections,
+    /// one at a time. Otherwise, that thread hands each ready connection to a
+    /// worker, and does not poll it again until the worker has sent the response,
+    /// so requests on one connection are still handled in order. Must be called
+    /// before @ref listen.
+    ///
+    /// Workers look nodes up and encode them at the same time, so need
+    /// ENABLE_CONCURRENT_REGISTRY, without which the registry and the caches of
+    /// its nodes may only be used by one thread at a time. The values of the
+    /// nodes must also be safe to access from several threads at once.
+    /// @return False if there are to be workers, but the registry is not
+    /// concurrent, in which case there are none.
+    bool setWorkerCount(size_t count);
+#endif // __ZEPHYR__
+
 protected:
     virtual void startThreads() = 0;
     void runAcceptor();
     void runHandler();
+#ifndef __ZEPHYR__
+    void startWorkers();
+    void stopWorkers();
+#endif // __ZEPHYR__
+
+    /// @brief Receives a request on a connection and sends the response.
+    /// @return False if the connection should be closed, otherwise true.
+    bool serve(int socketHandle);
+
+private:
+#ifndef __ZEPHYR__
+    void dispatch(size_t slot);
+    void runWorker();
+    void handOver(int fd);
+    void takeHandovers();
+#endif // __ZEPHYR__
+
+    /// @brief Receives a request into a buffer leased from the pool, moving it to
+    /// larger buffers as it fills, up to THINGSET_PLUS_PLUS_SOCKET_SERVER_RX_BUFFER_SIZE.
+    /// @return The length of the request, 0 if the connection has been closed,
+    /// or a negative value on error.
+    int receive(int socketHandle, BufferLease &request);
 };
 
 class ThingSetSocketServerTransport : public _ThingSetSocketServerTransport
@@ -23,13 +23,13 @@ class _ThingSetSocketSubscriptionTransport : public ThingSetMultiFrameSubscripti
 private:
     sockaddr_in _listenAddress;
     int _listenSocketHandle;
-    std::function<void(const SocketEndpoint &, ThingSetBinaryDecoder &)> _callback;
+    Delegate<void(const SocketEndpoint &, ThingSetBinaryDecoder &)> _callback;
 
 protected:
     _ThingSetSocketSubscriptionTransport();
     ~_ThingSetSocketSubscriptionTransport();
 
-    bool subscribe(std::function<void(const SocketEndpoint &, ThingSetBinaryDecoder &)> callback) override;
+    bool subscribe(Delegate<void(const SocketEndpoint &, ThingSetBinaryDecoder &)> callback) override;
 
     void runListener();
     virtual void startThread() = 0;
@@ -18,7 +18,7 @@ struct EmptyIdentifier {
 class ThingSetZephyrShellServerTransport : public ThingSetServerTransport<EmptyIdentifier, CONFIG_SHELL_CMD_BUFF_SIZE, StreamingZephyrShellThingSetBinaryEncoder>
 {
 private:
-    std::function<int(const EmptyIdentifier &, uint8_t *, size_t, uint8_t *, size_t)> _callback;
+    Delegate<int(const EmptyIdentifier &, uint8_t *, size_t, uint8_t *, size_t)> _callback;
 
     ThingSetZephyrShellServerTransport();
     ThingSetZephyrShellServerTransport(const ThingSetZephyrShellServerTransport &) = delete;
@@ -26,7 +26,7 @@ private:
 
 public:
     StreamingZephyrShellThingSetBinaryEncoder getPublishingEncoder(bool enhanced) override;
-    bool listen(std::function<int(const EmptyIdentifier &, uint8_t *, size_t, uint8_t *, size_t)> callback) override;
+    bool listen(Delegate<int(const EmptyIdentifier &, uint8_t *, size_t, uint8_t *, size_t)> callback) override;
 
     static int _onShellCommandExecuted(const shell *shell, size_t argc, char **argv);
 
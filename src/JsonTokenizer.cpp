@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+// jsmn decides malformed input, so keep a private copy of it
+#define JSMN_STATIC
+#include "thingset++/internal/jsmn.h"
+
+#include "thingset++/internal/JsonTokenizer.hpp"
+#include <bit>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace ThingSet {
+
+static const size_t BlockSize = 64;
+
+/// @brief The characters in a block which matter to the tokenizer, with one
+/// bit for each byte.
+struct CharacterClasses
+{
+    uint64_t quote;
+    uint64_t backslash;
+    // { or [
+    uint64_t open;
+    // } or ]
+    uint64_t close;
+    // : or ,
+    uint64_t separator;
+    uint64_t whitespace;
+};
+
+#if defined(__AVX2__) || defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+
+#if defined(__AVX2__)
+using Lane = __m256i;
+static const size_t LaneSize = 32;
+
+static inline Lane load(const uint8_t *bytes)
+{
+    return _mm256_loadu_si256((const __m256i *)bytes);
+}
+
+static inline Lane splat(uint8_t value)
+{
+    return _mm256_set1_epi8((char)value);
+}
+
+static inline Lane equal(Lane a, Lane b)
+{
+    return _mm256_cmpeq_epi8(a, b);
+}
+
+static inline Lane either(Lane a, Lane b)
+{
+    return _mm256_or_si256(a, b);
+}
+
+static inline uint64_t bits(Lane mask)
+{
+    return (uint32_t)_mm256_movemask_epi8(mask);
+}
+#elif defined(__SSE2__)
+using Lane = __m128i;
+static const size_t LaneSize = 16;
+
+static inline Lane load(const uint8_t *bytes)
+{
+    return _mm_loadu_si128((const __m128i *)bytes);
+}
+
+static inline Lane splat(uint8_t value)
+{
+    return _mm_set1_epi8((char)value);
+}
+
+static inline Lane equal(Lane a, Lane b)
+{
+    return _mm_cmpeq_epi8(a, b);
+}
+
+static inline Lane either(Lane a, Lane b)
+{
+    return _mm_or_si128(a, b);
+}
+
+static inline uint64_t bits(Lane mask)
+{
+    return (uint16_t)_mm_movemask_epi8(mask);
+}
+#else
+using Lane = uint8x16_t;
+static const size_t LaneSize = 16;
+
+static inline Lane load(const uint8_t *bytes)
+{
+    return vld1q_u8(bytes);
+}
+
+static inline Lane splat(uint8_t value)
+{
+    return vdupq_n_u8(value);
+}
+
+static inline Lane equal(Lane a, Lane b)
+{
+    return vceqq_u8(a, b);
+}
+
+static inline Lane either(Lane a, Lane b)
+{
+    return vorrq_u8(a, b);
+}
+
+static inline uint64_t bits(Lane mask)
+{
+    // NEON has no movemask, so weight each byte by its bit and add up each half
+    static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    Lane weighted = vandq_u8(mask, vld1q_u8(weights));
+    return vaddv_u8(vget_low_u8(weighted)) | ((uint64_t)vaddv_u8(vget_high_u8(weighted)) << 8);
+}
+#endif
+
+static CharacterClasses classify(const uint8_t *block)
+{
+    CharacterClasses classes = {};
+    for (size_t i = 0; i < BlockSize; i += LaneSize) {
+        Lane c = load(block + i);
+        // setting bit 5 maps [ to { and ] to }, so each pair takes one comparison
+        Lane folded = either(c, splat(0x20));
+        classes.quote |= bits(equal(c, splat('"'))) << i;
+        classes.backslash |= bits(equal(c, splat('\\'))) << i;
+        classes.open |= bits(equal(folded, splat('{'))) << i;
+        classes.close |= bits(equal(folded, splat('}'))) << i;
+        classes.separator |= bits(either(equal(c, splat(':')), equal(c, splat(',')))) << i;
+        classes.whitespace |= bits(either(either(equal(c, splat(' ')), equal(c, splat('\t'))),
+                                          either(equal(c, splat('\n')), equal(c, splat('\r')))))
+                              << i;
+    }
+    return classes;
+}
+
+#else
+
+static CharacterClasses classify(const uint8_t *block)
+{
+    CharacterClasses classes = {};
+    for (size_t i = 0; i < BlockSize; i++) {
+        uint64_t bit = 1ULL << i;
+        switch (block[i]) {
+            case '"':
+                classes.quote |= bit;
+                break;
+            case '\\':
+                classes.backslash |= bit;
+                break;
+            case '{':
+            case '[':
+                classes.open |= bit;
+                break;
+            case '}':
+            case ']':
+                classes.close |= bit;
+                break;
+            case ':':
+            case ',':
+                classes.separator |= bit;
+                break;
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                classes.whitespace |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+    return classes;
+}
+
+#endif
+
+/// @brief Finds the characters which are escaped by a backslash.
+/// @param backslash The backslashes in the block.
+/// @param carry 1 if the first character in the block is escaped; on return,
+/// 1 if the first character in the next block is.
+static uint64_t findEscaped(uint64_t backslash, uint64_t &carry)
+{
+    uint64_t escaped = carry;
+    carry = 0;
+    // an escaped backslash escapes nothing
+    backslash &= ~escaped;
+    while (backslash != 0) {
+        int i = std::countr_zero(backslash);
+        if (i == 63) {
+            carry = 1;
+            break;
+        }
+        escaped |= 2ULL << i;
+        backslash &= ~(3ULL << i);
+    }
+    return escaped;
+}
+
+/// @brief Sets each bit to the parity of the bits at or below it, which turns
+/// a mask of quotes into a mask of the strings between them.
+static uint64_t prefixXor(uint64_t value)
+{
+    value ^= value << 1;
+    value ^= value << 2;
+    value ^= value << 4;
+    value ^= value << 8;
+    value ^= value << 16;
+    value ^= value << 32;
+    return value;
+}
+
+/// @brief Checks that each escape in a string is one which JSON allows.
+static bool hasValidEscapes(const char *json, size_t start, size_t end)
+{
+    for (size_t i = start; i < end; i++) {
+        if (json[i] != '\\') {
+            continue;
+        }
+        switch (json[++i]) {
+            case '"':
+            case '/':
+            case '\\':
+            case 'b':
+            case 'f':
+            case 'r':
+            case 'n':
+            case 't':
+                break;
+            case 'u':
+                for (int j = 0; j < 4; j++) {
+                    // as in jsmn, the closing quote cannot stand in for a digit
+                    if (i + 1 >= end) {
+                        return false;
+                    }
+                    char c = json[++i];
+                    if (!((c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f'))) {
+                        return false;
+                    }
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+// while an object or array is open, its end holds the index of the one which
+// encloses it, in such a way that a top-level one has an end of -1, as in jsmn
+static inline int encodeEnclosing(int index)
+{
+    return -2 - index;
+}
+
+static inline int decodeEnclosing(int end)
+{
+    return -2 - end;
+}
+
+JsonTokenizer::JsonTokenizer()
+    : _position(0), _structurals(0), _classified(false), _fallenBack(false), _escaped(0), _inString(0),
+      _inPrimitive(0), _tokenCount(0), _super(-1), _open(-1), _stringStart(noString)
+{}
+
+unsigned int JsonTokenizer::getTokenCount() const
+{
+    return _tokenCount;
+}
+
+int JsonTokenizer::parse(const char *json, size_t length, jsmntok *tokens, unsigned int capacity)
+{
+    const char *terminator = (const char *)memchr(json, '\0', length);
+    if (terminator != nullptr) {
+        length = terminator - json;
+    }
+
+    if (_fallenBack) {
+        return fallBack(json, length, tokens, capacity);
+    }
+
+    for (; _position < length; _position += BlockSize) {
+        if (!_classified) {
+            const uint8_t *block = (const uint8_t *)json + _position;
+            uint8_t padded[BlockSize];
+            if (length - _position < BlockSize) {
+                // pad the last block with whitespace, which produces no tokens
+                memset(padded, ' ', BlockSize);
+                memcpy(padded, block, length - _position);
+                block = padded;
+            }
+
+            CharacterClasses classes = classify(block);
+            uint64_t quotes = classes.quote & ~findEscaped(classes.backslash, _escaped);
+            // includes opening quotes but not closing ones
+            uint64_t inString = prefixXor(quotes) ^ _inString;
+            uint64_t operators = (classes.open | classes.close | classes.separator) & ~inString;
+            uint64_t primitive =
+                ~(classes.open | classes.close | classes.separator | classes.whitespace | quotes | inString);
+            uint64_t primitiveStarts = primitive & ~((primitive << 1) | _inPrimitive);
+
+            _inString = (uint64_t)((int64_t)inString >> 63);
+            _inPrimitive = primitive >> 63;
+            _structurals = operators | quotes | primitiveStarts;
+            _classified = true;
+        }
+
+        // a character is only consumed once visited, so that parsing can
+        // resume from it if it needs a token which does not fit
+        uint64_t structurals = _structurals;
+        while (structurals != 0) {
+            size_t offset = _position + std::countr_zero(structurals);
+            int result = visit(json, length, offset, tokens, capacity);
+            if (result == JSMN_ERROR_NOMEM) {
+                _structurals = structurals;
+                return result;
+            }
+            else if (result < 0) {
+                return fallBack(json, length, tokens, capacity);
+            }
+            structurals &= structurals - 1;
+        }
+        _classified = false;
+    }
+
+    if (_open != -1 || _stringStart != noString) {
+        return fallBack(json, length, tokens, capacity);
+    }
+    return _tokenCount;
+}
+
+int JsonTokenizer::visit(const char *json, size_t length, size_t offset, jsmntok *tokens, unsigned int capacity)
+{
+    char c = json[offset];
+    switch (c) {
+        case '{':
+        case '[': {
+            jsmntok *token = allocate(tokens, capacity, c == '{' ? JSMN_OBJECT : JSMN_ARRAY, offset, 0);
+            if (token == nullptr) {
+                return JSMN_ERROR_NOMEM;
+            }
+            token->end = encodeEnclosing(_open);
+            _open = _super = _tokenCount - 1;
+            break;
+        }
+        case '}':
+        case ']': {
+            if (_open == -1) {
+                return JSMN_ERROR_INVAL;
+            }
+            jsmntok *token = &tokens[_open];
+            if (token->type != (c == '}' ? JSMN_OBJECT : JSMN_ARRAY)) {
+                return JSMN_ERROR_INVAL;
+            }
+            _open = _super = decodeEnclosing(token->end);
+            token->end = offset + 1;
+            break;
+        }
+        case '"':
+            if (_stringStart == noString) {
+                _stringStart = offset;
+            }
+            else {
+                if (memchr(&json[_stringStart + 1], '\\', offset - _stringStart - 1) != nullptr
+                    && !hasValidEscapes(json, _stringStart + 1, offset)) {
+                    return JSMN_ERROR_INVAL;
+                }
+                if (allocate(tokens, capacity, JSMN_STRING, _stringStart + 1, offset) == nullptr) {
+                    return JSMN_ERROR_NOMEM;
+                }
+                _stringStart = noString;
+            }
+            break;
+        case ':':
+            _super = _tokenCount - 1;
+            break;
+        case ',':
+            // as in jsmn, outside any object or array the token stays put
+            if (_super != -1 && _open != -1 && tokens[_super].type != JSMN_ARRAY
+                && tokens[_super].type != JSMN_OBJECT) {
+                _super = _open;
+            }
+            break;
+        default: {
+            // a primitive, which ends at whitespace or the next operator; jsmn
+            // carries one on through quotes and brackets, so leave those to it
+            size_t end = offset;
+            for (; end < length; end++) {
+                char p = json[end];
+                if (p == ' ' || p == '\t' || p == '\r' || p == '\n' || p == ',' || p == ']' || p == '}' || p == ':') {
+                    break;
+                }
+                if (p < 32 || p >= 127 || p == '"' || p == '{' || p == '[') {
+                    return JSMN_ERROR_INVAL;
+                }
+            }
+            if (allocate(tokens, capacity, JSMN_PRIMITIVE, offset, end) == nullptr) {
+                return JSMN_ERROR_NOMEM;
+            }
+            break;
+        }
+    }
+    return 0;
+}
+
+jsmntok *JsonTokenizer::allocate(jsmntok *tokens, unsigned int capacity, jsmntype_t type, size_t start, size_t end)
+{
+    if (_tokenCount >= capacity) {
+        return nullptr;
+    }
+    if (_super != -1) {
+        tokens[_super].size++;
+    }
+    jsmntok *token = &tokens[_tokenCount++];
+    token->type = type;
+    token->start = start;
+    token->end = end;
+    token->size = 0;
+    return token;
+}
+
+int JsonTokenizer::fallBack(const char *json, size_t length, jsmntok *tokens, unsigned int capacity)
+{
+    // jsmn starts again from the beginning each time, which only costs
+    // anything when the input is malformed
+    _fallenBack = true;
+    jsmn_parser parser;
+    jsmn_init(&parser);
+    int result = jsmn_parse(&parser, json, length, tokens, capacity);
+    _tokenCount = parser.toknext;
+    return result;
+}
+
+} // namespace ThingSet
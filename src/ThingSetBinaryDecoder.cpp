@@ -44,6 +44,16 @@ bool ThingSetBinaryDecoder::decode(std::string *value)
     return false;
 }
 
+bool ThingSetBinaryDecoder::decode(std::string_view *value)
+{
+    zcbor_string zstring;
+    if (zcbor_tstr_decode(this->getState(), &zstring)) {
+        *value = std::string_view((const char *)zstring.value, zstring.len);
+        return true;
+    }
+    return false;
+}
+
 bool ThingSetBinaryDecoder::decode(char *value, size_t size)
 {
     zcbor_string zstring;
@@ -62,7 +72,16 @@ bool ThingSetBinaryDecoder::decode(float *value)
 
 bool ThingSetBinaryDecoder::decode(double *value)
 {
-    return zcbor_float64_decode(this->getState(), value);
+    if (zcbor_float64_decode(this->getState(), value)) {
+        return true;
+    }
+    // encoders may write doubles in half or single precision if that is exact
+    float single;
+    if (zcbor_float16_32_decode(this->getState(), &single)) {
+        *value = single;
+        return true;
+    }
+    return false;
 }
 
 bool ThingSetBinaryDecoder::decode(bool *value)
@@ -170,14 +189,20 @@ bool ThingSetBinaryDecoder::decodeMapEnd()
     return zcbor_map_end_decode(getState());
 }
 
+// a list or map of indefinite length ends with a break, which cannot start any item
+static bool isAtBreak(const zcbor_state_t *state)
+{
+    return state->payload < state->payload_end && *state->payload == 0xFF;
+}
+
 bool ThingSetBinaryDecoder::isInMap() const
 {
-    return getState()->elem_count != 0;
+    return getState()->elem_count != 0 && !isAtBreak(getState());
 }
 
 bool ThingSetBinaryDecoder::isInList() const
 {
-    return getState()->elem_count != 0;
+    return getState()->elem_count != 0 && !isAtBreak(getState());
 }
 
 bool ThingSetBinaryDecoder::ensureListSize(const size_t size, size_t &elementCount)
@@ -201,6 +226,43 @@ bool ThingSetBinaryDecoder::ensureListSize(const size_t size, size_t &elementCou
     return true;
 }
 
+bool ThingSetBinaryDecoder::peekTypedArray()
+{
+    // typed array tags all take a single byte after the initial byte
+    const zcbor_state_t *state = getState();
+    return state->payload_end - state->payload >= 2 && state->payload[0] == 0xD8
+           && TypedArray::isTag(state->payload[1]);
+}
+
+bool ThingSetBinaryDecoder::decodeTypedArray(const uint8_t tag, uint8_t *buffer, const size_t elementSize,
+                                             const size_t size)
+{
+    zcbor_state_t *state = getState();
+    const uint8_t *start = state->payload;
+    size_t elementCount = state->elem_count;
+    uint32_t decodedTag;
+    zcbor_string bytes;
+    if (zcbor_tag_decode(state, &decodedTag) && TypedArray::matches(decodedTag, tag)
+        && zcbor_bstr_decode(state, &bytes) && bytes.len % elementSize == 0) {
+        size_t count = bytes.len / elementSize;
+        if (count == size || (count < size && (_options & ThingSetBinaryDecoderOptions::allowUndersizedArrays))) {
+            if ((decodedTag & TypedArray::littleEndian) == (tag & TypedArray::littleEndian)) {
+                memcpy(buffer, bytes.value, bytes.len);
+            }
+            else {
+                TypedArray::copyReversed(buffer, bytes.value, elementSize, count);
+            }
+            return true;
+        }
+    }
+    if (!getIsForwardOnly()) {
+        // wind back to the start of the array, so that a call to `skip()` will skip it
+        state->payload = start;
+        state->elem_count = elementCount;
+    }
+    return false;
+}
+
 ThingSetEncodedNodeType ThingSetBinaryDecoder::peekType()
 {
     zcbor_major_type_t type = ZCBOR_MAJOR_TYPE(this->getState()->payload[0]);
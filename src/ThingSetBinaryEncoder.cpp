@@ -7,8 +7,6 @@
 
 namespace ThingSet {
 
-static bool encodeListMapEnd(zcbor_state_t *state);
-
 bool ThingSetBinaryEncoder::ensureState()
 {
     return true;
@@ -19,251 +17,234 @@ bool ThingSetBinaryEncoder::getIsForwardOnly() const
     return false;
 }
 
+bool ThingSetBinaryEncoder::encodeShortestFloats() const
+{
+    return false;
+}
+
+CborWriter::Container *ThingSetBinaryEncoder::pushContainer()
+{
+    return nullptr;
+}
+
+CborWriter::Container *ThingSetBinaryEncoder::popContainer()
+{
+    return nullptr;
+}
+
 bool ThingSetBinaryEncoder::encode(const std::string_view &value)
 {
-    return encode(std::string(value));
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(std::string_view &value)
 {
-    return encode(std::string(value));
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const std::string &value)
 {
-    return encode(value.c_str());
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(std::string &value)
 {
-    return encode(value.c_str());
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const char *value)
 {
-#ifdef zcbor_tstr_put_term
-    return this->ensureState() && zcbor_tstr_put_term(this->getState(), value);
-#else
-    return this->ensureState()
-           && zcbor_tstr_put_term(this->getState(), value, BINARY_ENCODER_MAX_NULL_TERMINATED_STRING_LENGTH);
-#endif
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(char *value)
 {
-#ifdef zcbor_tstr_put_term
-    return this->ensureState() && zcbor_tstr_put_term(this->getState(), value);
-#else
-    return this->ensureState()
-           && zcbor_tstr_put_term(this->getState(), value, BINARY_ENCODER_MAX_NULL_TERMINATED_STRING_LENGTH);
-#endif
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const float &value)
 {
-    return this->ensureState() && zcbor_float32_encode(this->getState(), &value);
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const float *value)
 {
-    return this->ensureState() && zcbor_float32_encode(this->getState(), value);
+    return Inline::encode(*value);
 }
 
 bool ThingSetBinaryEncoder::encode(const double &value)
 {
-    return this->ensureState() && zcbor_float64_encode(this->getState(), &value);
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const double *value)
 {
-    return this->ensureState() && zcbor_float64_encode(this->getState(), value);
+    return Inline::encode(*value);
 }
 
 bool ThingSetBinaryEncoder::encode(const bool &value)
 {
-    return this->ensureState() && zcbor_bool_put(this->getState(), value);
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const bool *value)
 {
-    return this->ensureState() && zcbor_bool_put(this->getState(), *value);
+    return Inline::encode(*value);
 }
 
 bool ThingSetBinaryEncoder::encode(const uint8_t &value)
 {
-    return this->ensureState() && zcbor_uint32_put(this->getState(), value);
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const uint8_t *value)
 {
-    return encode(*value);
+    return Inline::encode(*value);
 }
 
 bool ThingSetBinaryEncoder::encode(const uint16_t &value)
 {
-    return this->ensureState() && zcbor_uint32_put(this->getState(), value);
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const uint16_t *value)
 {
-    return encode(*value);
+    return Inline::encode(*value);
 }
 
 bool ThingSetBinaryEncoder::encode(const uint32_t &value)
 {
-    return this->ensureState() && zcbor_uint32_encode(this->getState(), &value);
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const uint32_t *value)
 {
-    return this->ensureState() && zcbor_uint32_encode(this->getState(), value);
+    return Inline::encode(*value);
 }
 
 bool ThingSetBinaryEncoder::encode(const uint64_t &value)
 {
-    return this->ensureState() && zcbor_uint64_encode(this->getState(), &value);
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const uint64_t *value)
 {
-    return this->ensureState() && zcbor_uint64_encode(this->getState(), value);
+    return Inline::encode(*value);
 }
 
 bool ThingSetBinaryEncoder::encode(const int8_t &value)
 {
-    return this->ensureState() && zcbor_int32_put(this->getState(), value);
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const int8_t *value)
 {
-    return this->ensureState() && zcbor_int32_put(this->getState(), *value);
+    return Inline::encode(*value);
 }
 
 bool ThingSetBinaryEncoder::encode(const int16_t &value)
 {
-    return this->ensureState() && zcbor_int32_put(this->getState(), value);
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const int16_t *value)
 {
-    return this->ensureState() && zcbor_int32_put(this->getState(), *value);
+    return Inline::encode(*value);
 }
 
 bool ThingSetBinaryEncoder::encode(const int32_t &value)
 {
-    return this->ensureState() && zcbor_int32_encode(this->getState(), &value);
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const int32_t *value)
 {
-    return this->ensureState() && zcbor_int32_encode(this->getState(), value);
+    return Inline::encode(*value);
 }
 
 bool ThingSetBinaryEncoder::encode(const int64_t &value)
 {
-    return this->ensureState() && zcbor_int64_encode(this->getState(), &value);
+    return Inline::encode(value);
 }
 
 bool ThingSetBinaryEncoder::encode(const int64_t *value)
 {
-    return this->ensureState() && zcbor_int64_encode(this->getState(), value);
+    return Inline::encode(*value);
 }
 
 bool ThingSetBinaryEncoder::encodeNull()
 {
-    return this->ensureState() && zcbor_nil_put(this->getState(), NULL);
+    return Inline::encodeNull();
 }
 
 bool ThingSetBinaryEncoder::encodePreamble()
 {
-    return encodeNull();
+    return Inline::encodePreamble();
 }
 
 bool ThingSetBinaryEncoder::encodeListStart()
 {
-    return encodeListStart(UINT8_MAX);
+    return Inline::encodeListStart();
 }
 
 bool ThingSetBinaryEncoder::encodeListStart(const uint32_t &count)
 {
-    return this->ensureState() && zcbor_list_start_encode(this->getState(), count);
+    return Inline::encodeListStart(count);
 }
 
 bool ThingSetBinaryEncoder::encodeListEnd()
 {
-    return encodeListEnd(UINT8_MAX);
+    return Inline::encodeListEnd();
 }
 
 bool ThingSetBinaryEncoder::encodeListEnd(const uint32_t &count)
 {
-    if (this->getIsForwardOnly()) {
-        return this->ensureState() && encodeListMapEnd(this->getState());
-    }
-    else {
-        return this->ensureState() && zcbor_list_end_encode(this->getState(), count);
-    }
+    return Inline::encodeListEnd(count);
 }
 
 bool ThingSetBinaryEncoder::encodeMapStart()
 {
-    return encodeMapStart(UINT8_MAX);
+    return Inline::encodeMapStart();
 }
 
 bool ThingSetBinaryEncoder::encodeMapStart(const uint32_t &count)
 {
-    return this->ensureState() && zcbor_map_start_encode(this->getState(), count);
+    return Inline::encodeMapStart(count);
 }
 
 bool ThingSetBinaryEncoder::encodeMapEnd()
 {
-    return encodeMapEnd(UINT8_MAX);
+    return Inline::encodeMapEnd();
 }
 
 bool ThingSetBinaryEncoder::encodeMapEnd(const uint32_t &count)
 {
-    if (this->getIsForwardOnly()) {
-        return this->ensureState() && encodeListMapEnd(this->getState());
-    }
-    else {
-        return this->ensureState() && zcbor_map_end_encode(this->getState(), count);
-    }
+    return Inline::encodeMapEnd(count);
 }
 
 bool ThingSetBinaryEncoder::encodeBytes(const uint8_t *buffer, const size_t &size)
 {
-    zcbor_string string = {
-        .value = buffer,
-        .len = size,
-    };
-    return this->ensureState() && zcbor_bstr_encode(this->getState(), &string);
+    return Inline::encodeBytes(buffer, size);
 }
 
-bool ThingSetBinaryEncoder::encodeListSeparator()
+bool ThingSetBinaryEncoder::encodeEncoded(const uint8_t *buffer, size_t size)
 {
-    return true;
+    return Inline::encodeEncoded(buffer, size);
 }
 
-bool ThingSetBinaryEncoder::encodeKeyValuePairSeparator()
+bool ThingSetBinaryEncoder::encodeTypedArray(const uint8_t tag, const uint8_t *buffer, const size_t &length)
+{
+    return Inline::encodeTypedArray(tag, buffer, length);
+}
+
+bool ThingSetBinaryEncoder::encodeListSeparator()
 {
     return true;
 }
 
-/// @brief End a list or map without going back and rewriting the header. Useful in forward-only encoding scenarios.
-/// @param state The encoder state array.
-/// @return True.
-static bool encodeListMapEnd(zcbor_state_t *state)
+bool ThingSetBinaryEncoder::encodeKeyValuePairSeparator()
 {
-    // zcbor_list_map_end_force_encode is broken; it resets the pointer
-    // back to where the list started, rendering it pointless, so we reimplement
-    // it here, passing in the necessary TRANSFER/KEEP_PAYLOAD flag to make it behave
-    // properly
-    auto flags = ZCBOR_FLAG_RESTORE | ZCBOR_FLAG_CONSUME;
-#ifdef ZCBOR_FLAG_TRANSFER_PAYLOAD
-    flags |= ZCBOR_FLAG_TRANSFER_PAYLOAD;
-#else
-    flags |= ZCBOR_FLAG_KEEP_PAYLOAD;
-#endif
-    return zcbor_process_backup(state, flags, ZCBOR_MAX_ELEM_COUNT);
+    return true;
 }
 
-} // namespace ThingSet
\ No newline at end of file
+} // namespace ThingSet
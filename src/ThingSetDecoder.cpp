@@ -7,10 +7,13 @@
 
 namespace ThingSet {
 
-bool ThingSetDecoder::decodeKey(std::optional<uint32_t> &id, std::optional<std::string> &name)
+bool ThingSetDecoder::decodeKey(std::optional<uint32_t> &id, std::optional<std::string_view> &name)
 {
     uint32_t i;
-    std::string n;
+    std::string_view n;
+    // clear the key from the previous pair, which may have been of the other kind
+    id.reset();
+    name.reset();
     if (decode(&i)) {
         id = i;
         return true;
@@ -23,7 +26,7 @@ bool ThingSetDecoder::decodeKey(std::optional<uint32_t> &id, std::optional<std::
     }
 }
 
-bool ThingSetDecoder::decodeList(std::function<bool(size_t)> callback)
+bool ThingSetDecoder::decodeList(FunctionRef<bool(size_t)> callback)
 {
     if (!decodeListStart()) {
         return false;
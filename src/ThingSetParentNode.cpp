@@ -5,8 +5,9 @@
  */
 
 #include "thingset++/ThingSetParentNode.hpp"
+#include "thingset++/ThingSetRegistry.hpp"
+#include "thingset++/internal/shared.hpp"
 #include <cstdint>
-#include <string>
 
 namespace ThingSet {
 
@@ -23,15 +24,68 @@ ThingSetParentNode::ChildIterator ThingSetParentNode::end()
 bool ThingSetParentNode::addChild(ThingSetNode *child)
 {
     _children.push_back(child);
+    sharedStore(_generation, _generation + 1);
     return true;
 }
 
 bool ThingSetParentNode::removeChild(ThingSetNode *child)
 {
     _children.remove(child);
+    sharedStore(_generation, _generation + 1);
     return true;
 }
 
+bool ThingSetParentNode::unlinkChild(ThingSetNode *child)
+{
+    if (!_children.unlink(child)) {
+        return false;
+    }
+    sharedStore(_generation, _generation + 1);
+    return true;
+}
+
+void ThingSetParentNode::getChildCounts(uint32_t &encodable, uint32_t &groups)
+{
+    uint32_t generation = sharedLoad(_generation);
+    uint64_t counts = sharedLoad(_childCounts);
+    if ((uint32_t)(counts >> 32) == generation) {
+        encodable = (uint16_t)counts;
+        groups = (uint16_t)(counts >> 16);
+        return;
+    }
+
+    encodable = 0;
+    groups = 0;
+    void *target;
+    for (ThingSetNode *child : _children) {
+        if (child->tryCastTo(ThingSetNodeType::encodable, &target)) {
+            encodable++;
+            if (child->tryCastTo(ThingSetNodeType::group, &target)) {
+                groups++;
+            }
+        }
+    }
+    // if a child is added or removed meanwhile, the generation will
+    // no longer match, so these counts are never used
+    if (encodable <= UINT16_MAX) {
+        sharedStore(_childCounts, ((uint64_t)generation << 32) | (groups << 16) | encodable);
+    }
+}
+
+uint32_t ThingSetParentNode::getEncodableChildCount()
+{
+    uint32_t encodable, groups;
+    getChildCounts(encodable, groups);
+    return encodable;
+}
+
+uint32_t ThingSetParentNode::getGroupChildCount()
+{
+    uint32_t encodable, groups;
+    getChildCounts(encodable, groups);
+    return groups;
+}
+
 bool ThingSetParentNode::tryCastTo(ThingSetNodeType type, void **target)
 {
     if (type == ThingSetNodeType::hasChildren) {
@@ -42,32 +96,26 @@ bool ThingSetParentNode::tryCastTo(ThingSetNodeType type, void **target)
     return false;
 }
 
-bool ThingSetParentNode::findByName(const std::string &name, ThingSetNode **node, size_t *index)
+bool ThingSetParentNode::findByName(std::string_view name, ThingSetNode **node, size_t *index)
 {
     *index = SIZE_MAX;
-
-    size_t pos;
-    std::string token = name;
     *node = this;
-    pos = name.find('/', 0);
-    token = name.substr(0, pos);
-    if ((*node)->getName() == token && pos == std::string::npos) {
+
+    size_t pos = name.find('/');
+    std::string_view token = name.substr(0, pos);
+    if (getName() == token && pos == std::string_view::npos) {
         return true;
     }
-    for (ThingSetNode *child : *this) {
-        if (child->getName() == token) {
-            *node = child;
-            if (pos == std::string::npos) {
-                return true;
-            }
-            void *target;
-            if ((*node)->tryCastTo(ThingSetNodeType::hasChildren, &target)) {
-                auto *parent = reinterpret_cast<ThingSetParentNode *>(target);
-                return parent->findByName(name.substr(token.length() + 1), node, index);
-            }
-            else {
-                break;
-            }
+    ThingSetNode *child;
+    if (ThingSetRegistry::findChildByName(this, token, &child)) {
+        *node = child;
+        if (pos == std::string_view::npos) {
+            return true;
+        }
+        void *target;
+        if (child->tryCastTo(ThingSetNodeType::hasChildren, &target)) {
+            auto *parent = reinterpret_cast<ThingSetParentNode *>(target);
+            return parent->findByName(name.substr(pos + 1), node, index);
         }
     }
 
@@ -35,6 +35,7 @@ bool ThingSetPersistence::load()
         return false;
     }
 
+    ThingSetRegistry::ReadGuard guard;
     return decoder.decodeMap<uint16_t>([&](uint16_t id) {
         ThingSetNode *node;
         if (!ThingSetRegistry::findById(id, &node)) {
@@ -52,6 +53,7 @@ bool ThingSetPersistence::load()
 bool ThingSetPersistence::save()
 {
     StreamingZephyrEepromThingSetBinaryEncoder encoder(_device, 0);
+    ThingSetRegistry::ReadGuard guard;
     // get count
     size_t count = 0;
     void *target;
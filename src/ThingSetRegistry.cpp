@@ -6,34 +6,297 @@
 
 #include "thingset++/ThingSetRegistry.hpp"
 #include "thingset++/ThingSetParentNode.hpp"
+#include "thingset++/ThingSetStaticRegistry.hpp"
+#include "thingset++/internal/fnv1a.hpp"
 #include "thingset++/internal/logging.hpp"
+#include "thingset++/internal/shared.hpp"
 #include <cassert>
 
 namespace ThingSet {
 
-static uint32_t calculateId(const uint16_t &id, const uint16_t &parentId)
-{
-    uint32_t offset = (parentId % 255) * 0x10000;
-    return offset + id + 1; // ensure never in same bucket as original
-}
-
 // Effective identity of a node within the registry: raw id for normal nodes,
 // parent-scoped id for record members. Two nodes are duplicates iff their
 // effective ids match
 static uint32_t effectiveId(ThingSetNode *node)
 {
-    uint32_t id = node->getId();
     if (node->tryCastTo(ThingSetNodeType::recordMember, nullptr)) {
-        id = calculateId(id, node->getParentId());
+        return ThingSetRegistry::nodeKey(node->getId(), node->getParentId());
     }
-    return id;
+    return ThingSetRegistry::nodeKey(node->getId());
 }
 
-ThingSetRegistry::ThingSetRegistry()
+static uint32_t childKey(const ThingSetParentNode *parent, std::string_view name)
+{
+    uint64_t p = (uintptr_t)parent;
+    return fnv1a(name, (uint32_t)(p ^ (p >> 32)));
+}
+
+#ifdef ENABLE_CONCURRENT_REGISTRY
+// Per-thread reader state. A slot is allocated on a thread's first read-side
+// critical section and released when the thread exits
+struct ReaderState
+{
+    int slot = -1;
+    unsigned depth = 0;
+    bool locked = false;
+
+    ~ReaderState()
+    {
+        if (slot >= 0) {
+            ThingSetRegistry::instance()._epochs.release(slot);
+        }
+    }
+};
+
+static thread_local ReaderState readerState;
+
+ThingSetRegistry::ReadGuard::ReadGuard()
+{
+    if (readerState.depth++ > 0) {
+        return;
+    }
+    EpochDomain &epochs = instance()._epochs;
+    if (readerState.slot < 0) {
+        readerState.slot = epochs.allocate();
+    }
+    if (readerState.slot >= 0) {
+        epochs.enter(readerState.slot);
+    } else {
+        // out of reader slots, so exclude writers instead
+        LOG_WARN("Too many reader threads; reading under lock");
+        epochs.lock();
+        readerState.locked = true;
+    }
+}
+
+ThingSetRegistry::ReadGuard::~ReadGuard()
+{
+    if (--readerState.depth > 0) {
+        return;
+    }
+    EpochDomain &epochs = instance()._epochs;
+    if (readerState.locked) {
+        readerState.locked = false;
+        epochs.unlock();
+    } else {
+        epochs.exit(readerState.slot);
+    }
+}
+#endif // ENABLE_CONCURRENT_REGISTRY
+
+ThingSetRegistry::ThingSetRegistry() : _subsetCounts(), _subsetMembers(nullptr), _generation(0)
 {
     // manually register the root node
-    _nodeMap[_rootNode.getId() % NODE_MAP_LOOKUP_BUCKETS].push_back(&_rootNode);
-    _nodeMap[_metadataNode.getId() % NODE_MAP_LOOKUP_BUCKETS].push_back(&_metadataNode);
+    _nodes.push_back(&_rootNode);
+    indexNode(_rootNode.getId(), &_rootNode, nullptr);
+    _nodes.push_back(&_metadataNode);
+    indexNode(_metadataNode.getId(), &_metadataNode, nullptr);
+}
+
+bool ThingSetRegistry::indexNode(uint32_t key, ThingSetNode *node, ThingSetNode **existing)
+{
+#ifdef ENABLE_STATIC_REGISTRY
+    if (ThingSetNode **slot = thingSetStaticIndex.slot(key)) {
+        if (*slot) {
+            if (existing) {
+                *existing = *slot;
+            }
+            return false;
+        }
+        sharedStore(*slot, node);
+        return true;
+    }
+#endif
+    return _index.write(isShared()).insert(key, node, existing);
+}
+
+bool ThingSetRegistry::unindexNode(uint32_t key, ThingSetNode *node)
+{
+#ifdef ENABLE_STATIC_REGISTRY
+    if (ThingSetNode **slot = thingSetStaticIndex.slot(key)) {
+        if (*slot != node) {
+            return false;
+        }
+        sharedStore(*slot, nullptr);
+        return true;
+    }
+#endif
+    NodeIndex &index = _index.write(isShared());
+    return index.find(key) == node && index.remove(key);
+}
+
+ThingSetNode *ThingSetRegistry::findInIndex(uint32_t key) const
+{
+#ifdef ENABLE_STATIC_REGISTRY
+    if (ThingSetNode **slot = thingSetStaticIndex.slot(key)) {
+        return sharedLoad(*slot);
+    }
+#endif
+    return _index.read().find(key);
+}
+
+bool ThingSetRegistry::attachChild(ThingSetParentNode *parent, ThingSetNode *child)
+{
+    _childIndex.write(isShared()).add(childKey(parent, child->getName()), child);
+    return parent->addChild(child);
+}
+
+bool ThingSetRegistry::detachChild(ThingSetParentNode *parent, ThingSetNode *child)
+{
+    _childIndex.write(isShared()).remove(childKey(parent, child->getName()), child);
+#ifdef ENABLE_CONCURRENT_REGISTRY
+    // readers may be positioned on the child, so leave its links until commit()
+    if (!parent->unlinkChild(child)) {
+        return false;
+    }
+    _unlinkedChildren.push_back(child);
+    return true;
+#else
+    return parent->removeChild(child);
+#endif
+}
+
+void ThingSetRegistry::unlinkNode(ThingSetNode *node)
+{
+#ifdef ENABLE_CONCURRENT_REGISTRY
+    if (_nodes.unlink(node)) {
+        _unlinkedNodes.push_back(node);
+    }
+#else
+    _nodes.remove(node);
+#endif
+}
+
+void ThingSetRegistry::countSubsets(ThingSetNode *node, int delta)
+{
+    for (uint32_t subsets = node->getSubsets(); subsets != 0; subsets &= subsets - 1) {
+        uint32_t &count = _subsetCounts[std::countr_zero(subsets)];
+        sharedStore(count, count + delta);
+    }
+}
+
+void ThingSetRegistry::addSubsetMember(ThingSetNode *node)
+{
+    uint32_t subsets = node->getSubsets();
+    if (subsets == 0) {
+        return;
+    }
+    SubsetMembers **link = &_subsetMembers;
+    while (*link != nullptr && (*link)->subsets != subsets) {
+        link = &(*link)->next;
+    }
+    if (*link == nullptr) {
+        // there are few distinct combinations of subsets in practice, so
+        // groups are kept for the lifetime of the registry
+        sharedStore(*link, new SubsetMembers { subsets, SubsetList(), nullptr });
+    }
+    (*link)->nodes.push_back(node);
+}
+
+void ThingSetRegistry::removeSubsetMember(ThingSetNode *node)
+{
+    uint32_t subsets = node->getSubsets();
+    if (subsets == 0) {
+        return;
+    }
+    SubsetMembers *members = _subsetMembers;
+    while (members != nullptr && members->subsets != subsets) {
+        members = members->next;
+    }
+    if (members == nullptr) {
+        return;
+    }
+#ifdef ENABLE_CONCURRENT_REGISTRY
+    if (members->nodes.unlink(node)) {
+        _unlinkedMembers.push_back(node);
+    }
+#else
+    members->nodes.remove(node);
+#endif
+}
+
+bool ThingSetRegistry::isShared() const
+{
+#ifdef ENABLE_CONCURRENT_REGISTRY
+    return _epochs.isShared();
+#else
+    return false;
+#endif
+}
+
+void ThingSetRegistry::commit()
+{
+    bool retired = _index.publish();
+    retired |= _childIndex.publish();
+#ifdef ENABLE_CONCURRENT_REGISTRY
+    if (!retired && _unlinkedNodes.empty() && _unlinkedChildren.empty() && _unlinkedMembers.empty()) {
+        return;
+    }
+    if (isShared()) {
+        // wait until no reader can be using the previous indexes or be
+        // positioned on an unlinked node; a writer inside a read-side
+        // section of its own is not waited for
+        _epochs.synchronize(readerState.depth > 0 ? readerState.slot : -1);
+    }
+    _index.reclaim();
+    _childIndex.reclaim();
+    for (ThingSetNode *node : _unlinkedNodes) {
+        NodeList::reset(node);
+    }
+    for (ThingSetNode *node : _unlinkedChildren) {
+        OrphanList::reset(node);
+    }
+    for (ThingSetNode *node : _unlinkedMembers) {
+        SubsetList::reset(node);
+    }
+    _unlinkedNodes.clear();
+    _unlinkedChildren.clear();
+    _unlinkedMembers.clear();
+    for (ThingSetNode *node : _pendingOrphans) {
+        addOrphan(node);
+    }
+    _pendingOrphans.clear();
+#else
+    (void)retired;
+#endif
+}
+
+void ThingSetRegistry::addOrphan(ThingSetNode *node)
+{
+    OrphanList *list = _orphans.find(node->getParentId());
+    if (list == nullptr) {
+        list = new OrphanList();
+        _orphans.insert(node->getParentId(), list);
+    }
+    list->push_back(node);
+}
+
+bool ThingSetRegistry::removeOrphan(ThingSetNode *node)
+{
+    OrphanList *list = _orphans.find(node->getParentId());
+    if (list == nullptr || !list->remove(node)) {
+        return false;
+    }
+    if (list->begin() == list->end()) {
+        _orphans.remove(node->getParentId());
+        delete list;
+    }
+    return true;
+}
+
+void ThingSetRegistry::adoptOrphans(ThingSetParentNode *parent)
+{
+    OrphanList *list = _orphans.find(parent->getId());
+    if (list == nullptr) {
+        return;
+    }
+    _orphans.remove(parent->getId());
+    while (list->begin() != list->end()) {
+        ThingSetNode *orphan = *list->begin();
+        list->remove(orphan);
+        attachChild(parent, orphan);
+    }
+    delete list;
 }
 
 ThingSetNode *ThingSetRegistry::getMetadataNode()
@@ -41,6 +304,11 @@ ThingSetNode *ThingSetRegistry::getMetadataNode()
     return &instance()._metadataNode;
 }
 
+uint32_t ThingSetRegistry::getGeneration()
+{
+    return sharedLoad(instance()._generation);
+}
+
 ThingSetRegistry &ThingSetRegistry::instance()
 {
     static ThingSetRegistry instance;
@@ -48,50 +316,93 @@ ThingSetRegistry &ThingSetRegistry::instance()
 }
 
 void ThingSetRegistry::registerOrUnregisterNode(
-    ThingSetNode *node, std::function<void(NodeList &, ThingSetNode *)> nodeListAction,
-    std::function<bool(ThingSetParentNode *, ThingSetNode *)> parentNodeAction)
+    ThingSetNode *node, FunctionRef<bool(ThingSetRegistry &, uint32_t, ThingSetNode *)> registryAction,
+    FunctionRef<bool(ThingSetRegistry &, ThingSetParentNode *, ThingSetNode *)> parentNodeAction)
 {
     uint32_t id = effectiveId(node);
-    NodeList &list = _nodeMap[id % NODE_MAP_LOOKUP_BUCKETS];
-    nodeListAction(list, node);
-    ThingSetParentNode *parent;
-    if (node->getParentId() != id && findParentById(node->getParentId(), &parent)) {
-        parentNodeAction(parent, node);
+#ifdef ENABLE_CONCURRENT_REGISTRY
+    std::lock_guard<EpochDomain> lock(_epochs);
+#endif
+    if (registryAction(*this, id, node)) {
+        sharedStore(_generation, _generation + 1);
+#ifndef ENABLE_CONCURRENT_REGISTRY
+        _pathCache.clear();
+#endif
+        if (node->getParentId() != id) {
+            // look up directly, rather than via findParentById(), as the
+            // writer needs no read-side critical section
+            ThingSetParentNode *parent = nullptr;
+            ThingSetNode *p = findInIndex(nodeKey(node->getParentId()));
+            void *target;
+            if (p && p->tryCastTo(ThingSetNodeType::hasChildren, &target)) {
+                parent = reinterpret_cast<ThingSetParentNode *>(target);
+            }
+            parentNodeAction(*this, parent, node);
+        }
     }
+    commit();
 }
 
 void ThingSetRegistry::registerNode(ThingSetNode *node)
 {
     LOG_DEBUG("Registering node %s (0x%x)", node->getName().data(), node->getId());
     ThingSetRegistry::instance().registerOrUnregisterNode(
-        node, [](auto &l, auto *n) {
-            uint32_t nEff = effectiveId(n);
-            for (const auto &en : l) {
-                if (effectiveId(en) == nEff) {
-                    LOG_ERROR("Cannot register node %s (0x%x under parent 0x%x) as it already exists (under name %s)",
-                              n->getName().data(), n->getId(), n->getParentId(), en->getName().data());
-                    assert(effectiveId(en) != nEff);
-                    return;
-                }
+        node, [](auto &r, auto id, auto *n) {
+            ThingSetNode *existing = nullptr;
+            if (!r.indexNode(id, n, &existing)) {
+                LOG_ERROR("Cannot register node %s (0x%x under parent 0x%x) as it already exists (under name %s)",
+                          n->getName().data(), n->getId(), n->getParentId(), existing->getName().data());
+                assert(existing == nullptr);
+                return false;
             }
-            l.push_back(n);
-        }, [](auto *p, auto *n) { return p->addChild(n); });
-    void *target;
-    if (node->tryCastTo(ThingSetNodeType::hasChildren, &target)) {
-        ThingSetParentNode *parent = reinterpret_cast<ThingSetParentNode *>(target);
-        for (auto n : instance()) {
-            if (n->getParentId() == node->getId()) {
-                parent->addChild(n);
+            r._nodes.push_back(n);
+            r.countSubsets(n, 1);
+            r.addSubsetMember(n);
+            void *target;
+            if (n->tryCastTo(ThingSetNodeType::hasChildren, &target)) {
+                // adopt any children which were registered before this node
+                r.adoptOrphans(reinterpret_cast<ThingSetParentNode *>(target));
             }
-        }
-    }
+            return true;
+        }, [](auto &r, auto *p, auto *n) {
+            if (p) {
+                return r.attachChild(p, n);
+            }
+            // parent not yet registered, so wait for it
+            r.addOrphan(n);
+            return true;
+        });
 }
 
 void ThingSetRegistry::unregisterNode(ThingSetNode *node)
 {
     LOG_DEBUG("Unregistering node %s (0x%x)", node->getName().data(), node->getId());
     ThingSetRegistry::instance().registerOrUnregisterNode(
-        node, [](auto &l, auto *n) { l.remove(n); }, [](auto *p, auto *n) { return p->removeChild(n); });
+        node, [](auto &r, auto id, auto *n) {
+            if (!r.unindexNode(id, n)) {
+                return false;
+            }
+            r.unlinkNode(n);
+            r.countSubsets(n, -1);
+            r.removeSubsetMember(n);
+            void *target;
+            if (n->tryCastTo(ThingSetNodeType::hasChildren, &target)) {
+                // any remaining children wait for a replacement parent
+                ThingSetParentNode *parent = reinterpret_cast<ThingSetParentNode *>(target);
+                while (parent->begin() != parent->end()) {
+                    ThingSetNode *child = *parent->begin();
+                    r.detachChild(parent, child);
+#ifdef ENABLE_CONCURRENT_REGISTRY
+                    r._pendingOrphans.push_back(child);
+#else
+                    r.addOrphan(child);
+#endif
+                }
+            }
+            return true;
+        }, [](auto &r, auto *p, auto *n) {
+            return p ? r.detachChild(p, n) : r.removeOrphan(n);
+        });
 }
 
 bool ThingSetRegistry::findParentById(const unsigned id, ThingSetParentNode **parent)
@@ -106,43 +417,57 @@ bool ThingSetRegistry::findParentById(const unsigned id, ThingSetParentNode **pa
     return false;
 }
 
-bool ThingSetRegistry::findByName(const std::string &name, ThingSetNode **node)
+bool ThingSetRegistry::findByName(std::string_view name, ThingSetNode **node)
 {
     size_t index;
-    return instance()._rootNode.findByName(name, node, &index);
+    return findByName(name, node, &index);
 }
 
-bool ThingSetRegistry::findByName(const std::string &name, ThingSetNode **node, size_t *index)
+bool ThingSetRegistry::findByName(std::string_view name, ThingSetNode **node, size_t *index)
 {
-    return instance()._rootNode.findByName(name, node, index);
+    ThingSetRegistry &registry = instance();
+#ifdef ENABLE_CONCURRENT_REGISTRY
+    // a lookup which resolved a path before a concurrent registration could
+    // insert it into the cache after that registration has cleared it, so
+    // resolve directly
+    ReadGuard guard;
+    return registry._rootNode.findByName(name, node, index);
+#else
+    if (registry._pathCache.find(name, node, index)) {
+        return true;
+    }
+    if (!registry._rootNode.findByName(name, node, index)) {
+        return false;
+    }
+    registry._pathCache.insert(name, *node, *index);
+    return true;
+#endif
 }
 
-bool ThingSetRegistry::findByIdInNodeList(NodeList list, const unsigned id, ThingSetNode **node)
+bool ThingSetRegistry::findChildByName(const ThingSetParentNode *parent, std::string_view name, ThingSetNode **node)
 {
-    for (ThingSetNode *n : list) {
-        if (n && (n->getId() == id)) {
-            *node = n;
-            return true;
-        }
+    ReadGuard guard;
+    uint16_t parentId = parent->getId();
+    ThingSetNode *n = instance()._childIndex.read().find(childKey(parent, name), [parentId, name](ThingSetNode *c) {
+        return c->getParentId() == parentId && c->getName() == name;
+    });
+    if (n) {
+        *node = n;
+        return true;
     }
     return false;
 }
 
 bool ThingSetRegistry::findById(const unsigned id, const unsigned parentId, ThingSetNode **node)
 {
+    ReadGuard guard;
     ThingSetParentNode *parent;
     if (findParentById(parentId, &parent) && parent->tryCastTo(ThingSetNodeType::record, nullptr))
     {
-        uint32_t fakeId = calculateId(id, parentId);
-        NodeList &list = instance()._nodeMap[fakeId % NODE_MAP_LOOKUP_BUCKETS];
-        // Multiple record-member proxies can share a bucket when they share a
-        // raw id under different parents. Filter by parent id too so the
-        // caller gets the proxy they asked for
-        for (ThingSetNode *n : list) {
-            if (n && n->getId() == id && n->getParentId() == parentId) {
-                *node = n;
-                return true;
-            }
+        ThingSetNode *n = instance().findInIndex(nodeKey(id, parentId));
+        if (n) {
+            *node = n;
+            return true;
         }
     }
     return false;
@@ -150,42 +475,44 @@ bool ThingSetRegistry::findById(const unsigned id, const unsigned parentId, Thin
 
 bool ThingSetRegistry::findById(const unsigned id, ThingSetNode **node)
 {
-    NodeList list = instance()._nodeMap[id % NODE_MAP_LOOKUP_BUCKETS];
-    return findByIdInNodeList(list, id, node);
+    if (id > UINT16_MAX) {
+        return false;
+    }
+    ReadGuard guard;
+    ThingSetNode *n = instance().findInIndex(id);
+    if (n) {
+        *node = n;
+        return true;
+    }
+    return false;
 }
 
-FlatteningIterator<ThingSetRegistry::NodeMap::iterator> ThingSetRegistry::begin()
+ThingSetRegistry::NodeList::iterator ThingSetRegistry::begin()
 {
-    auto begin = instance()._nodeMap.begin();
-    auto end = instance()._nodeMap.end();
-    return flatten(begin, end);
+    return instance()._nodes.begin();
 }
 
-FlatteningIterator<ThingSetRegistry::NodeMap::const_iterator, std::iterator_traits<ThingSetRegistry::NodeMap::const_iterator>::value_type::const_iterator> ThingSetRegistry::cbegin() const
+ThingSetRegistry::NodeList::iterator ThingSetRegistry::end()
 {
-    auto begin = instance()._nodeMap.cbegin();
-    auto end = instance()._nodeMap.cend();
-    return flatten<NodeMap::const_iterator, std::iterator_traits<NodeMap::const_iterator>::value_type::const_iterator>(begin, end);
+    return instance()._nodes.end();
 }
 
-FlatteningIterator<ThingSetRegistry::NodeMap::const_iterator, std::iterator_traits<ThingSetRegistry::NodeMap::const_iterator>::value_type::const_iterator> ThingSetRegistry::begin() const
+ThingSetRegistry::NodeList::const_iterator ThingSetRegistry::cbegin() const
 {
-    return cbegin();
+    return instance()._nodes.cbegin();
 }
 
-FlatteningIterator<ThingSetRegistry::NodeMap::iterator> ThingSetRegistry::end()
+ThingSetRegistry::NodeList::const_iterator ThingSetRegistry::cend() const
 {
-    auto end = instance()._nodeMap.end();
-    return flatten(end);
+    return instance()._nodes.cend();
 }
 
-FlatteningIterator<ThingSetRegistry::NodeMap::const_iterator, std::iterator_traits<ThingSetRegistry::NodeMap::const_iterator>::value_type::const_iterator> ThingSetRegistry::cend() const
+ThingSetRegistry::NodeList::const_iterator ThingSetRegistry::begin() const
 {
-    auto end = instance()._nodeMap.cend();
-    return flatten<ThingSetRegistry::NodeMap::const_iterator, std::iterator_traits<ThingSetRegistry::NodeMap::const_iterator>::value_type::const_iterator>(end);
+    return cbegin();
 }
 
-FlatteningIterator<ThingSetRegistry::NodeMap::const_iterator, std::iterator_traits<ThingSetRegistry::NodeMap::const_iterator>::value_type::const_iterator> ThingSetRegistry::end() const
+ThingSetRegistry::NodeList::const_iterator ThingSetRegistry::end() const
 {
     return cend();
 }
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "thingset++/ThingSetReport.hpp"
+#include "thingset++/Eui.hpp"
+#include "thingset++/ThingSetBinaryEncoder.hpp"
+#include "thingset++/ThingSetRegistry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ThingSet {
+
+#ifdef ENABLE_ENHANCED_REPORTING
+static constexpr bool enhanced = true;
+#else
+static constexpr bool enhanced = false;
+#endif
+
+// reports are published by streaming encoders, so values are encoded as
+// they would encode them
+static constexpr ThingSetBinaryEncoderOptions options = (ThingSetBinaryEncoderOptions)(
+    ThingSetBinaryEncoderOptions::encodeKeysAsIds
+    | (BINARY_ENCODER_DEFAULT_SHORTEST_FLOATS ? ThingSetBinaryEncoderOptions::shortestFloats : 0));
+
+// initial size of the buffer, which doubles as necessary
+static constexpr size_t initialSize = 64;
+
+// the longest encoding of a map header
+static constexpr size_t maxMapHeaderSize = 5;
+
+ThingSetReport::ThingSetReport(uint32_t subset, bool fromRegistry)
+    : _length(0), _mapOffset(0), _deltaLength(0), _partial(false), _keyframeInterval(0), _sinceKeyframe(0),
+      _hasPolicies(false), _subset(subset), _fromRegistry(fromRegistry), _compiled(false), _generation(0)
+{}
+
+bool ThingSetReport::update(std::chrono::steady_clock::time_point now)
+{
+    ThingSetRegistry::ReadGuard guard;
+    _partial = false;
+    bool current = isCurrent();
+    bool partial = isPartial();
+    for (size_t i = 0; current && i < _slots.size(); i++) {
+        if (!partial) {
+            current = patch(_slots[i]);
+            continue;
+        }
+        bool changed;
+        current = compare(_slots[i], &changed);
+        if (current) {
+            select(_slots[i], changed, now);
+        }
+    }
+    if (!current && !compile()) {
+        return false;
+    }
+    if (!isPartial()) {
+        return true;
+    }
+    if (!current) {
+        // everything was encoded afresh, so this is a keyframe anyway
+        _sinceKeyframe = 0;
+    }
+    bool keyframe = !current || (_keyframeInterval > 0 && _sinceKeyframe == 0);
+    if (_keyframeInterval > 0) {
+        _sinceKeyframe = (_sinceKeyframe + 1) % _keyframeInterval;
+    }
+    if (keyframe) {
+        for (Slot &slot : _slots) {
+            markReported(slot, now);
+        }
+        return true;
+    }
+    return encodeDelta();
+}
+
+bool ThingSetReport::isCurrent() const
+{
+    return _compiled && (!_fromRegistry || _generation == ThingSetRegistry::getGeneration());
+}
+
+bool ThingSetReport::isPartial() const
+{
+    return _keyframeInterval > 0 || _hasPolicies;
+}
+
+bool ThingSetReport::collect()
+{
+    _generation = ThingSetRegistry::getGeneration();
+    _slots.clear();
+    for (ThingSetNode *node : ThingSetRegistry::nodesInSubset(_subset)) {
+        void *target;
+        if (!node->tryCastTo(ThingSetNodeType::encodable, &target)) {
+            return false;
+        }
+        _slots.push_back(Slot { node, reinterpret_cast<ThingSetEncodable *>(target) });
+    }
+    return true;
+}
+
+bool ThingSetReport::compile()
+{
+    _compiled = false;
+    if (_fromRegistry && !collect()) {
+        return false;
+    }
+    _hasPolicies = false;
+    for (Slot &slot : _slots) {
+        void *target;
+        slot.reportable = nullptr;
+        if (slot.node->tryCastTo(ThingSetNodeType::reportable, &target)) {
+            slot.reportable = reinterpret_cast<ThingSetReportable *>(target);
+            _hasPolicies = true;
+        }
+    }
+    if (_buffer.empty()) {
+        _buffer.resize(initialSize);
+    }
+    while (!encode()) {
+        // assume the buffer was too small
+        if (_buffer.size() >= CONFIG_THINGSET_PLUS_PLUS_REPORT_MAX_SIZE) {
+            return false;
+        }
+        _buffer.resize(std::min<size_t>(_buffer.size() * 2, CONFIG_THINGSET_PLUS_PLUS_REPORT_MAX_SIZE));
+    }
+    _compiled = true;
+    return true;
+}
+
+bool ThingSetReport::encode()
+{
+    FixedDepthThingSetBinaryEncoder encoder(_buffer.data(), _buffer.size(), enhanced ? 3 : 2, options);
+    if (enhanced && !encoder.encode(Eui::getValue())) {
+        return false;
+    }
+    if (!encoder.encode(_subset)) {
+        return false;
+    }
+    _mapOffset = encoder.getEncodedLength();
+    if (!encoder.encodeMapStart(_slots.size())) {
+        return false;
+    }
+    size_t longest = 0;
+    for (Slot &slot : _slots) {
+        slot.key = encoder.getEncodedLength();
+        if (!encoder.encode(slot.node->getId())) {
+            return false;
+        }
+        slot.offset = encoder.getEncodedLength();
+        if (!slot.encodable->encode(encoder)) {
+            return false;
+        }
+        slot.length = encoder.getEncodedLength() - slot.offset;
+        longest = std::max(longest, slot.length);
+    }
+    if (!encoder.encodeMapEnd(_slots.size())) {
+        return false;
+    }
+    _length = encoder.getEncodedLength();
+    if (isPartial() && _scratch.size() < longest) {
+        _scratch.resize(longest);
+    }
+    return true;
+}
+
+bool ThingSetReport::patch(Slot &slot)
+{
+    // encode over the previous value; an encoder confined to its slot
+    // cannot overwrite anything else if the new value is wider
+    FixedDepthThingSetBinaryEncoder encoder(&_buffer[slot.offset], slot.length, 1, options);
+    return slot.encodable->encode(encoder) && encoder.getEncodedLength() == slot.length;
+}
+
+bool ThingSetReport::compare(Slot &slot, bool *changed)
+{
+    uint8_t *value = &_buffer[slot.offset];
+    // keep the previous value to compare against
+    if (_scratch.size() < slot.length) {
+        _scratch.resize(slot.length);
+    }
+    FixedDepthThingSetBinaryEncoder encoder(_scratch.data(), slot.length, 1, options);
+    if (!slot.encodable->encode(encoder) || encoder.getEncodedLength() != slot.length) {
+        return false;
+    }
+    *changed = memcmp(value, _scratch.data(), slot.length) != 0;
+    if (*changed) {
+        memcpy(value, _scratch.data(), slot.length);
+    }
+    return true;
+}
+
+void ThingSetReport::select(Slot &slot, bool changed, std::chrono::steady_clock::time_point now)
+{
+    if (slot.reportable == nullptr) {
+        slot.included = changed || _keyframeInterval == 0;
+        return;
+    }
+    const ThingSetReportingPolicy &policy = slot.reportable->getReportingPolicy();
+    double value;
+    if (slot.reportable->getReportingValue(&value)) {
+        double threshold = std::max(policy.deadband, policy.relativeDeadband * std::fabs(slot.reportedValue));
+        slot.pending = threshold > 0 ? std::fabs(value - slot.reportedValue) > threshold : value != slot.reportedValue;
+    } else {
+        slot.pending |= changed;
+    }
+    auto elapsed = now - slot.reportedAt;
+    slot.included = (policy.maxInterval.count() > 0 && elapsed >= policy.maxInterval)
+                    || (slot.pending && elapsed >= policy.minInterval);
+    if (slot.included) {
+        markReported(slot, now);
+    }
+}
+
+void ThingSetReport::markReported(Slot &slot, std::chrono::steady_clock::time_point now)
+{
+    slot.included = true;
+    if (slot.reportable) {
+        slot.reportable->getReportingValue(&slot.reportedValue);
+        slot.reportedAt = now;
+        slot.pending = false;
+    }
+}
+
+bool ThingSetReport::encodeDelta()
+{
+    size_t count = 0;
+    size_t length = _mapOffset + maxMapHeaderSize;
+    for (const Slot &slot : _slots) {
+        if (slot.included) {
+            count++;
+            length += slot.offset + slot.length - slot.key;
+        }
+    }
+    _partial = true;
+    if (count == 0) {
+        _deltaLength = 0;
+        return true;
+    }
+    if (_delta.size() < length) {
+        _delta.resize(length);
+    }
+    // the EUI and subset ID are unchanged, but the map header must reflect
+    // the number of values included
+    memcpy(_delta.data(), _buffer.data(), _mapOffset);
+    FixedDepthThingSetBinaryEncoder encoder(&_delta[_mapOffset], maxMapHeaderSize);
+    if (!encoder.encodeMapStart(count)) {
+        return false;
+    }
+    size_t position = _mapOffset + encoder.getEncodedLength();
+    for (const Slot &slot : _slots) {
+        if (slot.included) {
+            size_t pairLength = slot.offset + slot.length - slot.key;
+            memcpy(&_delta[position], &_buffer[slot.key], pairLength);
+            position += pairLength;
+        }
+    }
+    _deltaLength = position;
+    return true;
+}
+
+} // namespace ThingSet
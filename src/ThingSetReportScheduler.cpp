@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "thingset++/ThingSetReportScheduler.hpp"
+#include "thingset++/internal/logging.hpp"
+#include <algorithm>
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+namespace ThingSet {
+
+using namespace std::chrono;
+
+_ThingSetReportScheduler::_ThingSetReportScheduler() : _running(false)
+{
+#ifdef __ZEPHYR__
+    _work.instance = this;
+    k_work_init_delayable(&_work.work, runWork);
+    k_mutex_init(&_lock);
+#elif defined(__linux__)
+    _timerFd = -1;
+#endif
+}
+
+_ThingSetReportScheduler::~_ThingSetReportScheduler()
+{
+    stop();
+}
+
+bool _ThingSetReportScheduler::add(uint32_t subset, std::unique_ptr<ThingSetReport> report, milliseconds period,
+                                   uint8_t priority)
+{
+    lock();
+    // insert after any entries of the same or higher priority, so that
+    // entries of equal priority are published in the order they were added
+    auto position = std::find_if(_entries.begin(), _entries.end(),
+                                 [priority](const Entry &entry) { return entry.priority < priority; });
+    _entries.insert(position, Entry { std::move(report), subset, period, priority, Clock::time_point(),
+                                      ThingSetReportStatistics { 0, 0, 0, microseconds::max(), microseconds(0),
+                                                                 microseconds(0) } });
+    unlock();
+    return true;
+}
+
+bool _ThingSetReportScheduler::getStatistics(uint32_t subset, ThingSetReportStatistics *statistics)
+{
+    lock();
+    bool found = false;
+    for (Entry &entry : _entries) {
+        if (entry.subset == subset) {
+            *statistics = entry.statistics;
+            found = true;
+            break;
+        }
+    }
+    unlock();
+    return found;
+}
+
+void _ThingSetReportScheduler::schedule(Clock::time_point now)
+{
+    lock();
+    // offset the nth of N entries by n/N of its period, so that entries of
+    // the same period are spread evenly across it
+    size_t count = _entries.size();
+    for (size_t i = 0; i < count; i++) {
+        _entries[i].deadline = now + _entries[i].period * i / count;
+    }
+    unlock();
+}
+
+_ThingSetReportScheduler::Clock::time_point _ThingSetReportScheduler::run(Clock::time_point now)
+{
+    // publishing involves I/O, so only find the reports which are due while
+    // holding the lock, and publish them once it is released
+    lock();
+    _due.clear();
+    // only allocates after reports have been added
+    _due.reserve(_entries.size());
+    Clock::time_point next = Clock::time_point::max();
+    for (Entry &entry : _entries) {
+        if (entry.deadline <= now) {
+            _due.push_back(Due { entry.report.get(), entry.deadline, false, microseconds(0) });
+            entry.deadline += entry.period;
+            if (entry.deadline <= now) {
+                // more than a whole period behind; skip the deadlines which
+                // have passed rather than publishing in a burst to catch up
+                auto behind = (now - entry.deadline) / entry.period + 1;
+                entry.statistics.missed += behind;
+                entry.deadline += entry.period * behind;
+            }
+        }
+        next = std::min(next, entry.deadline);
+    }
+    unlock();
+
+    Clock::time_point start = Clock::now();
+    for (Due &due : _due) {
+        // reports published earlier in the pass delay this one
+        Clock::time_point publishedAt = now + (Clock::now() - start);
+        due.jitter = duration_cast<microseconds>(publishedAt - due.deadline);
+        due.published = publish(*due.report);
+    }
+
+    lock();
+    for (const Due &due : _due) {
+        auto entry = std::find_if(_entries.begin(), _entries.end(),
+                                  [&due](const Entry &e) { return e.report.get() == due.report; });
+        ThingSetReportStatistics &statistics = entry->statistics;
+        if (due.published) {
+            statistics.count++;
+            statistics.minJitter = std::min(statistics.minJitter, due.jitter);
+            statistics.maxJitter = std::max(statistics.maxJitter, due.jitter);
+            statistics.totalJitter += due.jitter;
+        }
+        else {
+            statistics.failed++;
+        }
+    }
+    unlock();
+    return next;
+}
+
+#ifdef __ZEPHYR__
+
+void _ThingSetReportScheduler::lock()
+{
+    k_mutex_lock(&_lock, K_FOREVER);
+}
+
+void _ThingSetReportScheduler::unlock()
+{
+    k_mutex_unlock(&_lock);
+}
+
+bool _ThingSetReportScheduler::start()
+{
+    if (_running || _entries.empty()) {
+        return false;
+    }
+    schedule(Clock::now());
+    _running = true;
+    k_work_reschedule(&_work.work, K_NO_WAIT);
+    return true;
+}
+
+void _ThingSetReportScheduler::stop()
+{
+    if (!_running) {
+        return;
+    }
+    _running = false;
+    k_work_sync sync;
+    k_work_cancel_delayable_sync(&_work.work, &sync);
+}
+
+void _ThingSetReportScheduler::runWork(k_work *work)
+{
+    k_work_delayable *delayable = k_work_delayable_from_work(work);
+    auto *item = CONTAINER_OF(delayable, WorkItem, work);
+    _ThingSetReportScheduler *self = item->instance;
+    Clock::time_point next = self->run(Clock::now());
+    if (self->_running) {
+        auto delay = duration_cast<microseconds>(next - Clock::now());
+        k_work_reschedule(&item->work, K_USEC(std::max<int64_t>(delay.count(), 0)));
+    }
+}
+
+#else
+
+void _ThingSetReportScheduler::lock()
+{
+    _lock.lock();
+}
+
+void _ThingSetReportScheduler::unlock()
+{
+    _lock.unlock();
+}
+
+#ifdef __linux__
+
+static itimerspec toTimerSpec(_ThingSetReportScheduler::Clock::time_point time)
+{
+    // steady_clock is CLOCK_MONOTONIC, so its time points can be used as
+    // absolute expiry times directly
+    auto sinceEpoch = duration_cast<nanoseconds>(time.time_since_epoch());
+    itimerspec spec = {};
+    spec.it_value.tv_sec = sinceEpoch.count() / 1000000000;
+    spec.it_value.tv_nsec = sinceEpoch.count() % 1000000000;
+    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+        // an expiry time of zero would disarm the timer
+        spec.it_value.tv_nsec = 1;
+    }
+    return spec;
+}
+
+bool _ThingSetReportScheduler::start()
+{
+    if (_running || _entries.empty()) {
+        return false;
+    }
+    _timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (_timerFd < 0) {
+        LOG_ERROR("Failed to create report timer: %d", errno);
+        return false;
+    }
+    schedule(Clock::now());
+    _running = true;
+    _thread = std::thread(&_ThingSetReportScheduler::runTimer, this);
+    return true;
+}
+
+void _ThingSetReportScheduler::stop()
+{
+    if (!_running) {
+        return;
+    }
+    _running = false;
+    // wake the thread immediately, so that it notices it should finish
+    itimerspec spec = toTimerSpec(Clock::time_point());
+    timerfd_settime(_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+    _thread.join();
+    close(_timerFd);
+    _timerFd = -1;
+}
+
+void _ThingSetReportScheduler::runTimer()
+{
+    Clock::time_point next = run(Clock::now());
+    while (_running) {
+        itimerspec spec = toTimerSpec(next);
+        if (timerfd_settime(_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+            LOG_ERROR("Failed to arm report timer: %d", errno);
+            break;
+        }
+        if (!_running) {
+            // stop() may have armed the timer before this thread re-armed it
+            break;
+        }
+        uint64_t expirations;
+        if (read(_timerFd, &expirations, sizeof(expirations)) < 0 && errno != EINTR) {
+            LOG_ERROR("Failed to wait for report timer: %d", errno);
+            break;
+        }
+        if (_running) {
+            next = run(Clock::now());
+        }
+    }
+}
+
+#else
+
+bool _ThingSetReportScheduler::start()
+{
+    if (_running || _entries.empty()) {
+        return false;
+    }
+    schedule(Clock::now());
+    _running = true;
+    _thread = std::thread(&_ThingSetReportScheduler::runTimer, this);
+    return true;
+}
+
+void _ThingSetReportScheduler::stop()
+{
+    if (!_running) {
+        return;
+    }
+    {
+        // taking the lock means the thread is either publishing, and will
+        // check again before it waits, or waiting, and will be woken
+        std::lock_guard<std::mutex> guard(_lock);
+        _running = false;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+void _ThingSetReportScheduler::runTimer()
+{
+    Clock::time_point next = run(Clock::now());
+    std::unique_lock<std::mutex> guard(_lock);
+    while (_running) {
+        if (_wake.wait_until(guard, next, [this]() { return !_running; })) {
+            break;
+        }
+        // run() takes the lock itself, and publishes without holding it
+        guard.unlock();
+        next = run(Clock::now());
+        guard.lock();
+    }
+}
+
+#endif // __linux__
+
+#endif // __ZEPHYR__
+
+} // namespace ThingSet
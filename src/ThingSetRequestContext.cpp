@@ -18,7 +18,7 @@ uint16_t &ThingSetRequestContext::id()
     return _id.value();
 }
 
-std::string &ThingSetRequestContext::path()
+std::string_view ThingSetRequestContext::path()
 {
     return _path.value();
 }
@@ -38,11 +38,32 @@ bool ThingSetRequestContext::useIds()
     return _id.has_value();
 }
 
+size_t ThingSetRequestContext::getWrittenLength() const
+{
+    return 0;
+}
+
+int ThingSetRequestContext::finishResponse(int responseLength)
+{
+    size_t written = getWrittenLength();
+    if (written == 0) {
+        return responseLength;
+    }
+    if (responseLength <= (int)getHeaderLength()) {
+        // the status has already been sent, so cannot be changed
+        return -1;
+    }
+    // the header went out with the first part, so the rest follows where it was
+    int unwritten = responseLength - (int)written;
+    memmove(_response, _response + getHeaderLength(), unwritten);
+    return unwritten;
+}
+
 bool ThingSetRequestContext::tryGetNodeId(std::string &nodeId)
 {
     // first find nodeID by finding next slash
     const size_t pos = path().find('/', 1);
-    if (pos == std::string::npos)
+    if (pos == std::string_view::npos)
     {
         return false;
     }
@@ -51,12 +72,17 @@ bool ThingSetRequestContext::tryGetNodeId(std::string &nodeId)
     return true;
 }
 
-ThingSetBinaryRequestContext::ThingSetBinaryRequestContext(uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize) :
+// numeric arrays in responses are only encoded as typed arrays if every
+// client is known to decode them
+static constexpr ThingSetBinaryEncoderOptions responseOptions = (ThingSetBinaryEncoderOptions)(
+    ThingSetBinaryEncoderOptions::encodeKeysAsIds
+    | (BINARY_ENCODER_DEFAULT_TYPED_ARRAYS ? ThingSetBinaryEncoderOptions::typedArrays : 0));
+
+_ThingSetBinaryRequestContext::_ThingSetBinaryRequestContext(uint8_t *request, size_t requestLen, uint8_t *response) :
     _ThingSetRequestContext(request, response),
-    _encoder(response + 1, responseSize - 1),
     _decoder(request + 1, requestLen - 1, 2)
 {
-    std::string path;
+    std::string_view path;
     uint16_t id;
     if (_decoder.decode(&path))
     {
@@ -68,7 +94,7 @@ ThingSetBinaryRequestContext::ThingSetBinaryRequestContext(uint8_t *request, siz
     }
 }
 
-size_t ThingSetBinaryRequestContext::rewrite(uint8_t **request, size_t requestLength, std::string &nodeId)
+size_t _ThingSetBinaryRequestContext::rewrite(uint8_t **request, size_t requestLength, std::string &nodeId)
 {
     if (isForward())
     {
@@ -122,18 +148,45 @@ size_t ThingSetBinaryRequestContext::rewrite(uint8_t **request, size_t requestLe
     }
 }
 
-bool ThingSetBinaryRequestContext::setStatus(const ThingSetStatusCode &status)
+bool _ThingSetBinaryRequestContext::setStatus(const ThingSetStatusCode &status)
 {
     _response[0] = status;
     return true;
 }
 
+ThingSetBinaryRequestContext::ThingSetBinaryRequestContext(uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize) :
+    _ThingSetBinaryRequestContext(request, requestLen, response),
+    _encoder(response + 1, responseSize - 1, 1, responseOptions)
+{}
+
+StreamingThingSetBinaryRequestContext::StreamingThingSetBinaryRequestContext(uint8_t *request, size_t requestLen,
+                                                                             uint8_t *response, size_t responseSize,
+                                                                             FunctionRef<bool(const uint8_t *, size_t)> writer) :
+    _ThingSetBinaryRequestContext(request, requestLen, response),
+    _encoder(response, responseSize, 1, writer, responseOptions)
+{}
+
+size_t StreamingThingSetBinaryRequestContext::getWrittenLength() const
+{
+    return _encoder.getWrittenLength();
+}
+
 #ifdef ENABLE_TEXT_MODE
+// writes nothing, so that a response must fit in the buffer
+static constexpr auto unwritable = [](const uint8_t *, size_t) { return false; };
+
 ThingSetTextRequestContext::ThingSetTextRequestContext(uint8_t *request, size_t requestLen,
                                                        uint8_t *response, size_t responseSize,
                                                        TextEncoderOptions opts) :
+    ThingSetTextRequestContext(request, requestLen, response, responseSize, unwritable, opts)
+{}
+
+ThingSetTextRequestContext::ThingSetTextRequestContext(uint8_t *request, size_t requestLen,
+                                                       uint8_t *response, size_t responseSize,
+                                                       FunctionRef<bool(const uint8_t *, size_t)> writer,
+                                                       TextEncoderOptions opts) :
     _ThingSetRequestContext(request, response),
-    _encoder(reinterpret_cast<char *>(response) + 4, responseSize - 4, opts),
+    _encoder(reinterpret_cast<char *>(response), responseSize, 4, writer, opts),
     _decoder(reinterpret_cast<char *>(request) + 1, requestLen - 1)
 {
     // find first space, if any
@@ -141,12 +194,12 @@ ThingSetTextRequestContext::ThingSetTextRequestContext(uint8_t *request, size_t
     char *pathEnd = (char *)memchr(pathStart, ' ', requestLen);
     if (pathEnd != nullptr)
     {
-        _path = std::string(pathStart, pathEnd - pathStart);
-        _decoder = DefaultFixedSizeThingSetTextDecoder(reinterpret_cast<char *>(pathEnd + 1), requestLen - 1 - (pathEnd - pathStart));
+        _path = std::string_view(pathStart, pathEnd - pathStart);
+        _decoder = DefaultThingSetTextDecoder(reinterpret_cast<char *>(pathEnd + 1), requestLen - 1 - (pathEnd - pathStart));
     }
     else
     {
-        _path = std::string(pathStart, requestLen - 1);
+        _path = std::string_view(pathStart, requestLen - 1);
     }
 }
 
@@ -197,6 +250,11 @@ bool ThingSetTextRequestContext::setStatus(const ThingSetStatusCode &status)
     _response[3] = ' ';
     return true;
 }
+
+size_t ThingSetTextRequestContext::getWrittenLength() const
+{
+    return _encoder.getWrittenLength();
+}
 #endif // ENABLE_TEXT_MODE
 
 } // namespace ThingSet
\ No newline at end of file
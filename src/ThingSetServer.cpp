@@ -9,7 +9,6 @@
 #include "thingset++/ThingSet.hpp"
 #include "thingset++/ThingSetCustomRequestHandler.hpp"
 #include "thingset++/ThingSetRegistry.hpp"
-#include <list>
 
 namespace ThingSet {
 
@@ -27,16 +26,36 @@ int _ThingSetServer::handleBinaryRequest(uint8_t *request, size_t requestLen, ui
     return handleRequest(context, request, requestLen, response, responseSize);
 }
 
+int _ThingSetServer::handleBinaryRequest(uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize,
+                                         ThingSetResponseWriter writer)
+{
+    StreamingThingSetBinaryRequestContext context(request, requestLen, response, responseSize, writer);
+    int length = handleRequest(context, request, requestLen, response, responseSize);
+    return context.finishResponse(length);
+}
+
 #ifdef ENABLE_TEXT_MODE
 int _ThingSetServer::handleTextRequest(uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize)
 {
     ThingSetTextRequestContext context(request, requestLen, response, responseSize, _textOpts);
     return handleRequest(context, request, requestLen, response, responseSize);
 }
+
+int _ThingSetServer::handleTextRequest(uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize,
+                                       ThingSetResponseWriter writer)
+{
+    ThingSetTextRequestContext context(request, requestLen, response, responseSize, writer, _textOpts);
+    int length = handleRequest(context, request, requestLen, response, responseSize);
+    return context.finishResponse(length);
+}
 #endif // ENABLE_TEXT_MODE
 
 int _ThingSetServer::handleRequest(ThingSetRequestContext &context, uint8_t *request, size_t requestLen, uint8_t *response, size_t responseSize)
 {
+    // nodes found below must not be unregistered before the response is
+    // written; a streamed response is written while the guard is held, so
+    // writers time out rather than hold up registration indefinitely
+    ThingSetRegistry::ReadGuard guard;
     if (!context.hasValidEndpoint())
     {
         context.setStatus(ThingSetStatusCode::badRequest);
@@ -99,33 +118,28 @@ int _ThingSetServer::handleGet(ThingSetRequestContext &context)
     }
     else if (context.node->tryCastTo(ThingSetNodeType::hasChildren, &target)) {
         ThingSetParentNode *parent = reinterpret_cast<ThingSetParentNode *>(target);
-        // first get a count of encodable child nodes
-        std::list<unsigned> ids;
-        for (ThingSetNode *child : *parent)
-        {
-            if (child->tryCastTo(ThingSetNodeType::encodable, &target))
-            {
-                ids.push_back(child->getId());
-            }
-        }
-        context.encoder().encodeMapStart(ids.size());
+        const uint32_t count = parent->getEncodableChildCount();
+        bool encoded = context.encoder().encodeMapStart(count);
         for (ThingSetNode *child : *parent)
         {
-            if (child->tryCastTo(ThingSetNodeType::encodable, &target))
+            if (encoded && child->tryCastTo(ThingSetNodeType::encodable, &target))
             {
                 ThingSetEncodable *encodable = reinterpret_cast<ThingSetEncodable *>(target);
                 if (context.useIds())
                 {
-                    context.encoder().encode(std::make_pair(child->getId(), encodable));
+                    encoded = context.encoder().encode(std::make_pair(child->getId(), encodable));
                 }
                 else
                 {
-                    context.encoder().encode(std::make_pair(child->getName(), encodable));
+                    encoded = context.encoder().encode(std::make_pair(child->getName(), encodable));
                 }
             }
         }
-        context.encoder().encodeMapEnd(ids.size());
-        return context.encoder().getEncodedLength() + context.getHeaderLength();
+        // if part of a streamed response has already been sent, returning
+        // only the header makes finishResponse give up on the connection
+        if (encoded && context.encoder().encodeMapEnd(count)) {
+            return context.encoder().getEncodedLength() + context.getHeaderLength();
+        }
     }
     context.setStatus(ThingSetStatusCode::unsupportedFormat);
     return context.getHeaderLength();
@@ -140,20 +154,21 @@ int _ThingSetServer::handleFetch(ThingSetRequestContext &context)
         void *target;
         if (context.node->tryCastTo(ThingSetNodeType::hasChildren, &target)) {
             ThingSetParentNode *parent = reinterpret_cast<ThingSetParentNode *>(target);
-            if (context.useIds()) {
-                std::list<unsigned> ids;
-                for (ThingSetNode *child : *parent) {
-                    ids.push_back(child->getId());
-                }
-                context.encoder().encode(ids);
+            uint32_t count = 0;
+            for (ThingSetNode *child : *parent) {
+                (void)child;
+                count++;
             }
-            else {
-                std::list<std::string_view> names;
-                for (ThingSetNode *child : *parent) {
-                    names.push_back(child->getName());
+            context.encoder().encodeListStart(count);
+            for (ThingSetNode *child : *parent) {
+                if (context.useIds()) {
+                    context.encoder().encode(child->getId());
+                }
+                else {
+                    context.encoder().encode(child->getName());
                 }
-                context.encoder().encode(names);
             }
+            context.encoder().encodeListEnd(count);
             return context.encoder().getEncodedLength() + context.getHeaderLength();
         }
         else {
@@ -223,7 +238,7 @@ int _ThingSetServer::handleUpdate(ThingSetRequestContext &context)
         return true;
     };
 
-    if (context.decoder().decodeMap([&](auto id, auto name)
+    auto handleKey = [&](std::optional<uint32_t> id, std::optional<std::string_view> name)
     {
         ThingSetNode *child = nullptr;
         if (id.has_value()) {
@@ -246,7 +261,9 @@ int _ThingSetServer::handleUpdate(ThingSetRequestContext &context)
             return false;
         }
         return handleNodeUpdate(child);
-    }))
+    };
+
+    if (context.decoder().decodeMap(handleKey))
     {
         context.encoder().encodePreamble();
         return context.encoder().getEncodedLength() + context.getHeaderLength();
@@ -265,9 +282,10 @@ int _ThingSetServer::handleExec(ThingSetRequestContext &context)
     void *target;
     if (context.node->tryCastTo(ThingSetNodeType::function, &target)) {
         ThingSetInvocable *invocable = reinterpret_cast<ThingSetInvocable *>(target);
+        // set the status first, as it may be written out along with the start of the result
+        context.setStatus(ThingSetStatusCode::changed);
         context.encoder().encodePreamble();
         if (invocable->invoke(context.decoder(), context.encoder())) {
-            context.setStatus(ThingSetStatusCode::changed);
             return context.encoder().getEncodedLength() + context.getHeaderLength();
         }
     }
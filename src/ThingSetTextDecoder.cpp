@@ -3,15 +3,12 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
-#include "thingset++/internal/jsmn.h"
 #include "thingset++/ThingSetTextDecoder.hpp"
 
 namespace ThingSet {
 
 ThingSetTextDecoder::ThingSetTextDecoder(const char *buffer, const size_t size) : _inputBuffer(buffer), _bufferSize(size), _bufferElemPtr(0), _tokenIndex(0)
-{
-    jsmn_init(&_parser);
-}
+{}
 
 bool ThingSetTextDecoder::getIsForwardOnly() const
 {
@@ -28,6 +25,16 @@ bool ThingSetTextDecoder::decode(std::string *value)
     return true;
 }
 
+bool ThingSetTextDecoder::decode(std::string_view *value)
+{
+    jsmntok *token;
+    if (!expectType(JSMN_STRING, &token)) {
+        return false;
+    }
+    *value = std::string_view(&_inputBuffer[_bufferElemPtr], token->end - token->start);
+    return true;
+}
+
 bool ThingSetTextDecoder::decode(char *value, size_t size)
 {
     jsmntok *token;
@@ -199,7 +206,7 @@ bool ThingSetTextDecoder::isInList() const
 
 ThingSetEncodedNodeType ThingSetTextDecoder::peekType()
 {
-    jsmntok *token = &getTokens()[_tokenIndex];
+    jsmntok *token = getToken();
     switch (token->type)
     {
         case JSMN_PRIMITIVE:
@@ -221,9 +228,20 @@ bool ThingSetTextDecoder::ensureListSize(const size_t size, size_t &elementCount
     return true;
 }
 
+jsmntok *ThingSetTextDecoder::getToken()
+{
+    jsmntok *tokens = getTokens();
+    if (_tokenIndex < _tokenizer.getTokenCount()) {
+        return &tokens[_tokenIndex];
+    }
+    // past the last token, so nothing more can be decoded
+    _endToken = { JSMN_UNDEFINED, (int)_bufferSize, (int)_bufferSize, 0 };
+    return &_endToken;
+}
+
 bool ThingSetTextDecoder::expectType(const jsmntype_t &type, jsmntok **t)
 {
-    jsmntok *token = &getTokens()[_tokenIndex];
+    jsmntok *token = getToken();
     if (t) {
         *t = token;
     }
@@ -243,7 +261,7 @@ bool ThingSetTextDecoder::expectType(const jsmntype_t &type, jsmntok **t)
 bool ThingSetTextDecoder::skip()
 {
     _tokenIndex++;
-    jsmntok *token = &getTokens()[_tokenIndex];
+    jsmntok *token = getToken();
     _bufferElemPtr = token->start;
     return true;
 }
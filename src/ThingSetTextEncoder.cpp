@@ -5,26 +5,63 @@
  */
 
 #include "thingset++/ThingSetTextEncoder.hpp"
-#include <inttypes.h>
+#include <cstdio>
 
 #ifndef CONFIG_THINGSET_PLUS_PLUS_TEXT_FLOAT_PRECISION
 #define CONFIG_THINGSET_PLUS_PLUS_TEXT_FLOAT_PRECISION 6
 #endif
 
-#define TS_PP_STR_(x)    #x
-#define TS_PP_STR(x)     TS_PP_STR_(x)
-#define TS_FLOAT_FORMAT  "%." TS_PP_STR(CONFIG_THINGSET_PLUS_PLUS_TEXT_FLOAT_PRECISION) "f"
-
 namespace ThingSet {
 
+template <typename T> bool ThingSetTextEncoder::appendFloat(const T &value)
+{
+#ifdef __cpp_lib_to_chars
+    if (any(_opts, TextEncoderOptions::shortestFloats)) {
+        return appendNumber(value);
+    }
+    // formats exactly as printf would, so promote floats as it does
+    return appendNumber((double)value, std::chars_format::fixed, CONFIG_THINGSET_PLUS_PLUS_TEXT_FLOAT_PRECISION);
+#else
+    // the standard library has no floating-point to_chars, so fall back to
+    // printf, which ignores shortestFloats
+    for (int attempt = 0; attempt < 2; attempt++) {
+        size_t available = _responseSize - _responsePosition;
+        int length = snprintf(_responseBuffer + _responsePosition, available, "%.*f",
+                              CONFIG_THINGSET_PLUS_PLUS_TEXT_FLOAT_PRECISION, (double)value);
+        if (length < 0) {
+            return false;
+        }
+        // snprintf also writes a null terminator, so needs one more byte
+        if ((size_t)length < available) {
+            _responsePosition += length;
+            return true;
+        }
+        if (!makeRoom()) {
+            return false;
+        }
+    }
+    return false;
+#endif
+}
+
+bool ThingSetTextEncoder::makeRoom()
+{
+    if (_responsePosition < 2 || !writeChunk(_responseBuffer, _responsePosition - 1)) {
+        return false;
+    }
+    _responseBuffer[0] = _responseBuffer[_responsePosition - 1];
+    _responsePosition = 1;
+    return true;
+}
+
 bool ThingSetTextEncoder::encode(const std::string_view &value)
 {
-    return encode(value.data());
+    return append('"') && append(value.data(), value.size()) && append('"');
 }
 
 bool ThingSetTextEncoder::encode(std::string_view &value)
 {
-    return encode(value.data());
+    return encode(static_cast<const std::string_view &>(value));
 }
 
 bool ThingSetTextEncoder::encode(const std::string &value)
@@ -39,7 +76,7 @@ bool ThingSetTextEncoder::encode(std::string &value)
 
 bool ThingSetTextEncoder::encode(const char *value)
 {
-    return append('"') && appendFormat(value, "%s") && append('"');
+    return append('"') && append(value, strlen(value)) && append('"');
 }
 
 bool ThingSetTextEncoder::encode(char *value)
@@ -49,117 +86,117 @@ bool ThingSetTextEncoder::encode(char *value)
 
 bool ThingSetTextEncoder::encode(const float &value)
 {
-    return appendFormat((double)value, TS_FLOAT_FORMAT);
+    return appendFloat(value);
 }
 
 bool ThingSetTextEncoder::encode(const float *value)
 {
-    return appendFormat((double)*value, TS_FLOAT_FORMAT);
+    return appendFloat(*value);
 }
 
 bool ThingSetTextEncoder::encode(const double &value)
 {
-    return appendFormat(value, TS_FLOAT_FORMAT);
+    return appendFloat(value);
 }
 
 bool ThingSetTextEncoder::encode(const double *value)
 {
-    return appendFormat(*value, TS_FLOAT_FORMAT);
+    return appendFloat(*value);
 }
 
 bool ThingSetTextEncoder::encode(const bool &value)
 {
-    return appendFormat(value, "%i");
+    return append(value ? '1' : '0');
 }
 
 bool ThingSetTextEncoder::encode(const bool *value)
 {
-    return appendFormat(*value, "%i");
+    return append(*value ? '1' : '0');
 }
 
 bool ThingSetTextEncoder::encode(const uint8_t &value)
 {
-    return appendFormat(value, "%" PRIu8);
+    return appendNumber(value);
 }
 
 bool ThingSetTextEncoder::encode(const uint8_t *value)
 {
-    return appendFormat(*value, "%" PRIu8);
+    return appendNumber(*value);
 }
 
 bool ThingSetTextEncoder::encode(const uint16_t &value)
 {
-    return appendFormat(value, "%" PRIu16);
+    return appendNumber(value);
 }
 
 bool ThingSetTextEncoder::encode(const uint16_t *value)
 {
-    return appendFormat(*value, "%" PRIu16);
+    return appendNumber(*value);
 }
 
 bool ThingSetTextEncoder::encode(const uint32_t &value)
 {
-    return appendFormat(value, "%" PRIu32);
+    return appendNumber(value);
 }
 
 bool ThingSetTextEncoder::encode(const uint32_t *value)
 {
-    return appendFormat(*value, "%" PRIu32);
+    return appendNumber(*value);
 }
 
 bool ThingSetTextEncoder::encode(const uint64_t &value)
 {
-    return appendFormat(value, "%" PRIu64);
+    return appendNumber(value);
 }
 
 bool ThingSetTextEncoder::encode(const uint64_t *value)
 {
-    return appendFormat(*value, "%" PRIu64);
+    return appendNumber(*value);
 }
 
 bool ThingSetTextEncoder::encode(const int8_t &value)
 {
-    return appendFormat(value, "%" PRIi8);
+    return appendNumber(value);
 }
 
 bool ThingSetTextEncoder::encode(const int8_t *value)
 {
-    return appendFormat(*value, "%" PRIi8);
+    return appendNumber(*value);
 }
 
 bool ThingSetTextEncoder::encode(const int16_t &value)
 {
-    return appendFormat(value, "%" PRIi16);
+    return appendNumber(value);
 }
 
 bool ThingSetTextEncoder::encode(const int16_t *value)
 {
-    return appendFormat(*value, "%" PRIi16);
+    return appendNumber(*value);
 }
 
 bool ThingSetTextEncoder::encode(const int32_t &value)
 {
-    return appendFormat(value, "%" PRIi32);
+    return appendNumber(value);
 }
 
 bool ThingSetTextEncoder::encode(const int32_t *value)
 {
-    return appendFormat(*value, "%" PRIi32);
+    return appendNumber(*value);
 }
 
 bool ThingSetTextEncoder::encode(const int64_t &value)
 {
-    return appendFormat(value, "%" PRIi64);
+    return appendNumber(value);
 }
 
 bool ThingSetTextEncoder::encode(const int64_t *value)
 {
-    return appendFormat(*value, "%" PRIi64);
+    return appendNumber(*value);
 }
 
 bool ThingSetTextEncoder::encodeNull()
 {
-    return appendFormat("null", "%s");
+    return append("null", 4);
 }
 
 bool ThingSetTextEncoder::encodePreamble()
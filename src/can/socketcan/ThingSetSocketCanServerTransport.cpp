@@ -35,7 +35,7 @@ bool ThingSetSocketCanServerTransport::doPublish(const Can::CanID &id, uint8_t *
 }
 
 bool ThingSetSocketCanServerTransport::listen(
-    std::function<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback)
+    Delegate<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback)
 {
     _listener.listen(CanID()
                          .setMessageType(MessageType::requestResponse)
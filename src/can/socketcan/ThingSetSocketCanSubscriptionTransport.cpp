@@ -16,11 +16,11 @@ ThingSetCanInterface &ThingSetSocketCanSubscriptionTransport::getInterface() {
     return _canInterface;
 }
 
-bool ThingSetSocketCanSubscriptionTransport::subscribe(std::function<void(const CanID &, ThingSetBinaryDecoder &)> callback) {
+bool ThingSetSocketCanSubscriptionTransport::subscribe(Delegate<void(const CanID &, ThingSetBinaryDecoder &)> callback) {
     return _listener.run(_canInterface.getDeviceName(), callback);
 }
 
-bool ThingSetSocketCanSubscriptionTransport::SocketCanSubscriptionListener::run(const std::string &deviceName, std::function<void(const CanID &, ThingSetBinaryDecoder &)> callback)
+bool ThingSetSocketCanSubscriptionTransport::SocketCanSubscriptionListener::run(const std::string &deviceName, Delegate<void(const CanID &, ThingSetBinaryDecoder &)> callback)
 {
     _socket.setIsFd(true);
     _socket.setFilter(reportFilter);
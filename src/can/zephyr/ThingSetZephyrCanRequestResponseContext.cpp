@@ -58,7 +58,7 @@ ThingSetZephyrCanInterface &ThingSetZephyrCanRequestResponseContext::getInterfac
     return _canInterface;
 }
 
-bool ThingSetZephyrCanRequestResponseContext::bind(std::function<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback)
+bool ThingSetZephyrCanRequestResponseContext::bind(Delegate<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback)
 {
     return bind(CanID::broadcastAddress, callback);
 }
@@ -71,7 +71,7 @@ void ThingSetZephyrCanRequestResponseContext::unbindIfNecessary()
     }
 }
 
-bool ThingSetZephyrCanRequestResponseContext::bind(uint8_t otherNodeAddress, std::function<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback)
+bool ThingSetZephyrCanRequestResponseContext::bind(uint8_t otherNodeAddress, Delegate<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback)
 {
     unbindIfNecessary();
     auto canId = CanID()
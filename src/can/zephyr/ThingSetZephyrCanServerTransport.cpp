@@ -34,7 +34,7 @@ bool ThingSetZephyrCanServerTransport::doPublish(const Can::CanID &id, uint8_t *
     return result == 0;
 }
 
-bool ThingSetZephyrCanServerTransport::listen(std::function<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback)
+bool ThingSetZephyrCanServerTransport::listen(Delegate<int(const CanID &, uint8_t *, size_t, uint8_t *, size_t)> callback)
 {
     return _requestResponseContext.bind(callback);
 }
@@ -27,7 +27,7 @@ void ThingSetZephyrCanSubscriptionTransport::ZephyrCanSubscriptionListener::runL
     }
 }
 
-bool ThingSetZephyrCanSubscriptionTransport::subscribe(std::function<void(const CanID &, ThingSetBinaryDecoder &)> callback)
+bool ThingSetZephyrCanSubscriptionTransport::subscribe(Delegate<void(const CanID &, ThingSetBinaryDecoder &)> callback)
 {
     return _listener.run(callback);
 }
@@ -78,7 +78,7 @@ void ThingSetZephyrCanControlSubscriptionTransport::ZephyrCanSubscriptionListene
     }
 }
 
-bool ThingSetZephyrCanControlSubscriptionTransport::subscribe(std::function<void(const CanID &, ThingSetBinaryDecoder &)> callback)
+bool ThingSetZephyrCanControlSubscriptionTransport::subscribe(Delegate<void(const CanID &, ThingSetBinaryDecoder &)> callback)
 {
     return _listener.run(callback);
 }
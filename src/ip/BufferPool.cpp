@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "thingset++/ip/BufferPool.hpp"
+#include <utility>
+
+namespace ThingSet::Ip {
+
+BufferLease::BufferLease() : BufferLease(nullptr, nullptr, 0)
+{}
+
+BufferLease::BufferLease(BufferPool *pool, uint8_t *data, size_t size) : _pool(pool), _data(data), _size(size)
+{}
+
+BufferLease::BufferLease(BufferLease &&other) noexcept
+    : _pool(std::exchange(other._pool, nullptr)), _data(std::exchange(other._data, nullptr)),
+      _size(std::exchange(other._size, 0))
+{}
+
+BufferLease &BufferLease::operator=(BufferLease &&other) noexcept
+{
+    if (this != &other) {
+        release();
+        _pool = std::exchange(other._pool, nullptr);
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+    }
+    return *this;
+}
+
+BufferLease::~BufferLease()
+{
+    release();
+}
+
+void BufferLease::release()
+{
+    if (_data != nullptr) {
+        _pool->release(_data);
+        _pool = nullptr;
+        _data = nullptr;
+        _size = 0;
+    }
+}
+
+BufferLease BufferPool::lease(size_t size)
+{
+    size_t actualSize = 0;
+    uint8_t *buffer = acquire(size, actualSize);
+    return buffer != nullptr ? BufferLease(this, buffer, actualSize) : BufferLease();
+}
+
+BufferPool &BufferPool::getDefault()
+{
+    static SizeClassedBufferPool<
+        BufferClass<CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_SMALL_SIZE, CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_SMALL_COUNT>,
+        BufferClass<CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_MEDIUM_SIZE, CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_MEDIUM_COUNT>,
+        BufferClass<CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_LARGE_SIZE, CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_LARGE_COUNT>>
+        pool;
+    return pool;
+}
+
+static inline uint64_t makeHead(uint64_t counter, uint32_t index)
+{
+    return (counter << 32) | index;
+}
+
+BufferFreeList::BufferFreeList(uint8_t *storage, std::atomic<uint32_t> *next, size_t size, size_t count)
+    : _storage(storage), _next(next), _size(size), _count(count), _head(makeHead(0, 0)), _leased(0), _peakLeased(0),
+      _failedLeases(0)
+{
+    for (size_t i = 0; i < count; i++) {
+        _next[i].store(i + 1 < count ? (uint32_t)(i + 1) : none, std::memory_order_relaxed);
+    }
+}
+
+uint8_t *BufferFreeList::acquire()
+{
+    uint64_t head = _head.load(std::memory_order_acquire);
+    uint32_t index;
+    do {
+        index = (uint32_t)head;
+        if (index == none) {
+            return nullptr;
+        }
+        // if another thread takes this buffer first, the next index may be
+        // stale, but then the counter will have changed and the swap will fail
+    } while (!_head.compare_exchange_weak(head, makeHead((head >> 32) + 1, _next[index].load(std::memory_order_relaxed)),
+                                          std::memory_order_acquire, std::memory_order_acquire));
+
+    size_t leased = _leased.fetch_add(1, std::memory_order_relaxed) + 1;
+    size_t peak = _peakLeased.load(std::memory_order_relaxed);
+    while (leased > peak && !_peakLeased.compare_exchange_weak(peak, leased, std::memory_order_relaxed)) {
+    }
+    return _storage + index * _size;
+}
+
+void BufferFreeList::release(uint8_t *buffer)
+{
+    uint32_t index = (uint32_t)((buffer - _storage) / _size);
+    uint64_t head = _head.load(std::memory_order_relaxed);
+    do {
+        _next[index].store((uint32_t)head, std::memory_order_relaxed);
+    } while (!_head.compare_exchange_weak(head, makeHead((head >> 32) + 1, index), std::memory_order_release,
+                                          std::memory_order_relaxed));
+    _leased.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool BufferFreeList::owns(const uint8_t *buffer) const
+{
+    return buffer >= _storage && buffer < _storage + _size * _count;
+}
+
+void BufferFreeList::recordFailure()
+{
+    _failedLeases.fetch_add(1, std::memory_order_relaxed);
+}
+
+BufferPoolMetrics BufferFreeList::getMetrics() const
+{
+    return BufferPoolMetrics{
+        .size = _size,
+        .count = _count,
+        .leased = _leased.load(std::memory_order_relaxed),
+        .peakLeased = _peakLeased.load(std::memory_order_relaxed),
+        .failedLeases = _failedLeases.load(std::memory_order_relaxed),
+    };
+}
+
+} // namespace ThingSet::Ip
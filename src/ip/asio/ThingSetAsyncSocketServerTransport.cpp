@@ -8,10 +8,13 @@
 #include <asio/detached.hpp>
 #include <asio/ip/tcp.hpp>
 #include <asio/ip/udp.hpp>
+#include <asio/steady_timer.hpp>
 #include <asio/write.hpp>
 #include <thingset++/ip/asio/ThingSetAsyncSocketServerTransport.hpp>
 #include <thingset++/ip/InterfaceInfo.hpp>
+#include <algorithm>
 #include <iostream>
+#include <poll.h>
 
 #define SOCKET_TRANSPORT_MAX_CONNECTIONS 10
 
@@ -24,12 +27,36 @@ using asio::ip::udp;
 
 namespace ThingSet::Ip::Async {
 
+// writes synchronously, but gives up if the client accepts nothing for a
+// while, as streamed responses are written while the registry is being read,
+// which holds up registration
+static bool writeWithTimeout(tcp::socket &socket, const uint8_t *buffer, size_t length)
+{
+    asio::error_code error;
+    socket.non_blocking(true, error);
+    while (length > 0 && !error) {
+        size_t written = socket.write_some(asio::buffer(buffer, length), error);
+        buffer += written;
+        length -= written;
+        if (error == asio::error::would_block) {
+            pollfd descriptor = {};
+            descriptor.fd = socket.native_handle();
+            descriptor.events = POLLOUT;
+            if (poll(&descriptor, 1, THINGSET_PLUS_PLUS_ASYNC_SOCKET_SERVER_SEND_TIMEOUT_MS) > 0) {
+                error.clear();
+            }
+        }
+    }
+    return length == 0;
+}
+
 ThingSetAsyncSocketServerTransport::ThingSetAsyncSocketServerTransport(asio::io_context &ioContext, const asio::ip::address_v4 bindAddress, const asio::ip::address_v4 broadcastAddress) :
     _ioContext(ioContext),
     _publishSocket(ioContext),
     _bindAddress(bindAddress),
     _broadcastAddress(broadcastAddress),
-    _signals(_ioContext, SIGINT, SIGTERM)
+    _signals(_ioContext, SIGINT, SIGTERM),
+    _bufferPool(&BufferPool::getDefault())
 {
 }
 
@@ -49,15 +76,47 @@ ThingSetAsyncSocketServerTransport::ThingSetAsyncSocketServerTransport(asio::io_
 }
 
 awaitable<void> ThingSetAsyncSocketServerTransport::handle(asio::ip::tcp::socket socket,
-    std::function<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback)
+    Delegate<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback)
 {
-    char request[1024];
-    char response[1024];
+    const size_t maxRequestLength = THINGSET_PLUS_PLUS_ASYNC_SOCKET_SERVER_RX_BUFFER_SIZE;
+    const size_t maxResponseLength = THINGSET_PLUS_PLUS_ASYNC_SOCKET_SERVER_TX_BUFFER_SIZE;
     for (;;) {
-        std::size_t n = co_await socket.async_read_some(asio::buffer(request), use_awaitable);
+        // hold no buffers while waiting for a request, then lease them sized to it
+        co_await socket.async_wait(tcp::socket::wait_read, use_awaitable);
+        asio::error_code error;
+        size_t available = std::clamp(socket.available(error), (size_t)1, maxRequestLength);
+        BufferLease request = _bufferPool->lease(available);
+        BufferLease response = _bufferPool->lease(maxResponseLength);
+        if (!request || !response) {
+            // the pool is exhausted; wait for other connections to return buffers
+            asio::steady_timer timer(socket.get_executor(), std::chrono::milliseconds(1));
+            co_await timer.async_wait(use_awaitable);
+            continue;
+        }
+        std::size_t n = co_await socket.async_read_some(
+            asio::buffer(request.data(), std::min(request.size(), maxRequestLength)), use_awaitable);
         tcp::endpoint remoteEndpoint = socket.remote_endpoint();
-        int responseLength = callback(remoteEndpoint, (uint8_t *)request, n, (uint8_t *)response, sizeof(response));
-        co_await async_write(socket, asio::buffer(response, responseLength), use_awaitable);
+        int responseLength;
+        if (_streamingCallback) {
+            // parts of a response which do not fit in the buffer are written as
+            // they are encoded; the callback cannot suspend, so they are written
+            // synchronously
+            auto writer = [&socket](const uint8_t *buffer, size_t length) {
+                return writeWithTimeout(socket, buffer, length);
+            };
+            responseLength = _streamingCallback(remoteEndpoint, request.data(), n, response.data(), maxResponseLength,
+                                                writer);
+        }
+        else {
+            responseLength = callback(remoteEndpoint, request.data(), n, response.data(), maxResponseLength);
+        }
+        if (responseLength < 0) {
+            // the response could not be completed after part of it was sent
+            break;
+        }
+        // the request is no longer needed while the response is written
+        request.release();
+        co_await async_write(socket, asio::buffer(response.data(), responseLength), use_awaitable);
     }
 }
 
@@ -68,7 +127,7 @@ ThingSetAsyncSocketServerTransport::~ThingSetAsyncSocketServerTransport()
     _publishSocket.close(error);
 }
 
-awaitable<void> ThingSetAsyncSocketServerTransport::listener(std::function<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback)
+awaitable<void> ThingSetAsyncSocketServerTransport::listener(Delegate<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback)
 {
     auto executor = co_await asio::this_coro::executor;
     tcp::acceptor acceptor(executor, { _bindAddress, 9001 });
@@ -78,7 +137,7 @@ awaitable<void> ThingSetAsyncSocketServerTransport::listener(std::function<int(c
     }
 }
 
-bool ThingSetAsyncSocketServerTransport::listen(std::function<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback)
+bool ThingSetAsyncSocketServerTransport::listen(Delegate<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback)
 {
     _signals.async_wait([&](auto, auto) { _ioContext.stop(); });
 
@@ -96,6 +155,20 @@ bool ThingSetAsyncSocketServerTransport::listen(std::function<int(const asio::ip
     return true;
 }
 
+bool ThingSetAsyncSocketServerTransport::listen(
+    Delegate<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback,
+    Delegate<int(const asio::ip::tcp::endpoint &, uint8_t *, size_t, uint8_t *, size_t, ThingSetResponseWriter)>
+        streamingCallback)
+{
+    _streamingCallback = streamingCallback;
+    return listen(callback);
+}
+
+void ThingSetAsyncSocketServerTransport::setBufferPool(BufferPool &pool)
+{
+    _bufferPool = &pool;
+}
+
 bool ThingSetAsyncSocketServerTransport::publish(uint8_t *buffer, size_t len)
 {
     if (_publishSocket.is_open()) {
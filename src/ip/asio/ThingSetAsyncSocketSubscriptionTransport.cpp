@@ -27,7 +27,7 @@ ThingSetAsyncSocketSubscriptionTransport::~ThingSetAsyncSocketSubscriptionTransp
     _subscribeSocket.close(error);
 }
 
-awaitable<void> ThingSetAsyncSocketSubscriptionTransport::listener(std::function<void(const asio::ip::udp::endpoint &, ThingSetBinaryDecoder &)> callback)
+awaitable<void> ThingSetAsyncSocketSubscriptionTransport::listener(Delegate<void(const asio::ip::udp::endpoint &, ThingSetBinaryDecoder &)> callback)
 {
     std::map<asio::ip::udp::endpoint, StreamingUdpThingSetBinaryDecoder>  decodersBySender;
     for (;;) {
@@ -39,7 +39,7 @@ awaitable<void> ThingSetAsyncSocketSubscriptionTransport::listener(std::function
     }
 }
 
-bool ThingSetAsyncSocketSubscriptionTransport::subscribe(std::function<void(const asio::ip::udp::endpoint &, ThingSetBinaryDecoder &)> callback)
+bool ThingSetAsyncSocketSubscriptionTransport::subscribe(Delegate<void(const asio::ip::udp::endpoint &, ThingSetBinaryDecoder &)> callback)
 {
     asio::error_code error;
     _subscribeSocket.open(asio::ip::udp::v4(), error);
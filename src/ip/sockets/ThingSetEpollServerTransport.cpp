@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "thingset++/ip/sockets/ThingSetEpollServerTransport.hpp"
+#include "thingset++/internal/logging.hpp"
+#include "thingset++/ip/InterfaceInfo.hpp"
+#include <array>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace ThingSet::Ip::Sockets {
+
+static std::pair<in_addr, in_addr> getLocalIpAndSubnet()
+{
+    in_addr ipAddress = {
+        .s_addr = 0x0100007f,
+    };
+    in_addr subnet = {
+        .s_addr = 0x000000ff,
+    };
+    return std::make_pair(ipAddress, subnet);
+}
+
+static std::pair<in_addr, in_addr> getIpAndSubnetForInterface(const std::string &interface)
+{
+    in_addr address;
+    in_addr subnet;
+    InterfaceInfo::get(interface, address, subnet);
+    return std::make_pair(address, subnet);
+}
+
+ThingSetEpollServerTransport::ThingSetEpollServerTransport() : ThingSetEpollServerTransport(getLocalIpAndSubnet())
+{}
+
+ThingSetEpollServerTransport::ThingSetEpollServerTransport(const std::string &interface)
+    : ThingSetEpollServerTransport(getIpAndSubnetForInterface(interface))
+{}
+
+ThingSetEpollServerTransport::ThingSetEpollServerTransport(const std::pair<in_addr, in_addr> &ipAddressAndSubnet)
+    : _ThingSetSocketServerTransport(ipAddressAndSubnet), _epollHandle(epoll_create1(EPOLL_CLOEXEC)),
+      _stopHandle(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+    if (_epollHandle < 0 || _stopHandle < 0) {
+        throw std::runtime_error("Failed to create event loop");
+    }
+}
+
+ThingSetEpollServerTransport::~ThingSetEpollServerTransport()
+{
+    if (_eventThread.joinable()) {
+        eventfd_write(_stopHandle, 1);
+        _eventThread.join();
+    }
+    for (int socketHandle : _connections) {
+        close(socketHandle);
+    }
+    _connections.clear();
+    close(_stopHandle);
+    close(_epollHandle);
+}
+
+static bool addToEpoll(int epollHandle, int socketHandle)
+{
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = socketHandle;
+    return epoll_ctl(epollHandle, EPOLL_CTL_ADD, socketHandle, &event) == 0;
+}
+
+void ThingSetEpollServerTransport::startThreads()
+{
+    // listen before starting the thread, so that clients can connect as soon
+    // as the server is listening
+    if (fcntl(_listenSocketHandle, F_SETFL, O_NONBLOCK) != 0) {
+        LOG_ERROR("Failed to configure socket: %d", errno);
+        return;
+    }
+
+    if (::listen(_listenSocketHandle, SOMAXCONN) != 0) {
+        LOG_ERROR("Failed to begin listening: %d", errno);
+        return;
+    }
+
+    if (!addToEpoll(_epollHandle, _listenSocketHandle) || !addToEpoll(_epollHandle, _stopHandle)) {
+        LOG_ERROR("Failed to add to event loop: %d", errno);
+        return;
+    }
+
+    _eventThread = std::thread([&]()
+    {
+        runEventLoop();
+    });
+}
+
+void ThingSetEpollServerTransport::runEventLoop()
+{
+    std::array<epoll_event, 64> events;
+    while (true) {
+        int count = epoll_wait(_epollHandle, events.data(), events.size(), -1);
+        if (count < 0) {
+            if (errno != EINTR) {
+                LOG_ERROR("Event loop error: %d", errno);
+            }
+            continue;
+        }
+
+        for (int i = 0; i < count; i++) {
+            int socketHandle = events[i].data.fd;
+            if (socketHandle == _stopHandle) {
+                LOG_INFO("Shut down event thread");
+                return;
+            }
+            else if (socketHandle == _listenSocketHandle) {
+                acceptConnections();
+            }
+            else if (events[i].events & EPOLLERR) {
+                closeConnection(socketHandle);
+            }
+            else if (!serve(socketHandle)) {
+                closeConnection(socketHandle);
+            }
+        }
+    }
+}
+
+void ThingSetEpollServerTransport::acceptConnections()
+{
+    // the listen socket does not block, so accept everything waiting
+    while (true) {
+        SocketEndpoint clientAddr;
+        socklen_t clientAddrLen = sizeof(clientAddr);
+        int socketHandle = accept4(_listenSocketHandle, (sockaddr *)&clientAddr, &clientAddrLen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (socketHandle < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_ERROR("Accept failed: %d", errno);
+            }
+            return;
+        }
+
+        if (!addToEpoll(_epollHandle, socketHandle)) {
+            LOG_ERROR("Failed to add socket %d to event loop: %d", socketHandle, errno);
+            close(socketHandle);
+            continue;
+        }
+        _connections.insert(socketHandle);
+    }
+}
+
+void ThingSetEpollServerTransport::closeConnection(int socketHandle)
+{
+    // closing the last descriptor for a socket also removes it from epoll
+    close(socketHandle);
+    _connections.erase(socketHandle);
+}
+
+} // namespace ThingSet::Ip::Sockets
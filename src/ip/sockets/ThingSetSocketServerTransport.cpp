@@ -7,7 +7,9 @@
 #include "thingset++/ip/sockets/ThingSetSocketServerTransport.hpp"
 #include "thingset++/internal/logging.hpp"
 #include <assert.h>
+#include <algorithm>
 #include <array>
+#include <cstring>
 
 #ifdef __ZEPHYR__
 #include "thingset++/ip/sockets/ZephyrStubs.h"
@@ -15,6 +17,9 @@
 #include <zephyr/posix/fcntl.h>
 
 #define FCNTL zsock_fcntl
+#ifndef MSG_DONTWAIT
+#define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
+#endif
 
 K_THREAD_STACK_DEFINE(acceptThreadStack, CONFIG_THINGSET_PLUS_PLUS_SOCKET_ACCEPT_THREAD_STACK_SIZE);
 static struct k_thread acceptThread;
@@ -26,6 +31,7 @@ static struct k_thread handlerThread;
 #include <netinet/in.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <chrono>
 #include <iostream>
 
 #define __ASSERT(test, fmt, ...) { if (!(test)) { throw std::invalid_argument(fmt); } }
@@ -34,6 +40,10 @@ static struct k_thread handlerThread;
 
 namespace ThingSet::Ip::Sockets {
 
+static_assert(THINGSET_PLUS_PLUS_SOCKET_SERVER_RX_BUFFER_SIZE <= CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_LARGE_SIZE
+                  && THINGSET_PLUS_PLUS_SOCKET_SERVER_TX_BUFFER_SIZE <= CONFIG_THINGSET_PLUS_PLUS_BUFFER_POOL_LARGE_SIZE,
+              "Socket server buffers must fit in the largest buffers in the default pool");
+
 _ThingSetSocketServerTransport::PollDescriptor::PollDescriptor()
 {
     fd = -1;
@@ -41,8 +51,20 @@ _ThingSetSocketServerTransport::PollDescriptor::PollDescriptor()
 }
 
 _ThingSetSocketServerTransport::_ThingSetSocketServerTransport(const std::pair<in_addr, in_addr> &ipAddressAndSubnet)
-    : _publishSocketHandle(-1), _listenSocketHandle(-1), _runHandler(true), _runAcceptor(true)
+    : _publishSocketHandle(-1), _listenSocketHandle(-1), _bufferPool(&BufferPool::getDefault()), _runHandler(true),
+      _runAcceptor(true)
 {
+#ifndef __ZEPHYR__
+    _workerCount = 0;
+    _runWorkers = false;
+    _readyStart = 0;
+    _readyCount = 0;
+    _finishedCount = 0;
+    _acceptedCount = 0;
+    _wakePipe[0] = -1;
+    _wakePipe[1] = -1;
+#endif // __ZEPHYR__
+
     // calculate broadcast address
     _broadcastAddress.sin_family = AF_INET;
     _broadcastAddress.sin_port = htons(9002);
@@ -73,6 +95,11 @@ _ThingSetSocketServerTransport::_ThingSetSocketServerTransport(const std::pair<i
 
     _listenSocketHandle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
     __ASSERT(_listenSocketHandle >= 0, "Failed to create listen socket: %d", errno);
+
+    // allow binding while connections from a previous server on this port are
+    // still closing
+    ret = setsockopt(_listenSocketHandle, SOL_SOCKET, SO_REUSEADDR, &optionValue, sizeof(optionValue));
+    __ASSERT(ret == 0, "Failed to configure listen socket: %d", errno);
 }
 
 _ThingSetSocketServerTransport::~_ThingSetSocketServerTransport()
@@ -83,7 +110,7 @@ _ThingSetSocketServerTransport::~_ThingSetSocketServerTransport()
     _listenSocketHandle = -1;
 }
 
-bool _ThingSetSocketServerTransport::listen(std::function<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback)
+bool _ThingSetSocketServerTransport::listen(Delegate<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback)
 {
     if (bind(_publishSocketHandle, (struct sockaddr *)&_publishAddress, sizeof(_publishAddress))) {
         return false;
@@ -98,6 +125,34 @@ bool _ThingSetSocketServerTransport::listen(std::function<int(const SocketEndpoi
     return true;
 }
 
+bool _ThingSetSocketServerTransport::listen(
+    Delegate<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback,
+    Delegate<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t, ThingSetResponseWriter)> streamingCallback)
+{
+    _streamingCallback = streamingCallback;
+    return listen(callback);
+}
+
+void _ThingSetSocketServerTransport::setBufferPool(BufferPool &pool)
+{
+    _bufferPool = &pool;
+}
+
+#ifndef __ZEPHYR__
+bool _ThingSetSocketServerTransport::setWorkerCount(size_t count)
+{
+#ifndef ENABLE_CONCURRENT_REGISTRY
+    if (count > 0) {
+        LOG_ERROR("Worker threads need ENABLE_CONCURRENT_REGISTRY");
+        _workerCount = 0;
+        return false;
+    }
+#endif // ENABLE_CONCURRENT_REGISTRY
+    _workerCount = count;
+    return true;
+}
+#endif // __ZEPHYR__
+
 bool _ThingSetSocketServerTransport::publish(uint8_t *buffer, size_t len)
 {
     buffer[1] = _messageNumber;
@@ -164,6 +219,7 @@ void _ThingSetSocketServerTransport::runAcceptor()
 
         //std::cout << "Connection from " << clientAddr << std::endl;
 
+#ifdef __ZEPHYR__
         for (int i = 0; i < THINGSET_SERVER_MAX_CLIENTS; i++) {
             if (_socketDescriptors[i].fd == -1) {
                 _socketDescriptors[i].fd = client_sock;
@@ -171,6 +227,9 @@ void _ThingSetSocketServerTransport::runAcceptor()
                 break;
             }
         }
+#else
+        handOver(client_sock);
+#endif // __ZEPHYR__
     }
 
     LOG_INFO("Shut down acceptor thread");
@@ -193,11 +252,132 @@ static void setBlocking(int fd, bool val)
     __ASSERT(fl != -1, "fcntl(F_SETFL): %d", errno);
 }
 
+// gives up if the client accepts nothing for a while, as streamed responses
+// are sent while the registry is being read, which holds up registration
+static bool sendAll(int socketHandle, const uint8_t *buffer, size_t length)
+{
+    setBlocking(socketHandle, false);
+    while (length > 0) {
+        ssize_t sent = send(socketHandle, buffer, length, 0);
+        if (sent < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_ERROR("Send failed with error %d", errno);
+                break;
+            }
+            pollfd descriptor = {};
+            descriptor.fd = socketHandle;
+            descriptor.events = POLLOUT;
+            if (poll(&descriptor, 1, THINGSET_PLUS_PLUS_SOCKET_SERVER_SEND_TIMEOUT_MS) <= 0) {
+                LOG_ERROR("Send timed out");
+                break;
+            }
+            continue;
+        }
+        buffer += sent;
+        length -= sent;
+    }
+    return length == 0;
+}
+
+int _ThingSetSocketServerTransport::receive(int socketHandle, BufferLease &request)
+{
+    const size_t maxLength = THINGSET_PLUS_PLUS_SOCKET_SERVER_RX_BUFFER_SIZE;
+    size_t length = 0;
+    int flags = 0;
+    for (;;) {
+        ssize_t received = recv(socketHandle, request.data() + length, std::min(request.size(), maxLength) - length, flags);
+        if (received <= 0) {
+            // once some of the request has been received, there is nothing more waiting
+            return length > 0 ? (int)length : (int)received;
+        }
+        length += received;
+        if (length < request.size() || length >= maxLength) {
+            return length;
+        }
+        // the buffer is full, so there may be more; move to a larger one and
+        // receive whatever else has already arrived
+        BufferLease larger = _bufferPool->lease(request.size() + 1);
+        if (!larger) {
+            return length;
+        }
+        memcpy(larger.data(), request.data(), length);
+        request = std::move(larger);
+        flags = MSG_DONTWAIT;
+    }
+}
+
+bool _ThingSetSocketServerTransport::serve(int socketHandle)
+{
+    // buffers are only leased while a request is handled; if the pool
+    // is exhausted, the request is left waiting until the next poll
+    BufferLease response = _bufferPool->lease(THINGSET_PLUS_PLUS_SOCKET_SERVER_TX_BUFFER_SIZE);
+    // start with the smallest buffer, as most requests are short
+    BufferLease request = _bufferPool->lease(1);
+    if (!response || !request) {
+        // the request stays waiting, so poll would find it again at once;
+        // give other connections a chance to return their buffers first
+        LOG_WARN("No buffer free for request");
+#ifdef __ZEPHYR__
+        k_msleep(1);
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif // __ZEPHYR__
+        return true;
+    }
+    int rxLen = receive(socketHandle, request);
+
+    if (rxLen < 0) {
+        LOG_ERROR("Receive error: %d", errno);
+        return true;
+    }
+    else if (rxLen == 0) {
+        return false;
+    }
+
+    SocketEndpoint addr;
+    socklen_t len = sizeof(addr);
+    getpeername(socketHandle, (sockaddr *)&addr, &len);
+    int txLen;
+    if (_streamingCallback) {
+        // responses larger than the buffer are sent as they are encoded
+        auto writer = [socketHandle](const uint8_t *buffer, size_t length) {
+            return sendAll(socketHandle, buffer, length);
+        };
+        txLen = _streamingCallback(addr, request.data(), rxLen, response.data(),
+                                   THINGSET_PLUS_PLUS_SOCKET_SERVER_TX_BUFFER_SIZE, writer);
+    }
+    else {
+        txLen = _callback(addr, request.data(), rxLen, response.data(), THINGSET_PLUS_PLUS_SOCKET_SERVER_TX_BUFFER_SIZE);
+    }
+    if (txLen > 0) {
+        if (!sendAll(socketHandle, response.data(), txLen)) {
+            // some of the response may have been sent, so the client could
+            // not tell where the next one starts
+            LOG_ERROR("Send to %x failed", addr.sin_addr.s_addr);
+            return false;
+        }
+    }
+    // if part of a response was sent, but the rest could not be, close the
+    // connection rather than leave the client waiting
+    return txLen >= 0;
+}
+
 void _ThingSetSocketServerTransport::runHandler()
 {
     while (_runHandler) {
         int ret = poll(_socketDescriptors.data(), _socketDescriptors.size(), 10);
 
+#ifndef __ZEPHYR__
+        if (_socketDescriptors[THINGSET_SERVER_MAX_CLIENTS].revents & POLLIN) {
+            uint8_t wake[THINGSET_SERVER_MAX_CLIENTS];
+            while (read(_wakePipe[0], wake, sizeof(wake)) > 0) {
+            }
+        }
+        // connections handed over since the last poll have no events yet,
+        // so can be polled from the next one
+        takeHandovers();
+#endif // __ZEPHYR__
+
         if (ret < 0) {
             LOG_ERROR("Polling error: %d", errno);
         }
@@ -205,41 +385,19 @@ void _ThingSetSocketServerTransport::runHandler()
             continue;
         }
 
-        SocketEndpoint addr;
-        socklen_t len = sizeof(addr);
         for (int i = 0; i < THINGSET_SERVER_MAX_CLIENTS; i++) {
             if (_socketDescriptors[i].revents & POLLIN) {
-                int clientSocketHandle = _socketDescriptors[i].fd;
-
-                int rxLen = recv(clientSocketHandle, _rxBuf, sizeof(_rxBuf), 0);
-
-                if (rxLen < 0) {
-                    LOG_ERROR("Receive error: %d", errno);
+#ifndef __ZEPHYR__
+                if (_workerCount > 0) {
+                    dispatch(i);
+                    continue;
                 }
-                else if (rxLen == 0) {
-                    getpeername(clientSocketHandle, (sockaddr *)&addr, &len);
-                    //std::cout << "Closing connection from " << addr << std::endl;
-
+#endif // __ZEPHYR__
+                int clientSocketHandle = _socketDescriptors[i].fd;
+                if (!serve(clientSocketHandle)) {
                     close(clientSocketHandle);
                     _socketDescriptors[i].fd = -1;
                 }
-                else {
-                    getpeername(clientSocketHandle, (sockaddr *)&addr, &len);
-                    int txLen = _callback(addr, _rxBuf, rxLen, _txBuf, sizeof(_txBuf));
-                    if (txLen > 0) {
-                        setBlocking(clientSocketHandle, true);
-                        int sent;
-                        for (uint8_t *txB = _txBuf; txLen; txLen -= sent) {
-                            sent = send(clientSocketHandle, txB, txLen, 0);
-                            if (sent < 0) {
-                                LOG_ERROR("Send to %x failed with error %d", addr.sin_addr.s_addr, errno);
-                                break;
-                            }
-                            txB += sent;
-                        }
-                        setBlocking(clientSocketHandle, false);
-                    }
-                }
             }
         }
     }
@@ -247,6 +405,139 @@ void _ThingSetSocketServerTransport::runHandler()
     LOG_INFO("Shut down handler thread");
 }
 
+#ifndef __ZEPHYR__
+void _ThingSetSocketServerTransport::startWorkers()
+{
+    // without the pipe, connections handed over wait for the next poll to
+    // time out
+    if (pipe(_wakePipe) == 0) {
+        setBlocking(_wakePipe[0], false);
+        setBlocking(_wakePipe[1], false);
+        _socketDescriptors[THINGSET_SERVER_MAX_CLIENTS].fd = _wakePipe[0];
+    }
+    else {
+        LOG_ERROR("Failed to create wake pipe: %d", errno);
+        _wakePipe[0] = -1;
+        _wakePipe[1] = -1;
+    }
+
+    if (_workerCount == 0) {
+        return;
+    }
+    _runWorkers = true;
+    for (size_t i = 0; i < _workerCount; i++) {
+        _workers.emplace_back([&]()
+        {
+            runWorker();
+        });
+    }
+}
+
+void _ThingSetSocketServerTransport::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(_readyLock);
+        _runWorkers = false;
+    }
+    _readyCondition.notify_all();
+    for (std::thread &worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+    if (_wakePipe[0] >= 0) {
+        close(_wakePipe[0]);
+        close(_wakePipe[1]);
+        _wakePipe[0] = -1;
+        _wakePipe[1] = -1;
+    }
+}
+
+void _ThingSetSocketServerTransport::dispatch(size_t slot)
+{
+    {
+        std::lock_guard<std::mutex> lock(_readyLock);
+        _ready[(_readyStart + _readyCount) % _ready.size()] = { slot, _socketDescriptors[slot].fd };
+        _readyCount++;
+    }
+    // poll ignores negative descriptors, so this stops the connection being
+    // polled, and so dispatched again, until the worker hands it back; -1 is
+    // kept for free slots
+    _socketDescriptors[slot].fd = -2 - _socketDescriptors[slot].fd;
+    _readyCondition.notify_one();
+}
+
+void _ThingSetSocketServerTransport::runWorker()
+{
+    while (true) {
+        Handover connection;
+        {
+            std::unique_lock<std::mutex> lock(_readyLock);
+            _readyCondition.wait(lock, [&]() { return !_runWorkers || _readyCount > 0; });
+            if (!_runWorkers) {
+                break;
+            }
+            connection = _ready[_readyStart];
+            _readyStart = (_readyStart + 1) % _ready.size();
+            _readyCount--;
+        }
+
+        if (!serve(connection.fd)) {
+            close(connection.fd);
+            connection.fd = -1;
+        }
+
+        // hand the connection back, and wake the handler so that it polls
+        // the connection again straight away
+        {
+            std::lock_guard<std::mutex> lock(_readyLock);
+            _finished[_finishedCount++] = connection;
+        }
+        uint8_t wake = 0;
+        [[maybe_unused]] ssize_t written = write(_wakePipe[1], &wake, sizeof(wake));
+    }
+}
+
+void _ThingSetSocketServerTransport::handOver(int fd)
+{
+    {
+        std::lock_guard<std::mutex> lock(_readyLock);
+        if (_acceptedCount == _accepted.size()) {
+            LOG_WARN("Too many connections waiting for a slot");
+            close(fd);
+            return;
+        }
+        _accepted[_acceptedCount++] = fd;
+    }
+    uint8_t wake = 0;
+    [[maybe_unused]] ssize_t written = write(_wakePipe[1], &wake, sizeof(wake));
+}
+
+void _ThingSetSocketServerTransport::takeHandovers()
+{
+    std::lock_guard<std::mutex> lock(_readyLock);
+    // connections which workers have finished with first, as they may
+    // free slots for those newly accepted
+    for (size_t i = 0; i < _finishedCount; i++) {
+        _socketDescriptors[_finished[i].slot].fd = _finished[i].fd;
+    }
+    _finishedCount = 0;
+    for (size_t i = 0; i < _acceptedCount; i++) {
+        size_t slot = 0;
+        while (slot < THINGSET_SERVER_MAX_CLIENTS && _socketDescriptors[slot].fd != -1) {
+            slot++;
+        }
+        if (slot == THINGSET_SERVER_MAX_CLIENTS) {
+            LOG_WARN("No slot free for socket %d", _accepted[i]);
+            close(_accepted[i]);
+            continue;
+        }
+        _socketDescriptors[slot].fd = _accepted[i];
+        LOG_DEBUG("Assigned slot %zu to socket %d", slot, _accepted[i]);
+    }
+    _acceptedCount = 0;
+}
+#endif // __ZEPHYR__
+
 #ifdef __ZEPHYR__
 static std::pair<in_addr, in_addr> getIpAndSubnetForInterface(net_if *iface)
 {
@@ -313,12 +604,19 @@ ThingSetSocketServerTransport::~ThingSetSocketServerTransport()
 {
     _runHandler = false;
     _runAcceptor = false;
-    _handlerThread.join();
-    _acceptorThread.join();
+    // there are no threads if the transport never listened
+    if (_handlerThread.joinable()) {
+        _handlerThread.join();
+    }
+    if (_acceptorThread.joinable()) {
+        _acceptorThread.join();
+    }
+    stopWorkers();
 }
 
 void ThingSetSocketServerTransport::startThreads()
 {
+    startWorkers();
     _handlerThread = std::thread([&]()
     {
         runHandler();
@@ -46,7 +46,7 @@ _ThingSetSocketSubscriptionTransport::~_ThingSetSocketSubscriptionTransport()
     _listenSocketHandle = -1;
 }
 
-bool _ThingSetSocketSubscriptionTransport::subscribe(std::function<void(const SocketEndpoint &, ThingSetBinaryDecoder &)> callback)
+bool _ThingSetSocketSubscriptionTransport::subscribe(Delegate<void(const SocketEndpoint &, ThingSetBinaryDecoder &)> callback)
 {
     int ret = bind(_listenSocketHandle, (sockaddr *)&_listenAddress, sizeof(_listenAddress));
 
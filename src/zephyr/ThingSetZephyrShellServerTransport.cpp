@@ -19,7 +19,7 @@ StreamingZephyrShellThingSetBinaryEncoder ThingSetZephyrShellServerTransport::ge
     return StreamingZephyrShellThingSetBinaryEncoder(enhanced);
 }
 
-bool ThingSetZephyrShellServerTransport::listen(std::function<int(const EmptyIdentifier &, uint8_t *, size_t, uint8_t *, size_t)> callback)
+bool ThingSetZephyrShellServerTransport::listen(Delegate<int(const EmptyIdentifier &, uint8_t *, size_t, uint8_t *, size_t)> callback)
 {
     _callback = callback;
     return true;
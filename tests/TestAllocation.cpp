@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <thingset++/ThingSet.hpp>
+#include <thingset++/ThingSetServer.hpp>
+#include "gtest/gtest.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace ThingSet;
+
+// Count every heap allocation made by the test application, so that tests
+// can assert that particular operations make none
+static std::atomic<size_t> allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+/// Exposes request handling of the server without any transport.
+class DirectServer : public _ThingSetServer
+{
+public:
+    DirectServer() : _ThingSetServer(nullptr)
+    {}
+
+    bool listen() override
+    {
+        return true;
+    }
+
+    using _ThingSetServer::handleBinaryRequest;
+};
+
+} // namespace
+
+static ThingSetGroup<0x1400, 0, "Alloc"> allocGroup;
+static ThingSetReadWriteProperty<float> allocVoltage { 0x1401, 0x1400, "voltage" };
+static ThingSetReadWriteProperty<uint32_t> allocCount { 0x1402, 0x1400, "count" };
+static ThingSetUserFunction<0x1410, 0x1400, "xAdd", int, int, int> allocAdd([](int x, int y) { return x + y; });
+
+#define REQUEST(verb)                                                                                                  \
+    uint8_t request[64];                                                                                               \
+    uint8_t response[64];                                                                                              \
+    request[0] = (uint8_t)verb;                                                                                        \
+    FixedDepthThingSetBinaryEncoder encoder(request + 1, sizeof(request) - 1, 2);                                      \
+    DirectServer server;
+
+#define ASSERT_NO_ALLOCATIONS(statement)                                                                               \
+    {                                                                                                                  \
+        size_t before = allocations;                                                                                   \
+        statement;                                                                                                     \
+        ASSERT_EQ(before, allocations.load());                                                                         \
+    }
+
+TEST(Allocation, GetById)
+{
+    REQUEST(ThingSetBinaryRequestType::get);
+    encoder.encode((uint16_t)0x1401);
+    int length;
+    ASSERT_NO_ALLOCATIONS(length = server.handleBinaryRequest(request, encoder.getEncodedLength() + 1, response,
+                                                               sizeof(response)));
+    ASSERT_GT(length, 1);
+    ASSERT_EQ(ThingSetStatusCode::content, response[0]);
+}
+
+TEST(Allocation, GetGroupByPath)
+{
+    REQUEST(ThingSetBinaryRequestType::get);
+    encoder.encode("Alloc");
+    int length;
+    ASSERT_NO_ALLOCATIONS(length = server.handleBinaryRequest(request, encoder.getEncodedLength() + 1, response,
+                                                               sizeof(response)));
+    ASSERT_GT(length, 1);
+    ASSERT_EQ(ThingSetStatusCode::content, response[0]);
+    // null preamble, then a map of the two properties, keyed by name
+    ASSERT_EQ(0xA2, response[2]);
+}
+
+TEST(Allocation, FetchChildNames)
+{
+    REQUEST(ThingSetBinaryRequestType::fetch);
+    encoder.encode("Alloc");
+    encoder.encodeNull();
+    int length;
+    ASSERT_NO_ALLOCATIONS(length = server.handleBinaryRequest(request, encoder.getEncodedLength() + 1, response,
+                                                               sizeof(response)));
+    ASSERT_GT(length, 1);
+    ASSERT_EQ(ThingSetStatusCode::content, response[0]);
+    ASSERT_EQ(0x83, response[2]);
+}
+
+TEST(Allocation, UpdateById)
+{
+    REQUEST(ThingSetBinaryRequestType::update);
+    encoder.encode((uint16_t)0x1400);
+    encoder.encodeMapStart(1);
+    encoder.encode((uint16_t)0x1402);
+    encoder.encode((uint32_t)1234);
+    encoder.encodeMapEnd(1);
+    int length;
+    ASSERT_NO_ALLOCATIONS(length = server.handleBinaryRequest(request, encoder.getEncodedLength() + 1, response,
+                                                               sizeof(response)));
+    ASSERT_GT(length, 0);
+    ASSERT_EQ(ThingSetStatusCode::changed, response[0]);
+    ASSERT_EQ(1234u, allocCount.getValue());
+}
+
+TEST(Allocation, ExecById)
+{
+    REQUEST(ThingSetBinaryRequestType::exec);
+    encoder.encode((uint16_t)0x1410);
+    encoder.encodeListStart(2);
+    encoder.encode(2);
+    encoder.encode(3);
+    encoder.encodeListEnd(2);
+    int length;
+    ASSERT_NO_ALLOCATIONS(length = server.handleBinaryRequest(request, encoder.getEncodedLength() + 1, response,
+                                                               sizeof(response)));
+    ASSERT_GT(length, 1);
+    ASSERT_EQ(ThingSetStatusCode::changed, response[0]);
+}
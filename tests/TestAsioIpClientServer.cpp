@@ -8,9 +8,13 @@
 #include "thingset++/ThingSetClient.hpp"
 #include "thingset++/ThingSetServer.hpp"
 #include "thingset++/ThingSetFunction.hpp"
+#include "thingset++/ThingSetGroup.hpp"
 #include "gtest/gtest.h"
 #include <asio.hpp>
+#include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 
 using namespace ThingSet;
 using namespace ThingSet::Ip::Async;
@@ -130,4 +134,93 @@ ASIO_TEST(CannotUpdateFunctionById,
     auto result = client.update(0x1000, 26.0f);
     ASSERT_FALSE(result);
     ASSERT_EQ(ThingSetStatusCode::badRequest, result.code());
-)
\ No newline at end of file
+)
+TEST(AsioIpClientServer, GetTextResponseLargerThanBuffer)
+{
+    ThingSetGroup<0xB200, 0, "Large"> group;
+    std::vector<std::string> names;
+    std::vector<std::unique_ptr<ThingSetReadWriteProperty<float>>> properties;
+    for (int i = 0; i < 200; i++) {
+        names.push_back("property" + std::to_string(i));
+    }
+    for (int i = 0; i < 200; i++) {
+        properties.push_back(std::make_unique<ThingSetReadWriteProperty<float>>(0xB201 + i, 0xB200, names[i]));
+        *properties.back() = i * 1.5f;
+    }
+    std::vector<char> json(8192);
+    ThingSetTextEncoder reference(json.data(), json.size());
+    ASSERT_TRUE(group.encode(reference));
+    std::string expected = ":85 " + std::string(json.data(), reference.getEncodedLength());
+
+    io_context serverContext(1);
+    ThingSetAsyncSocketServerTransport serverTransport(serverContext);
+    auto server = ThingSetServerBuilder::build(serverTransport);
+    server.listen();
+    std::thread serverThread([&]() { serverContext.run_for(chrono::seconds(5)); });
+
+    std::string response;
+    std::thread clientThread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(125));
+        io_context clientContext(1);
+        asio::ip::tcp::socket socket(clientContext);
+        socket.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 9001));
+        asio::write(socket, asio::buffer(std::string_view("?Large")));
+        char chunk[512];
+        asio::error_code error;
+        while (response.size() < expected.size() && !error) {
+            size_t received = socket.read_some(asio::buffer(chunk), error);
+            response.append(chunk, received);
+        }
+        serverContext.stop();
+    });
+
+    clientThread.join();
+    serverThread.join();
+    ASSERT_EQ(expected, response);
+}
+
+TEST(AsioIpClientServer, GetBinaryResponseLargerThanBuffer)
+{
+    ThingSetGroup<0xB500, 0, "LargeBinary"> group;
+    std::vector<std::string> names;
+    std::vector<std::unique_ptr<ThingSetReadWriteProperty<float>>> properties;
+    for (int i = 0; i < 300; i++) {
+        names.push_back("property" + std::to_string(i));
+    }
+    for (int i = 0; i < 300; i++) {
+        properties.push_back(std::make_unique<ThingSetReadWriteProperty<float>>(0xB501 + i, 0xB500, names[i]));
+        *properties.back() = i * 1.5f;
+    }
+    std::vector<uint8_t> cbor(8192);
+    DefaultFixedDepthThingSetBinaryEncoder reference(cbor.data(), cbor.size());
+    ASSERT_TRUE(reference.encodePreamble() && group.encode(reference));
+    std::vector<uint8_t> expected = { (uint8_t)ThingSetStatusCode::content };
+    expected.insert(expected.end(), cbor.data(), cbor.data() + reference.getEncodedLength());
+
+    io_context serverContext(1);
+    ThingSetAsyncSocketServerTransport serverTransport(serverContext);
+    auto server = ThingSetServerBuilder::build(serverTransport);
+    server.listen();
+    std::thread serverThread([&]() { serverContext.run_for(chrono::seconds(5)); });
+
+    std::vector<uint8_t> response;
+    std::thread clientThread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(125));
+        io_context clientContext(1);
+        asio::ip::tcp::socket socket(clientContext);
+        socket.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 9001));
+        const uint8_t request[] = { (uint8_t)ThingSetBinaryRequestType::get, 0x19, 0xB5, 0x00 };
+        asio::write(socket, asio::buffer(request));
+        uint8_t chunk[512];
+        asio::error_code error;
+        while (response.size() < expected.size() && !error) {
+            size_t received = socket.read_some(asio::buffer(chunk), error);
+            response.insert(response.end(), chunk, chunk + received);
+        }
+        serverContext.stop();
+    });
+
+    clientThread.join();
+    serverThread.join();
+    ASSERT_EQ(expected, response);
+}
@@ -55,6 +55,88 @@ TEST(BinaryDecoder, DecodeUndersizeArray)
     ASSERT_EQ(4.56f, four[1]);
 }
 
+TEST(BinaryDecoder, DecodeTypedArray)
+{
+    std::array expected = { 1.23f, 4.56f, 7.89f };
+    uint8_t buffer[3 + sizeof(expected)] = { 0xD8, TypedArray::tag<float>(), 0x4C };
+    memcpy(buffer + 3, expected.data(), sizeof(expected));
+    FixedDepthThingSetBinaryDecoder decoder(buffer, sizeof(buffer));
+    std::array<float, 3> three;
+    ASSERT_TRUE(decoder.decode(&three));
+    ASSERT_EQ(expected, three);
+    ASSERT_EQ(sizeof(buffer), decoder.getDecodedLength());
+}
+
+TEST(BinaryDecoder, DecodeTypedArrayOfOtherByteOrder)
+{
+    // big-endian floats, then big-endian unsigned 16-bit integers
+    uint8_t buffer[] = { 0x82, 0xD8, 0x51, 0x4C, 0x3F, 0x9D, 0x70, 0xA4, 0x40, 0x91, 0xEB, 0x85,
+                         0x40, 0xFC, 0x7A, 0xE1, 0xD8, 0x41, 0x44, 0x12, 0x34, 0x56, 0x78 };
+    FixedDepthThingSetBinaryDecoder decoder(buffer, sizeof(buffer));
+    ASSERT_TRUE(decoder.decodeListStart());
+    std::array<float, 3> floats;
+    ASSERT_TRUE(decoder.decode(&floats));
+    ASSERT_EQ(1.23f, floats[0]);
+    ASSERT_EQ(4.56f, floats[1]);
+    ASSERT_EQ(7.89f, floats[2]);
+    std::array<uint16_t, 2> integers;
+    ASSERT_TRUE(decoder.decode(&integers));
+    ASSERT_EQ(0x1234, integers[0]);
+    ASSERT_EQ(0x5678, integers[1]);
+    ASSERT_TRUE(decoder.decodeListEnd());
+}
+
+TEST(BinaryDecoder, SkipMismatchedTypedArrayAndSuccessfullyDecodeNextElement)
+{
+    // big-endian signed 32-bit integers, which cannot be decoded into floats
+    uint8_t buffer[] = { 0x82, 0xD8, 0x4A, 0x48, 0x00, 0x00, 0x00, 0x01,
+                         0xFF, 0xFF, 0xFF, 0xFF, 0x19, 0x60, 0x7b };
+    FixedDepthThingSetBinaryDecoder decoder(buffer, sizeof(buffer));
+    ASSERT_TRUE(decoder.decodeListStart());
+    std::array<float, 2> floats;
+    ASSERT_FALSE(decoder.decode(&floats));
+    ASSERT_TRUE(decoder.skip());
+    uint16_t court;
+    ASSERT_TRUE(decoder.decode(&court));
+    ASSERT_EQ(0x607b, court);
+}
+
+TEST(BinaryDecoder, DecodeUndersizeTypedArray)
+{
+    uint8_t buffer[] = { 0xD8, 0x41, 0x44, 0x12, 0x34, 0x56, 0x78 };
+    std::array<uint16_t, 3> three = {};
+    FixedDepthThingSetBinaryDecoder strict(buffer, sizeof(buffer));
+    ASSERT_FALSE(strict.decode(&three));
+    FixedDepthThingSetBinaryDecoder lenient(buffer, sizeof(buffer),
+                                            ThingSetBinaryDecoderOptions::allowUndersizedArrays);
+    ASSERT_TRUE(lenient.decode(&three));
+    ASSERT_EQ(0x1234, three[0]);
+    ASSERT_EQ(0x5678, three[1]);
+    ASSERT_EQ(0, three[2]);
+}
+
+TEST(BinaryDecoder, DecodeMapWithIdsOrNames)
+{
+    // { "nodeID": "E93A142B282C4AD0", 0x28C: 16 }
+    uint8_t buffer[] = { 0xA2, 0x66, 'n',  'o',  'd',  'e',  'I',  'D',  0x70, 'E',  '9',  '3',  'A',  '1',  '4',
+                         '2',  'B',  '2',  '8',  '2',  'C',  '4',  'A',  'D',  '0',  0x19, 0x02, 0x8C, 0x10 };
+    FixedDepthThingSetBinaryDecoder decoder(buffer, sizeof(buffer));
+    std::string_view nodeId;
+    uint8_t canAddr;
+    ASSERT_TRUE(decoder.decodeMap([&](std::optional<uint32_t> id, std::optional<std::string_view> name) {
+        if (name.has_value() && name.value() == "nodeID") {
+            return decoder.decode(&nodeId);
+        }
+        else if (id.has_value() && id.value() == 0x028C) {
+            return decoder.decode(&canAddr);
+        }
+        return false;
+    }));
+    ASSERT_EQ("E93A142B282C4AD0", nodeId);
+    ASSERT_EQ((const char *)&buffer[9], nodeId.data());
+    ASSERT_EQ(0x10, canAddr);
+}
+
 TEST(BinaryDecoder, DecodeMap)
 {
     uint8_t buffer[] = { 0xA3, 0x18, 0x1D, 0x70, 0x45, 0x39, 0x33, 0x41, 0x31, 0x34, 0x32, 0x42, 0x32, 0x38, 0x32,
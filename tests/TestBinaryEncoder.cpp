@@ -3,6 +3,7 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include "thingset++/ThingSetBinaryDecoder.hpp"
 #include "thingset++/ThingSetBinaryEncoder.hpp"
 #include "gtest/gtest.h"
 
@@ -100,4 +101,129 @@ TEST(BinaryEncoder, EncodePreamble)
     encoder.encodePreamble();
     uint8_t expected[] = { 0xF6 };
     ASSERT_BUFFER_EQ(expected, buffer, encoder.getEncodedLength());
-}
\ No newline at end of file
+}
+
+// Encodes the same values with the polymorphic and inline encoders, which
+// must produce identical output
+template <typename Encode> static void assertInlineMatches(Encode encode)
+{
+    uint8_t expected[128];
+    FixedDepthThingSetBinaryEncoder encoder(expected, sizeof(expected), 16);
+    ThingSetEncoder &polymorphic = encoder;
+    ASSERT_TRUE(encode(polymorphic));
+    uint8_t actual[128];
+    FixedDepthInlineThingSetBinaryEncoder inlined(actual, sizeof(actual), 16);
+    ASSERT_TRUE(encode(inlined));
+    ASSERT_EQ(encoder.getEncodedLength(), inlined.getEncodedLength());
+    ASSERT_EQ(0, memcmp(expected, actual, inlined.getEncodedLength()));
+}
+
+TEST(BinaryEncoder, InlineEncodePrimitives)
+{
+    assertInlineMatches([](auto &encoder) {
+        uint64_t u64 = 0x123456789;
+        int16_t i16 = -300;
+        return encoder.encode(1.23f) && encoder.encode(4.56) && encoder.encode(true) && encoder.encode((uint8_t)200)
+               && encoder.encode((uint16_t)0x1234) && encoder.encode(70000u) && encoder.encode(u64)
+               && encoder.encode((int8_t)-5) && encoder.encode(&i16) && encoder.encode(-70000) && encoder.encode((int64_t)-1)
+               && encoder.encodeNull();
+    });
+}
+
+TEST(BinaryEncoder, InlineEncodeStringsAndContainers)
+{
+    assertInlineMatches([](auto &encoder) {
+        std::array<uint32_t, 3> i32 = { { 1, 2, 3 } };
+        std::map<uint16_t, std::string> names = { { 1, "one" }, { 2, "two" } };
+        std::list<float> values = { 1.0f, 2.0f };
+        uint8_t bytes[] = { 0xDE, 0xAD };
+        return encoder.encode("hello") && encoder.encode(std::string("monde")) && encoder.encode(std::string_view("世界"))
+               && encoder.encode(i32) && encoder.encode(names) && encoder.encode(values)
+               && encoder.encodeBytes(bytes, sizeof(bytes)) && encoder.encodeList(1.23f, 123, "123")
+               && encoder.encodeMapStart() && encoder.encode(0x01) && encoder.encode("x") && encoder.encodeMapEnd();
+    });
+}
+
+TEST(BinaryEncoder, InlineEncodeEncodable)
+{
+    // values which can only be encoded polymorphically fall back to an adapter
+    struct Encodable : public ThingSetEncodable
+    {
+        bool encode(ThingSetEncoder &encoder) const override
+        {
+            return encoder.encodeListStart(2) && encoder.encode(1.5f) && encoder.encode("a") && encoder.encodeListEnd(2);
+        }
+    } encodable;
+    assertInlineMatches([&encodable](auto &encoder) {
+        return encoder.encode(0x10) && encoder.encode(static_cast<const ThingSetEncodable &>(encodable));
+    });
+}
+
+TEST(BinaryEncoder, EncodeShortestFloats)
+{
+    uint8_t buffer[64];
+    FixedDepthThingSetBinaryEncoder encoder(buffer, sizeof(buffer), 4,
+                                            (ThingSetBinaryEncoderOptions)(ThingSetBinaryEncoderOptions::encodeKeysAsIds
+                                                                           | ThingSetBinaryEncoderOptions::shortestFloats));
+    ASSERT_TRUE(encoder.encode(1.5f));
+    ASSERT_TRUE(encoder.encode(1.23f));
+    ASSERT_TRUE(encoder.encode(100000.0));
+    ASSERT_TRUE(encoder.encode(0.1));
+    uint8_t expected[] = { 0xF9, 0x3E, 0x00, 0xFA, 0x3F, 0x9D, 0x70, 0xA4, 0xFA, 0x47, 0xC3,
+                           0x50, 0x00, 0xFB, 0x3F, 0xB9, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A };
+    ASSERT_BUFFER_EQ(expected, buffer, encoder.getEncodedLength());
+
+    // every width decodes to the original value
+    FixedDepthThingSetBinaryDecoder decoder(buffer, encoder.getEncodedLength(), 4);
+    float f;
+    double d;
+    ASSERT_TRUE(decoder.decode(&f));
+    ASSERT_EQ(1.5f, f);
+    ASSERT_TRUE(decoder.decode(&f));
+    ASSERT_EQ(1.23f, f);
+    ASSERT_TRUE(decoder.decode(&d));
+    ASSERT_EQ(100000.0, d);
+    ASSERT_TRUE(decoder.decode(&d));
+    ASSERT_EQ(0.1, d);
+}
+
+TEST(BinaryEncoder, EncodeTypedArrays)
+{
+    uint8_t buffer[64];
+    FixedDepthThingSetBinaryEncoder encoder(buffer, sizeof(buffer), 2,
+                                            (ThingSetBinaryEncoderOptions)(ThingSetBinaryEncoderOptions::encodeKeysAsIds
+                                                                           | ThingSetBinaryEncoderOptions::typedArrays));
+    std::array f = { 1.23f, 4.56f, 7.89f };
+    std::array<uint16_t, 2> u = { 0x1234, 0x5678 };
+    ASSERT_TRUE(encoder.encode(f));
+    ASSERT_TRUE(encoder.encode(u));
+
+    // each array is tagged with its type and this machine's byte order, and
+    // copied as it is laid out in memory
+    ASSERT_EQ(3 + sizeof(f) + 3 + sizeof(u), encoder.getEncodedLength());
+    uint8_t floatHeader[] = { 0xD8, TypedArray::tag<float>(), 0x4C };
+    ASSERT_EQ(0, memcmp(floatHeader, buffer, 3));
+    ASSERT_EQ(0, memcmp(f.data(), buffer + 3, sizeof(f)));
+    uint8_t uint16Header[] = { 0xD8, TypedArray::tag<uint16_t>(), 0x44 };
+    ASSERT_EQ(0, memcmp(uint16Header, buffer + 3 + sizeof(f), 3));
+    ASSERT_EQ(0, memcmp(u.data(), buffer + 6 + sizeof(f), sizeof(u)));
+    if constexpr (std::endian::native == std::endian::little) {
+        ASSERT_EQ(0x55, TypedArray::tag<float>());
+        ASSERT_EQ(0x45, TypedArray::tag<uint16_t>());
+    }
+
+    // the inline encoder writes the same
+    uint8_t inlineBuffer[64];
+    FixedDepthInlineThingSetBinaryEncoder inlined(inlineBuffer, sizeof(inlineBuffer), 2,
+                                                  (ThingSetBinaryEncoderOptions)(ThingSetBinaryEncoderOptions::encodeKeysAsIds
+                                                                                 | ThingSetBinaryEncoderOptions::typedArrays));
+    ASSERT_TRUE(inlined.encode(f));
+    ASSERT_TRUE(inlined.encode(u));
+    ASSERT_EQ(encoder.getEncodedLength(), inlined.getEncodedLength());
+    ASSERT_EQ(0, memcmp(buffer, inlineBuffer, inlined.getEncodedLength()));
+
+    // arrays of other types are still lists
+    std::array<bool, 2> b = { true, false };
+    ASSERT_TRUE(inlined.encode(b));
+    ASSERT_EQ(0x82, inlineBuffer[encoder.getEncodedLength()]);
+}
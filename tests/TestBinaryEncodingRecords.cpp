@@ -96,6 +96,20 @@ TEST(BinaryRecords, EncodeAndDecodeSimpleRecord)
               newModuleRecords[0].supercells.getValue()[0].soc.getValue());
 }
 
+TEST(BinaryRecords, InlineEncodeRecords)
+{
+    SETUP()
+    uint8_t expected[512];
+    FixedDepthThingSetBinaryEncoder encoder(expected, sizeof(expected));
+    ASSERT_TRUE(encoder.encode(moduleRecords.getValue()));
+
+    uint8_t actual[512];
+    FixedDepthInlineThingSetBinaryEncoder inlined(actual, sizeof(actual));
+    ASSERT_TRUE(inlined.encode(moduleRecords.getValue()));
+    ASSERT_EQ(encoder.getEncodedLength(), inlined.getEncodedLength());
+    ASSERT_EQ(0, memcmp(expected, actual, inlined.getEncodedLength()));
+}
+
 TEST(BinaryRecords, InitialiseRecordArrayCopy)
 {
     SETUP()
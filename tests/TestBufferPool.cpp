@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "thingset++/ip/BufferPool.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace ThingSet::Ip;
+
+using TestPool = SizeClassedBufferPool<BufferClass<64, 2>, BufferClass<256, 1>>;
+
+TEST(BufferPool, LeaseFromSmallestClassWhichFits)
+{
+    TestPool pool;
+    BufferLease small = pool.lease(10);
+    ASSERT_TRUE(small);
+    ASSERT_EQ(64, small.size());
+    BufferLease large = pool.lease(65);
+    ASSERT_TRUE(large);
+    ASSERT_EQ(256, large.size());
+    ASSERT_FALSE(pool.lease(257));
+    ASSERT_EQ(256, pool.getMaximumSize());
+}
+
+TEST(BufferPool, LeaseFromLargerClassWhenSmallerIsExhausted)
+{
+    TestPool pool;
+    BufferLease first = pool.lease(1);
+    BufferLease second = pool.lease(1);
+    BufferLease third = pool.lease(1);
+    ASSERT_TRUE(first && second && third);
+    ASSERT_EQ(256, third.size());
+    ASSERT_NE(first.data(), second.data());
+
+    BufferLease fourth = pool.lease(1);
+    ASSERT_FALSE(fourth);
+    ASSERT_EQ(1, pool.getMetrics(0).failedLeases);
+    ASSERT_EQ(0, pool.getMetrics(1).failedLeases);
+}
+
+TEST(BufferPool, ReturnBufferWhenLeaseEnds)
+{
+    TestPool pool;
+    {
+        BufferLease lease = pool.lease(1);
+        BufferLease moved = std::move(lease);
+        ASSERT_FALSE(lease);
+        ASSERT_TRUE(moved);
+        BufferPoolMetrics metrics = pool.getMetrics(0);
+        ASSERT_EQ(64, metrics.size);
+        ASSERT_EQ(2, metrics.count);
+        ASSERT_EQ(1, metrics.leased);
+    }
+    ASSERT_EQ(0, pool.getMetrics(0).leased);
+    ASSERT_EQ(1, pool.getMetrics(0).peakLeased);
+
+    BufferLease lease = pool.lease(100);
+    lease.release();
+    ASSERT_FALSE(lease);
+    ASSERT_EQ(0, pool.getMetrics(1).leased);
+}
+
+TEST(BufferPool, LeaseConcurrently)
+{
+    static SizeClassedBufferPool<BufferClass<16, 8>> pool;
+    std::vector<std::thread> threads;
+    std::atomic<bool> overlapped = false;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&overlapped, t]() {
+            for (int i = 0; i < 20000; i++) {
+                BufferLease lease = pool.lease(16);
+                if (!lease) {
+                    continue;
+                }
+                // each buffer must be held by one lease at a time
+                std::fill(lease.data(), lease.data() + lease.size(), (uint8_t)t);
+                std::this_thread::yield();
+                if (std::any_of(lease.data(), lease.data() + lease.size(), [t](uint8_t b) { return b != t; })) {
+                    overlapped = true;
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    ASSERT_FALSE(overlapped);
+    BufferPoolMetrics metrics = pool.getMetrics(0);
+    ASSERT_EQ(0, metrics.leased);
+    ASSERT_LE(metrics.peakLeased, 4);
+}
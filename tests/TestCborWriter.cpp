@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "gtest/gtest.h"
+#include "zcbor_encode.h"
+#include <limits>
+#include <random>
+#include <thingset++/internal/CborWriter.hpp>
+#include <vector>
+
+using namespace ThingSet;
+
+namespace {
+
+/// Writes the same items with zcbor and with CborWriter, so that their output
+/// can be compared.
+class DifferentialWriter
+{
+private:
+    static const size_t Depth = 8;
+
+    std::vector<uint8_t> _expected;
+    std::vector<uint8_t> _actual;
+    zcbor_state_t _zcbor[Depth];
+    zcbor_state_t _native;
+    CborContainerStack<Depth> _containers;
+    const bool _forwardOnly;
+
+public:
+    DifferentialWriter(bool forwardOnly) : _expected(65536), _actual(65536), _forwardOnly(forwardOnly)
+    {
+        zcbor_new_encode_state(_zcbor, Depth, _expected.data(), _expected.size(), 1);
+        zcbor_new_encode_state(&_native, 1, _actual.data(), _actual.size(), 1);
+    }
+
+    void writeUnsigned(uint64_t value)
+    {
+        ASSERT_TRUE(zcbor_uint64_encode(_zcbor, &value));
+        ASSERT_TRUE(CborWriter::writeUnsigned(&_native, value));
+    }
+
+    void writeSigned(int64_t value)
+    {
+        ASSERT_TRUE(zcbor_int64_encode(_zcbor, &value));
+        ASSERT_TRUE(CborWriter::writeSigned(&_native, value));
+    }
+
+    void writeFloat(float value)
+    {
+        ASSERT_TRUE(zcbor_float32_encode(_zcbor, &value));
+        ASSERT_TRUE(CborWriter::writeFloat(&_native, value));
+    }
+
+    void writeDouble(double value)
+    {
+        ASSERT_TRUE(zcbor_float64_encode(_zcbor, &value));
+        ASSERT_TRUE(CborWriter::writeDouble(&_native, value));
+    }
+
+    void writeBool(bool value)
+    {
+        ASSERT_TRUE(zcbor_bool_put(_zcbor, value));
+        ASSERT_TRUE(CborWriter::writeBool(&_native, value));
+    }
+
+    void writeNull()
+    {
+        ASSERT_TRUE(zcbor_nil_put(_zcbor, NULL));
+        ASSERT_TRUE(CborWriter::writeNull(&_native));
+    }
+
+    void writeString(const std::string &value, bool bytes)
+    {
+        zcbor_string string = { .value = (const uint8_t *)value.data(), .len = value.size() };
+        ASSERT_TRUE(bytes ? zcbor_bstr_encode(_zcbor, &string) : zcbor_tstr_encode(_zcbor, &string));
+        ASSERT_TRUE(CborWriter::writeString(&_native, bytes ? CborWriter::byteString : CborWriter::textString,
+                                            string.value, string.len));
+    }
+
+    void writeTag(uint32_t value)
+    {
+        ASSERT_TRUE(zcbor_tag_put(_zcbor, value));
+        ASSERT_TRUE(CborWriter::writeTag(&_native, value));
+    }
+
+    void start(bool map, size_t count)
+    {
+        ASSERT_TRUE(map ? zcbor_map_start_encode(_zcbor, count) : zcbor_list_start_encode(_zcbor, count));
+        ASSERT_TRUE(CborWriter::writeContainerStart(&_native, map ? CborWriter::map : CborWriter::list, count,
+                                                    _forwardOnly ? nullptr : _containers.push()));
+    }
+
+    void end(bool map, size_t count)
+    {
+        if (_forwardOnly) {
+            // as the streaming encoder did before it wrote CBOR itself
+            auto flags = ZCBOR_FLAG_RESTORE | ZCBOR_FLAG_CONSUME;
+#ifdef ZCBOR_FLAG_TRANSFER_PAYLOAD
+            flags |= ZCBOR_FLAG_TRANSFER_PAYLOAD;
+#else
+            flags |= ZCBOR_FLAG_KEEP_PAYLOAD;
+#endif
+            ASSERT_TRUE(zcbor_process_backup(_zcbor, flags, ZCBOR_MAX_ELEM_COUNT));
+        }
+        else {
+            ASSERT_TRUE(map ? zcbor_map_end_encode(_zcbor, count) : zcbor_list_end_encode(_zcbor, count));
+        }
+        ASSERT_TRUE(CborWriter::writeContainerEnd(&_native, map ? CborWriter::map : CborWriter::list, count,
+                                                  _forwardOnly ? nullptr : _containers.pop()));
+    }
+
+    void assertEqual()
+    {
+        size_t expectedLength = _zcbor->payload - _expected.data();
+        size_t actualLength = _native.payload - _actual.data();
+        ASSERT_EQ(expectedLength, actualLength);
+        ASSERT_EQ(0, memcmp(_expected.data(), _actual.data(), actualLength));
+    }
+};
+
+/// Writes random items, with values chosen to cover every header length.
+class RandomItems
+{
+private:
+    std::mt19937_64 _random;
+    DifferentialWriter &_writer;
+
+public:
+    RandomItems(DifferentialWriter &writer, uint64_t seed) : _random(seed), _writer(writer)
+    {}
+
+    uint64_t value()
+    {
+        // pick a width, then a value of at most that width
+        int bits = _random() % 65;
+        return bits == 0 ? 0 : _random() >> (64 - bits);
+    }
+
+    void write(int depth, bool forwardOnly)
+    {
+        switch (_random() % (depth < 4 ? 10 : 8)) {
+            case 0:
+                _writer.writeUnsigned(value());
+                break;
+            case 1:
+                _writer.writeSigned((int64_t)value());
+                break;
+            case 2: {
+                uint32_t bits = (uint32_t)_random();
+                _writer.writeFloat(std::bit_cast<float>(bits));
+                break;
+            }
+            case 3:
+                _writer.writeDouble(std::bit_cast<double>(_random()));
+                break;
+            case 4:
+                _writer.writeBool(_random() & 1);
+                break;
+            case 5:
+                _writer.writeNull();
+                break;
+            case 6:
+            case 7:
+                _writer.writeString(std::string(_random() % 300, 'a' + _random() % 26), _random() & 1);
+                break;
+            default: {
+                bool map = _random() & 1;
+                size_t count = _random() % 6;
+                // forward-only encodings must know the count in advance
+                size_t declared = forwardOnly || (_random() & 1) ? count : UINT8_MAX;
+                _writer.start(map, declared);
+                for (size_t i = 0; i < count * (map ? 2 : 1); i++) {
+                    write(depth + 1, forwardOnly);
+                }
+                _writer.end(map, declared);
+                break;
+            }
+        }
+    }
+};
+
+} // namespace
+
+TEST(CborWriter, HeaderLength)
+{
+    ASSERT_EQ(1u, CborWriter::headerLength(0));
+    ASSERT_EQ(1u, CborWriter::headerLength(23));
+    ASSERT_EQ(2u, CborWriter::headerLength(24));
+    ASSERT_EQ(2u, CborWriter::headerLength(0xFF));
+    ASSERT_EQ(3u, CborWriter::headerLength(0x100));
+    ASSERT_EQ(3u, CborWriter::headerLength(0xFFFF));
+    ASSERT_EQ(5u, CborWriter::headerLength(0x10000));
+    ASSERT_EQ(5u, CborWriter::headerLength(0xFFFFFFFF));
+    ASSERT_EQ(9u, CborWriter::headerLength(0x100000000));
+    ASSERT_EQ(9u, CborWriter::headerLength(UINT64_MAX));
+}
+
+TEST(CborWriter, MatchesZcborAtBoundaries)
+{
+    DifferentialWriter writer(false);
+    for (uint64_t value : std::initializer_list<uint64_t> { 0, 23, 24, 0xFF, 0x100, 0xFFFF, 0x10000, 0xFFFFFFFF,
+                                                            0x100000000, UINT64_MAX }) {
+        writer.writeUnsigned(value);
+        writer.writeSigned((int64_t)value);
+        writer.writeSigned(-(int64_t)value);
+    }
+    writer.writeSigned(INT64_MIN);
+    writer.writeSigned(-1);
+    writer.writeSigned(-24);
+    writer.writeSigned(-25);
+    for (float value : { 0.0f, -0.0f, 1.5f, std::numeric_limits<float>::infinity(),
+                         std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::denorm_min() }) {
+        writer.writeFloat(value);
+        writer.writeDouble(value);
+    }
+    for (size_t length : { 0, 23, 24, 255, 256 }) {
+        writer.writeString(std::string(length, 'x'), false);
+        writer.writeString(std::string(length, 'y'), true);
+    }
+    writer.assertEqual();
+}
+
+TEST(CborWriter, RewritesContainerHeaders)
+{
+    DifferentialWriter writer(false);
+    // declared with more elements than written, so headers shrink
+    writer.start(true, UINT8_MAX);
+    writer.writeUnsigned(1);
+    writer.start(false, 0x10000);
+    for (int i = 0; i < 30; i++) {
+        writer.writeSigned(-i);
+    }
+    writer.end(false, 0x10000);
+    writer.writeUnsigned(2);
+    writer.start(false, UINT8_MAX);
+    writer.end(false, UINT8_MAX);
+    writer.end(true, UINT8_MAX);
+    writer.assertEqual();
+}
+
+TEST(CborWriter, TagsAreNotCounted)
+{
+    DifferentialWriter writer(false);
+    // typed arrays, whose tags must not count towards the size of the list
+    writer.start(false, UINT8_MAX);
+    writer.writeTag(0x55);
+    writer.writeString(std::string(12, 'x'), true);
+    writer.writeTag(0x45);
+    writer.writeString(std::string(4, 'y'), true);
+    writer.writeTag(0x10000);
+    writer.writeUnsigned(1);
+    writer.end(false, UINT8_MAX);
+    writer.assertEqual();
+}
+
+TEST(CborWriter, MatchesZcborWithRandomItems)
+{
+    for (uint64_t seed = 0; seed < 200; seed++) {
+        DifferentialWriter writer(false);
+        RandomItems items(writer, seed);
+        for (int i = 0; i < 8; i++) {
+            items.write(0, false);
+        }
+        writer.assertEqual();
+    }
+}
+
+TEST(CborWriter, MatchesZcborForwardOnly)
+{
+    for (uint64_t seed = 0; seed < 200; seed++) {
+        DifferentialWriter writer(true);
+        RandomItems items(writer, seed);
+        for (int i = 0; i < 8; i++) {
+            items.write(0, true);
+        }
+        writer.assertEqual();
+    }
+}
+
+TEST(CborWriter, IndefiniteContainers)
+{
+    std::array<uint8_t, 16> buffer;
+    zcbor_state_t state;
+    zcbor_new_encode_state(&state, 1, buffer.data(), buffer.size(), 1);
+    ASSERT_TRUE(CborWriter::writeIndefiniteStart(&state, CborWriter::list));
+    ASSERT_TRUE(CborWriter::writeUnsigned(&state, 1));
+    ASSERT_TRUE(CborWriter::writeIndefiniteStart(&state, CborWriter::map));
+    ASSERT_TRUE(CborWriter::writeBreak(&state));
+    ASSERT_TRUE(CborWriter::writeBreak(&state));
+    uint8_t expected[] = { 0x9F, 0x01, 0xBF, 0xFF, 0xFF };
+    ASSERT_EQ(sizeof(expected), (size_t)(state.payload - buffer.data()));
+    ASSERT_EQ(0, memcmp(expected, buffer.data(), sizeof(expected)));
+}
+
+TEST(CborWriter, Overflow)
+{
+    std::array<uint8_t, 4> buffer;
+    zcbor_state_t state;
+    zcbor_new_encode_state(&state, 1, buffer.data(), buffer.size(), 1);
+    ASSERT_FALSE(CborWriter::writeFloat(&state, 1.0f));
+    ASSERT_FALSE(CborWriter::writeString(&state, CborWriter::textString, (const uint8_t *)"abcd", 4));
+    ASSERT_TRUE(CborWriter::writeUnsigned(&state, 0x1234));
+    ASSERT_FALSE(CborWriter::writeUnsigned(&state, 0x1234));
+    ASSERT_EQ(3, state.payload - buffer.data());
+}
+
+TEST(CborWriter, ShortestFloats)
+{
+    struct
+    {
+        double value;
+        std::vector<uint8_t> expected;
+    } cases[] = {
+        { 0.0, { 0xF9, 0x00, 0x00 } },
+        { -0.0, { 0xF9, 0x80, 0x00 } },
+        { 1.5, { 0xF9, 0x3E, 0x00 } },
+        { 65504.0, { 0xF9, 0x7B, 0xFF } },
+        { 0x1p-24, { 0xF9, 0x00, 0x01 } }, // smallest subnormal half
+        { 0x1p-14, { 0xF9, 0x04, 0x00 } }, // smallest normal half
+        { std::numeric_limits<double>::infinity(), { 0xF9, 0x7C, 0x00 } },
+        { std::numeric_limits<double>::quiet_NaN(), { 0xF9, 0x7E, 0x00 } },
+        { 65536.0, { 0xFA, 0x47, 0x80, 0x00, 0x00 } },
+        { 0x1p-25, { 0xFA, 0x33, 0x00, 0x00, 0x00 } },
+        { 100000.0, { 0xFA, 0x47, 0xC3, 0x50, 0x00 } },
+        { 0.1, { 0xFB, 0x3F, 0xB9, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A } },
+    };
+    for (const auto &c : cases) {
+        std::array<uint8_t, 16> buffer;
+        zcbor_state_t state;
+        zcbor_new_encode_state(&state, 1, buffer.data(), buffer.size(), 1);
+        ASSERT_TRUE(CborWriter::writeShortestDouble(&state, c.value));
+        std::vector<uint8_t> actual(buffer.data(), buffer.data() + (state.payload - buffer.data()));
+        ASSERT_EQ(c.expected, actual) << c.value;
+    }
+
+    // floats never need more than single precision
+    std::array<uint8_t, 16> buffer;
+    zcbor_state_t state;
+    zcbor_new_encode_state(&state, 1, buffer.data(), buffer.size(), 1);
+    ASSERT_TRUE(CborWriter::writeShortestFloat(&state, 0.1f));
+    ASSERT_TRUE(CborWriter::writeShortestFloat(&state, -2.0f));
+    uint8_t expected[] = { 0xFA, 0x3D, 0xCC, 0xCC, 0xCD, 0xF9, 0xC0, 0x00 };
+    ASSERT_EQ(sizeof(expected), (size_t)(state.payload - buffer.data()));
+    ASSERT_EQ(0, memcmp(expected, buffer.data(), sizeof(expected)));
+}
+
+TEST(CborWriter, HalfConversionIsExact)
+{
+    // every half converts to a float and back exactly
+    for (uint32_t bits = 0; bits <= 0xFFFF; bits++) {
+        uint16_t half = bits;
+        uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+        int exponent = (half >> 10) & 0x1F;
+        uint32_t mantissa = half & 0x3FF;
+        float value;
+        if (exponent == 0x1F) {
+            value = std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+        }
+        else if (exponent == 0) {
+            value = std::bit_cast<float>(sign) + (sign ? -1.0f : 1.0f) * mantissa * 0x1p-24f;
+        }
+        else {
+            value = std::bit_cast<float>(sign | ((exponent - 15 + 127) << 23) | (mantissa << 13));
+        }
+        uint16_t converted;
+        ASSERT_TRUE(CborWriter::toHalf(value, converted)) << half;
+        ASSERT_EQ(half, converted);
+    }
+    uint16_t converted;
+    ASSERT_FALSE(CborWriter::toHalf(1.0f + 0x1p-11f, converted));
+    ASSERT_FALSE(CborWriter::toHalf(65536.0f, converted));
+    ASSERT_FALSE(CborWriter::toHalf(0x1p-25f, converted));
+    ASSERT_FALSE(CborWriter::toHalf(std::bit_cast<float>(0x7FC00001), converted));
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "thingset++/ChunkedThingSetBinaryEncoder.hpp"
+#include "thingset++/ThingSetBinaryDecoder.hpp"
+#include "thingset++/ThingSetGroup.hpp"
+#include "thingset++/ThingSetProperty.hpp"
+#include "thingset++/ThingSetServer.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace ThingSet;
+
+namespace {
+
+/// Collects the chunks written by a chunked encoder.
+struct Output
+{
+    std::vector<uint8_t> bytes;
+    std::vector<size_t> chunks;
+
+    bool operator()(const uint8_t *buffer, size_t length)
+    {
+        bytes.insert(bytes.end(), buffer, buffer + length);
+        chunks.push_back(length);
+        return true;
+    }
+};
+
+/// Encodes the same values with a chunked encoder of the given buffer size
+/// and with an encoder whose buffer is large enough, and checks they match.
+template <typename Encode> void assertSameAsUnchunked(size_t size, Encode encode)
+{
+    std::array<uint8_t, 1024> expected;
+    DefaultFixedDepthThingSetBinaryEncoder reference(expected);
+    ASSERT_TRUE(encode(reference));
+
+    Output output;
+    std::vector<uint8_t> buffer(size);
+    ChunkedThingSetBinaryEncoder encoder(buffer.data(), buffer.size(), 0, output);
+    ASSERT_TRUE(encode(encoder));
+    size_t remainder = encoder.getEncodedLength() - output.bytes.size();
+    output.bytes.insert(output.bytes.end(), buffer.data(), buffer.data() + remainder);
+    ASSERT_EQ(std::vector<uint8_t>(expected.data(), expected.data() + reference.getEncodedLength()), output.bytes)
+        << "buffer size " << size;
+    ASSERT_GT(output.chunks.size(), 0);
+}
+
+/// Exposes request handling of the server without any transport.
+class DirectServer : public _ThingSetServer
+{
+public:
+    DirectServer() : _ThingSetServer(nullptr)
+    {}
+
+    bool listen() override
+    {
+        return true;
+    }
+
+    using _ThingSetServer::handleBinaryRequest;
+};
+
+} // namespace
+
+TEST(ChunkedBinaryEncoder, EncodeListInChunks)
+{
+    for (size_t size = 16; size < 40; size++) {
+        assertSameAsUnchunked(size, [](ThingSetBinaryEncoder &encoder) {
+            std::array<float, 6> values = { 1.5f, -2.25f, 3.0f, 100.125f, 0.0f, 7.75f };
+            return encoder.encode(values);
+        });
+    }
+}
+
+TEST(ChunkedBinaryEncoder, EncodeMapInChunks)
+{
+    ThingSetGroup<0xB000, 0, "chunked"> group;
+    ThingSetReadOnlyProperty<float> voltage{ 0xB001, 0xB000, "voltage", 24.5f };
+    ThingSetReadOnlyProperty<std::string> name{ 0xB002, 0xB000, "name", "a longer name" };
+    ThingSetReadOnlyProperty<std::array<int32_t, 3>> counts{ 0xB003, 0xB000, "counts", { 1, -20, 300 } };
+    ThingSetGroup<0xB004, 0xB000, "empty"> empty;
+    for (size_t size = 32; size < 64; size++) {
+        assertSameAsUnchunked(size, [&](ThingSetBinaryEncoder &encoder) { return group.encode(encoder); });
+    }
+}
+
+TEST(ChunkedBinaryEncoder, EncodeArraysAsListsEvenIfTypedArraysRequested)
+{
+    std::array<float, 256> values;
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = i * 0.5f;
+    }
+    std::array<uint8_t, 2048> expected;
+    DefaultFixedDepthThingSetBinaryEncoder reference(expected);
+    ASSERT_TRUE(reference.encode(values));
+
+    Output output;
+    std::array<uint8_t, 64> buffer;
+    ChunkedThingSetBinaryEncoder encoder(buffer.data(), buffer.size(), 0, output,
+                                         (ThingSetBinaryEncoderOptions)(ThingSetBinaryEncoderOptions::encodeKeysAsIds
+                                                                        | ThingSetBinaryEncoderOptions::typedArrays));
+    ASSERT_TRUE(encoder.encode(values));
+    size_t remainder = encoder.getEncodedLength() - output.bytes.size();
+    output.bytes.insert(output.bytes.end(), buffer.data(), buffer.data() + remainder);
+    ASSERT_EQ(std::vector<uint8_t>(expected.data(), expected.data() + reference.getEncodedLength()), output.bytes);
+}
+
+TEST(ChunkedBinaryEncoder, EncodeIndefiniteLengthContainers)
+{
+    Output output;
+    std::array<uint8_t, 16> buffer;
+    ChunkedThingSetBinaryEncoder encoder(buffer.data(), buffer.size(), 0, output);
+    ASSERT_TRUE(encoder.encodeListStart());
+    for (uint32_t i = 0; i < 10; i++) {
+        ASSERT_TRUE(encoder.encodeMapStart() && encoder.encode(i) && encoder.encode(i * 1000) && encoder.encodeMapEnd());
+    }
+    ASSERT_TRUE(encoder.encodeListEnd());
+    size_t remainder = encoder.getEncodedLength() - output.bytes.size();
+    output.bytes.insert(output.bytes.end(), buffer.data(), buffer.data() + remainder);
+    ASSERT_EQ(0x9F, output.bytes.front());
+    ASSERT_EQ(0xFF, output.bytes.back());
+
+    DefaultFixedDepthThingSetBinaryDecoder decoder(output.bytes.data(), output.bytes.size());
+    uint32_t count = 0;
+    ASSERT_TRUE(decoder.decodeList([&](size_t) {
+        return decoder.decodeMap<uint32_t>([&](uint32_t &key) {
+            uint32_t value;
+            return key == count && decoder.decode(&value) && value == count++ * 1000;
+        });
+    }));
+    ASSERT_EQ(10, count);
+}
+
+TEST(ChunkedBinaryEncoder, WriteReservedBytesWithFirstChunk)
+{
+    Output output;
+    std::array<uint8_t, 16> buffer = { 0x85 };
+    ChunkedThingSetBinaryEncoder encoder(buffer.data(), buffer.size(), 1, output);
+    ASSERT_TRUE(encoder.encode("0123456789"));
+    ASSERT_EQ(11, encoder.getEncodedLength());
+    ASSERT_EQ(0, encoder.getWrittenLength());
+    ASSERT_TRUE(encoder.encode(1));
+    ASSERT_EQ(12, encoder.getWrittenLength());
+    ASSERT_EQ(0x85, output.bytes[0]);
+    ASSERT_EQ(0x6A, output.bytes[1]);
+    ASSERT_EQ(12, output.bytes.size());
+}
+
+TEST(ChunkedBinaryEncoder, FailIfWriterFails)
+{
+    std::array<uint8_t, 16> buffer;
+    ChunkedThingSetBinaryEncoder encoder(buffer.data(), buffer.size(), 0, [](const uint8_t *, size_t) { return false; });
+    ASSERT_TRUE(encoder.encode("0123456789"));
+    ASSERT_FALSE(encoder.encode(1));
+}
+
+TEST(ChunkedBinaryEncoder, CloseConnectionIfChildrenCannotBeSent)
+{
+    ThingSetGroup<0xB010, 0, "streamed"> group;
+    ThingSetReadOnlyProperty<std::string> first{ 0xB011, 0xB010, "first", std::string(20, 'a') };
+    ThingSetReadOnlyProperty<std::string> second{ 0xB012, 0xB010, "second", std::string(20, 'b') };
+    ThingSetReadOnlyProperty<std::string> third{ 0xB013, 0xB010, "third", std::string(20, 'c') };
+
+    uint8_t request[16];
+    request[0] = (uint8_t)ThingSetBinaryRequestType::get;
+    FixedDepthThingSetBinaryEncoder encoder(request + 1, sizeof(request) - 1, 2);
+    // the root, which unlike a group encodes its children itself
+    ASSERT_TRUE(encoder.encode((uint16_t)0));
+
+    // the first part goes out, then the connection fails
+    size_t writes = 0;
+    auto writer = [&](const uint8_t *, size_t) { return writes++ == 0; };
+    std::array<uint8_t, 32> response;
+    DirectServer server;
+    ASSERT_EQ(-1, server.handleBinaryRequest(request, encoder.getEncodedLength() + 1, response.data(), response.size(),
+                                             writer));
+    ASSERT_GT(writes, 1);
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "gtest/gtest.h"
+#include <thingset++/ThingSet.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ThingSet;
+
+#ifdef ENABLE_CONCURRENT_REGISTRY
+
+static const uint16_t StressGroupId = 0x1300;
+static const uint16_t StressFirstId = 0x1301;
+static const size_t StressCount = 16;
+
+// Readers look up, iterate and use nodes while writers repeatedly create and
+// destroy them; run under ThreadSanitizer (ENABLE_TSAN) to check for races
+TEST(ConcurrentRegistry, ReadersAndWriters)
+{
+    ThingSetGroup<StressGroupId, 0, "Stress"> group;
+    ThingSetReadWriteProperty<uint32_t> fixed { 0x1340, StressGroupId, "fixed" };
+    fixed = 42;
+
+    std::vector<std::string> names;
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < StressCount; i++) {
+        names.push_back("x" + std::to_string(i));
+        paths.push_back("Stress/" + names.back());
+    }
+
+    std::atomic<bool> stop = false;
+    std::atomic<size_t> lookups = 0;
+    std::atomic<bool> failed = false;
+    std::atomic<int> started = 0;
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; r++) {
+        readers.emplace_back([&, r]() {
+            size_t count = 0;
+            for (size_t i = r; !stop; i++, std::this_thread::yield()) {
+                ThingSetRegistry::ReadGuard guard;
+                ThingSetNode *node;
+                if (!ThingSetRegistry::findById(0x1340, &node) || node->getName() != "fixed") {
+                    failed = true;
+                }
+                if (!ThingSetRegistry::findByName("Stress/fixed", &node) || node->getId() != 0x1340) {
+                    failed = true;
+                }
+                size_t n = i % StressCount;
+                if (ThingSetRegistry::findById(StressFirstId + n, &node) && node->getName() != names[n]) {
+                    failed = true;
+                }
+                if (ThingSetRegistry::findByName(paths[n], &node)) {
+                    void *target;
+                    if (node->getId() != StressFirstId + n || !node->tryCastTo(ThingSetNodeType::encodable, &target)) {
+                        failed = true;
+                    }
+                }
+                for (ThingSetNode *child : group) {
+                    if (child->getParentId() != StressGroupId) {
+                        failed = true;
+                    }
+                }
+                for (ThingSetNode *registered : ThingSetRegistry::instance()) {
+                    (void)registered->getId();
+                }
+                if (count++ == 0) {
+                    started++;
+                }
+            }
+            lookups += count;
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 2; w++) {
+        writers.emplace_back([&, w]() {
+            while (started < 4) {
+                std::this_thread::yield();
+            }
+            for (int round = 0; round < 50; round++) {
+                std::vector<std::unique_ptr<ThingSetReadWriteProperty<float>>> properties;
+                for (size_t i = w; i < StressCount; i += 2) {
+                    properties.push_back(
+                        std::make_unique<ThingSetReadWriteProperty<float>>(StressFirstId + i, StressGroupId, names[i]));
+                }
+                // destroy in a different order from creation
+                while (!properties.empty()) {
+                    properties.erase(properties.begin() + (round % properties.size()));
+                }
+            }
+        });
+    }
+
+    for (std::thread &writer : writers) {
+        writer.join();
+    }
+    stop = true;
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+
+    ASSERT_FALSE(failed);
+    ASSERT_GT(lookups, 0u);
+
+    ThingSetNode *node;
+    for (size_t i = 0; i < StressCount; i++) {
+        ASSERT_FALSE(ThingSetRegistry::findById(StressFirstId + i, &node));
+    }
+    size_t children = 0;
+    for (ThingSetNode *child : group) {
+        (void)child;
+        children++;
+    }
+    ASSERT_EQ(1u, children);
+}
+
+// A thread may unregister a node while it is itself inside a read-side
+// critical section without waiting for itself
+TEST(ConcurrentRegistry, UnregisterInsideReadGuard)
+{
+    ThingSetRegistry::ReadGuard guard;
+    ThingSetNode *node;
+    {
+        ThingSetReadWriteProperty<float> temporary { 0x1350, 0, "temporary" };
+        ASSERT_TRUE(ThingSetRegistry::findById(0x1350, &node));
+    }
+    ASSERT_FALSE(ThingSetRegistry::findById(0x1350, &node));
+}
+
+// Removing a parent while readers are active defers re-orphaning its
+// children until no reader can still be traversing them
+TEST(ConcurrentRegistry, ParentRemovedWhileShared)
+{
+    std::thread([]() { ThingSetRegistry::ReadGuard guard; }).join();
+
+    ThingSetNode *node;
+    ThingSetReadOnlyProperty<float> current { 0x1361, 0x1360, "current" };
+    {
+        ThingSetGroup<0x1360, 0, "Module"> module;
+        ASSERT_TRUE(ThingSetRegistry::findByName("Module/current", &node));
+    }
+    ASSERT_FALSE(ThingSetRegistry::findByName("Module/current", &node));
+    ThingSetGroup<0x1360, 0, "Module"> replacement;
+    ASSERT_TRUE(ThingSetRegistry::findByName("Module/current", &node));
+    ASSERT_EQ(0x1361, node->getId());
+}
+
+#endif // ENABLE_CONCURRENT_REGISTRY
+
+// Lookups from several threads at once are safe in either mode, provided
+// that, without the concurrent registry, nothing is registered meanwhile
+TEST(ConcurrentRegistry, ConcurrentLookups)
+{
+    ThingSetGroup<0x1370, 0, "Lookup"> group;
+    std::vector<std::string> paths;
+    for (uint16_t i = 0; i < 32; i++) {
+        paths.push_back("Lookup/p" + std::to_string(i));
+    }
+    // names are views into the paths, so are declared after them
+    std::vector<std::unique_ptr<ThingSetReadWriteProperty<uint32_t>>> properties;
+    for (uint16_t i = 0; i < 32; i++) {
+        properties.push_back(std::make_unique<ThingSetReadWriteProperty<uint32_t>>(
+            0x1371 + i, 0x1370, std::string_view(paths[i]).substr(7)));
+    }
+
+    std::atomic<bool> failed = false;
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; r++) {
+        readers.emplace_back([&, r]() {
+            for (size_t i = 0; i < 10000; i++) {
+                size_t n = (i * 7 + r) % paths.size();
+                ThingSetNode *node;
+                if (!ThingSetRegistry::findByName(paths[n], &node) || node->getId() != 0x1371 + n) {
+                    failed = true;
+                }
+            }
+        });
+    }
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+    ASSERT_FALSE(failed);
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "gtest/gtest.h"
+#include <memory>
+#include <thingset++/internal/Delegate.hpp>
+#include <thingset++/internal/FunctionRef.hpp>
+
+using namespace ThingSet;
+
+TEST(FunctionRef, InvokesReferencedCallable)
+{
+    int calls = 0;
+    auto increment = [&calls](int by) {
+        calls += by;
+        return calls;
+    };
+    FunctionRef<int(int)> ref(increment);
+    ASSERT_EQ(2, ref(2));
+    ASSERT_EQ(5, ref(3));
+    ASSERT_EQ(5, calls);
+}
+
+TEST(Delegate, Empty)
+{
+    Delegate<void()> empty;
+    ASSERT_FALSE(empty);
+    Delegate<void()> other([] {});
+    ASSERT_TRUE(other);
+    other = empty;
+    ASSERT_FALSE(other);
+}
+
+TEST(Delegate, CopiesAndMovesCaptures)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        Delegate<int()> delegate([counter] { return ++*counter; });
+        ASSERT_EQ(2, counter.use_count());
+        Delegate<int()> copy(delegate);
+        ASSERT_EQ(3, counter.use_count());
+        Delegate<int()> moved(std::move(copy));
+        ASSERT_EQ(1, delegate());
+        ASSERT_EQ(2, moved());
+        delegate = moved;
+        ASSERT_EQ(3, delegate());
+    }
+    // every copy of the capture has been destroyed
+    ASSERT_EQ(1, counter.use_count());
+    ASSERT_EQ(3, *counter);
+}
+
+TEST(Delegate, TriviallyCopyableCaptures)
+{
+    int total = 0;
+    int *target = &total;
+    Delegate<void(int)> delegate([target](int x) { *target += x; });
+    Delegate<void(int)> copy = delegate;
+    delegate(1);
+    copy(2);
+    ASSERT_EQ(3, total);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "thingset++/ip/sockets/ThingSetEpollServerTransport.hpp"
+#include "thingset++/ip/sockets/ThingSetSocketClientTransport.hpp"
+#include "thingset++/ThingSetClient.hpp"
+#include "thingset++/ThingSetServer.hpp"
+#include "thingset++/ThingSetFunction.hpp"
+#include "gtest/gtest.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ThingSet;
+using namespace ThingSet::Ip::Sockets;
+
+namespace {
+
+/// A client on its own connection to the server.
+struct Client
+{
+    std::array<uint8_t, 1024> rxBuffer;
+    std::array<uint8_t, 1024> txBuffer;
+    ThingSetSocketClientTransport transport;
+    ThingSetClient client;
+
+    Client() : transport("127.0.0.1"), client(transport, rxBuffer, txBuffer)
+    {}
+};
+
+} // namespace
+
+TEST(EpollIpClientServer, GetAndExec)
+{
+    ThingSetReadWriteProperty<float> totalVoltage{ 0xB801, 0, "totalVoltage", 24.0f };
+    ThingSetUserFunction<0xB802, 0x0, "xAddNumber", int, int, int> add([](auto x, auto y) { return x + y; });
+
+    ThingSetEpollServerTransport serverTransport;
+    auto server = ThingSetServerBuilder::build(serverTransport);
+    ASSERT_TRUE(server.listen());
+
+    // the server accepts immediately, so the client can connect without waiting
+    Client client;
+    ASSERT_TRUE(client.client.connect());
+    float tv;
+    ASSERT_TRUE(client.client.get(0xB801, tv));
+    ASSERT_EQ(24.0f, tv);
+    int result;
+    ASSERT_TRUE(client.client.exec(0xB802, &result, 2, 3));
+    ASSERT_EQ(5, result);
+    ASSERT_TRUE(client.client.update("totalVoltage", 25.0f));
+    ASSERT_EQ(25.0f, totalVoltage.getValue());
+}
+
+TEST(EpollIpClientServer, MoreClientsThanPollingServer)
+{
+    ThingSetUserFunction<0xB803, 0x0, "xDouble", int, int> twice([](auto x) { return 2 * x; });
+
+    ThingSetEpollServerTransport serverTransport;
+    auto server = ThingSetServerBuilder::build(serverTransport);
+    ASSERT_TRUE(server.listen());
+
+    const int clientCount = 8 * THINGSET_SERVER_MAX_CLIENTS;
+    std::vector<std::unique_ptr<Client>> clients;
+    for (int i = 0; i < clientCount; i++) {
+        clients.push_back(std::make_unique<Client>());
+        ASSERT_TRUE(clients.back()->client.connect());
+    }
+
+    // every connection stays open and is served, in turn and all at once
+    for (int i = 0; i < clientCount; i++) {
+        int result;
+        ASSERT_TRUE(clients[i]->client.exec(0xB803, &result, i));
+        ASSERT_EQ(2 * i, result);
+    }
+    std::vector<std::thread> threads;
+    std::atomic<int> succeeded = 0;
+    for (int i = 0; i < clientCount; i++) {
+        threads.emplace_back([&, i]() {
+            int result;
+            if (clients[i]->client.exec(0xB803, &result, i + 1) && result == 2 * (i + 1)) {
+                succeeded++;
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(clientCount, succeeded);
+}
@@ -121,4 +121,31 @@ TEST(Intrusion, MoreThanOneList)
     first.remove(b);
     ASSERT_EQ(0, first.count());
     ASSERT_EQ(1, second.count());
-}
\ No newline at end of file
+}
+
+TEST(Intrusion, RemoveHeadAndTail)
+{
+    IntrusiveLinkedList<Something, &Something::node> list;
+    std::array<Something, 3> somethings;
+    for (Something &s : somethings) {
+        list.push_back(s);
+    }
+    ASSERT_TRUE(list.remove(somethings[0]));
+    ASSERT_TRUE(list.remove(somethings[2]));
+    ASSERT_FALSE(list.remove(somethings[2]));
+    ASSERT_EQ(1, list.count());
+    ASSERT_EQ(&somethings[1], *list.begin());
+    list.push_back(somethings[0]);
+    ASSERT_EQ(2, list.count());
+    ASSERT_TRUE(list.remove(somethings[1]));
+    ASSERT_EQ(&somethings[0], *list.begin());
+}
+
+TEST(Intrusion, PushBackTwice)
+{
+    IntrusiveLinkedList<Something, &Something::node> list;
+    Something s;
+    list.push_back(s);
+    list.push_back(s);
+    ASSERT_EQ(1, list.count());
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+// the reference tokenizer, kept private to this file
+#define JSMN_STATIC
+#include "thingset++/internal/jsmn.h"
+
+#include "thingset++/internal/JsonTokenizer.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ThingSet;
+
+namespace {
+
+/// Tokenizes JSON with both jsmn and JsonTokenizer, and checks that they agree,
+/// by default with enough tokens for any input of that length.
+void assertMatchesJsmn(const std::string &json, size_t capacity = SIZE_MAX)
+{
+    capacity = std::min(capacity, json.size() + 1);
+    // one spare, because jsmn only counts the tokens when given no array
+    std::vector<jsmntok> expected(capacity + 1);
+    jsmn_parser parser;
+    jsmn_init(&parser);
+    int expectedCount = jsmn_parse(&parser, json.data(), json.size(), expected.data(), capacity);
+
+    std::vector<jsmntok> actual(capacity + 1);
+    JsonTokenizer tokenizer;
+    int actualCount = tokenizer.parse(json.data(), json.size(), actual.data(), capacity);
+
+    ASSERT_EQ(expectedCount, actualCount) << json;
+    for (int i = 0; i < expectedCount; i++) {
+        ASSERT_EQ(expected[i].type, actual[i].type) << json << " token " << i;
+        ASSERT_EQ(expected[i].start, actual[i].start) << json << " token " << i;
+        ASSERT_EQ(expected[i].end, actual[i].end) << json << " token " << i;
+        ASSERT_EQ(expected[i].size, actual[i].size) << json << " token " << i;
+    }
+}
+
+/// Generates random JSON, with strings and whitespace of varying length so
+/// that items straddle the boundaries between blocks.
+class RandomJson
+{
+private:
+    std::mt19937_64 _random;
+
+    std::string whitespace()
+    {
+        static const char characters[] = { ' ', '\t', '\r', '\n' };
+        std::string result;
+        for (int i = _random() % 4; i > 0; i--) {
+            result += characters[_random() % 4];
+        }
+        return result;
+    }
+
+    std::string string()
+    {
+        static const char *pieces[] = { "a", "bc", "{", "]", ",", ":", " ", "\\\"", "\\\\", "\\n", "\\u00e9", "\\/" };
+        std::string result = "\"";
+        for (int i = _random() % 12; i > 0; i--) {
+            result += pieces[_random() % std::size(pieces)];
+        }
+        return result + "\"";
+    }
+
+public:
+    RandomJson(uint64_t seed) : _random(seed)
+    {}
+
+    /// Generates input which is mostly malformed, from fragments of JSON.
+    std::string fragments()
+    {
+        static const char *pieces[] = { "{", "}", "[",  "]",  ":",    ",",    " ",    "\n",       "\"",     "\\",   "\\\"", "0",
+                                        "1", "a", "e9", "null", "true", "\x01", "\x7f", "\"ab\"", "\\u", "\\x", "\\u00e9", "\\\\" };
+        size_t limit = _random() % 4 == 0 ? 200 : 40;
+        size_t length = _random() % limit;
+        std::string result;
+        for (size_t i = 0; i < length; i++) {
+            result += pieces[_random() % std::size(pieces)];
+        }
+        return result;
+    }
+
+    /// Picks a random number below a limit.
+    size_t below(size_t limit)
+    {
+        return _random() % limit;
+    }
+
+    std::string value(int depth = 0)
+    {
+        switch (_random() % (depth < 5 ? 8 : 6)) {
+            case 0:
+                return std::to_string((int64_t)_random() >> (_random() % 64));
+            case 1:
+                return std::to_string((double)(int32_t)_random() / 1000);
+            case 2:
+                return _random() & 1 ? "true" : "false";
+            case 3:
+                return "null";
+            case 4:
+            case 5:
+                return string();
+            case 6: {
+                std::string result = "[" + whitespace();
+                for (int i = _random() % 6; i > 0; i--) {
+                    result += value(depth + 1) + whitespace() + (i > 1 ? "," + whitespace() : "");
+                }
+                return result + "]";
+            }
+            default: {
+                std::string result = "{" + whitespace();
+                for (int i = _random() % 6; i > 0; i--) {
+                    result += string() + whitespace() + ":" + whitespace() + value(depth + 1) + whitespace()
+                              + (i > 1 ? "," + whitespace() : "");
+                }
+                return result + "}";
+            }
+        }
+    }
+};
+
+} // namespace
+
+TEST(JsonTokenizer, MatchesJsmn)
+{
+    for (const char *json : { "", "1", "-1.5e3", "true", "\"\"", "\"abc\"", "[]", "{}", "[1,2,3]", "{\"a\":1}",
+                              "{\"a\":[1,{\"b\":null}],\"c\":\"d\"}", " [ 1 , \"x\" ] ", "[[[]],[{}]]",
+                              "{\"a\":{\"b\":{\"c\":{}}},\"d\":[]}", "\"\\\"\"", "\"\\\\\"", "[\"a\\\\\",\"b\"]" }) {
+        assertMatchesJsmn(json);
+    }
+}
+
+TEST(JsonTokenizer, MatchesJsmnAcrossBlocks)
+{
+    // put each interesting sequence across every position of a block boundary
+    for (const char *item : { "\"abc\"", "\"a\\\"b\"", "\"\\\\\"", "12345", "true", "{\"k\":1}", "[1,2]" }) {
+        for (size_t padding = 50; padding < 70; padding++) {
+            assertMatchesJsmn("[" + std::string(padding, ' ') + item + "," + item + "]");
+            assertMatchesJsmn("[\"" + std::string(padding, 'x') + "\"," + item + "]");
+        }
+    }
+    // runs of backslashes ending at a block boundary
+    for (size_t backslashes = 1; backslashes < 6; backslashes++) {
+        for (size_t padding = 55; padding < 66; padding++) {
+            std::string escapes;
+            for (size_t i = 0; i < backslashes; i++) {
+                escapes += "\\\\";
+            }
+            assertMatchesJsmn("[\"" + std::string(padding, 'x') + escapes + "\",1]");
+            assertMatchesJsmn("[\"" + std::string(padding, 'x') + escapes + "\\\"\",1]");
+        }
+    }
+}
+
+TEST(JsonTokenizer, MatchesJsmnWithRandomJson)
+{
+    RandomJson random(42);
+    for (int i = 0; i < 2000; i++) {
+        assertMatchesJsmn(random.value());
+    }
+}
+
+TEST(JsonTokenizer, Errors)
+{
+    for (const char *json : { "[1,2", "{\"a\":1", "\"abc", "[1]]", "[1}", "{]", "\"\\x\"", "\"\\u12g4\"", "[\x01]",
+                              "\"\\u0\"", "\"\\u\"", "[\"\\x", "null\"\\u00e9\"null1", "a{b", "1:2,3" }) {
+        assertMatchesJsmn(json);
+    }
+}
+
+TEST(JsonTokenizer, MatchesJsmnWithMalformedJson)
+{
+    // the same tokens or error as jsmn, including when the tokens run out
+    RandomJson random(11);
+    for (int i = 0; i < 20000; i++) {
+        std::string json = random.fragments();
+        assertMatchesJsmn(json);
+        assertMatchesJsmn(json, random.below(json.size() + 1));
+    }
+}
+
+TEST(JsonTokenizer, StopsAtNull)
+{
+    std::string json = "{\"a\":1}";
+    json += '\0';
+    json += "garbage";
+    std::vector<jsmntok> tokens(8);
+    JsonTokenizer tokenizer;
+    ASSERT_EQ(3, tokenizer.parse(json.data(), json.size(), tokens.data(), tokens.size()));
+}
+
+TEST(JsonTokenizer, ResumesWithMoreTokens)
+{
+    RandomJson random(7);
+    std::string json = "[";
+    for (int i = 0; i < 100; i++) {
+        json += random.value() + ",";
+    }
+    json += "0]";
+
+    std::vector<jsmntok> expected(json.size());
+    JsonTokenizer reference;
+    int expectedCount = reference.parse(json.data(), json.size(), expected.data(), expected.size());
+    ASSERT_GT(expectedCount, 64);
+
+    std::vector<jsmntok> tokens(1);
+    JsonTokenizer tokenizer;
+    int count;
+    while ((count = tokenizer.parse(json.data(), json.size(), tokens.data(), tokens.size())) == JSMN_ERROR_NOMEM) {
+        tokens.resize(tokens.size() + 16);
+    }
+    ASSERT_EQ(expectedCount, count);
+    for (int i = 0; i < count; i++) {
+        ASSERT_EQ(expected[i].type, tokens[i].type);
+        ASSERT_EQ(expected[i].start, tokens[i].start);
+        ASSERT_EQ(expected[i].end, tokens[i].end);
+        ASSERT_EQ(expected[i].size, tokens[i].size);
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "gtest/gtest.h"
+#include "thingset++/internal/OpenAddressedIndex.hpp"
+#include <array>
+
+using namespace ThingSet;
+
+TEST(OpenAddressedIndex, InsertFind)
+{
+    OpenAddressedIndex<int> index;
+    int a = 1, b = 2;
+    ASSERT_TRUE(index.insert(0x100, &a));
+    ASSERT_TRUE(index.insert(0x101, &b));
+    ASSERT_EQ(2, index.size());
+    ASSERT_EQ(&a, index.find(0x100));
+    ASSERT_EQ(&b, index.find(0x101));
+    ASSERT_EQ(nullptr, index.find(0x102));
+}
+
+TEST(OpenAddressedIndex, InsertDuplicate)
+{
+    OpenAddressedIndex<int> index;
+    int a = 1, b = 2;
+    ASSERT_TRUE(index.insert(0, &a));
+    int *existing = nullptr;
+    ASSERT_FALSE(index.insert(0, &b, &existing));
+    ASSERT_EQ(&a, existing);
+    ASSERT_EQ(&a, index.find(0));
+    ASSERT_EQ(1, index.size());
+}
+
+TEST(OpenAddressedIndex, Grow)
+{
+    OpenAddressedIndex<int> index;
+    std::array<int, 1000> values;
+    for (size_t i = 0; i < values.size(); i++) {
+        ASSERT_TRUE(index.insert(i * 7, &values[i]));
+    }
+    ASSERT_EQ(values.size(), index.size());
+    ASSERT_LE(index.size() * 4, index.capacity() * 3);
+    for (size_t i = 0; i < values.size(); i++) {
+        ASSERT_EQ(&values[i], index.find(i * 7));
+    }
+}
+
+TEST(OpenAddressedIndex, RemoveKeepsClusterReachable)
+{
+    OpenAddressedIndex<int> index;
+    std::array<int, 200> values;
+    for (size_t i = 0; i < values.size(); i++) {
+        index.insert(i, &values[i]);
+    }
+    for (size_t i = 0; i < values.size(); i += 2) {
+        ASSERT_TRUE(index.remove(i));
+    }
+    ASSERT_FALSE(index.remove(0));
+    ASSERT_EQ(values.size() / 2, index.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        ASSERT_EQ(i % 2 ? &values[i] : nullptr, index.find(i));
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "gtest/gtest.h"
+#include "thingset++/internal/PathCache.hpp"
+#include <array>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ThingSet;
+
+TEST(PathCache, InsertFind)
+{
+    PathCache<int, 16, 32> cache;
+    int a = 1;
+    int *value;
+    size_t index;
+    ASSERT_FALSE(cache.find("Group/a", &value, &index));
+    cache.insert("Group/a", &a, 3);
+    ASSERT_TRUE(cache.find("Group/a", &value, &index));
+    ASSERT_EQ(&a, value);
+    ASSERT_EQ(3, index);
+    ASSERT_FALSE(cache.find("Group/b", &value, &index));
+}
+
+TEST(PathCache, Clear)
+{
+    PathCache<int, 16, 32> cache;
+    int a = 1;
+    int *value;
+    size_t index;
+    cache.insert("Group/a", &a, 0);
+    cache.clear();
+    ASSERT_FALSE(cache.find("Group/a", &value, &index));
+}
+
+TEST(PathCache, LongPathsAreNotCached)
+{
+    PathCache<int, 16, 8> cache;
+    int a = 1;
+    int *value;
+    size_t index;
+    cache.insert("Group/long", &a, 0);
+    ASSERT_FALSE(cache.find("Group/long", &value, &index));
+}
+
+// Threads share a single entry, so that every insertion overwrites a path
+// which others may be reading; run under ThreadSanitizer (ENABLE_TSAN) to
+// check for races
+TEST(PathCache, ConcurrentLookups)
+{
+    PathCache<int, 1, 32> cache;
+    std::array<int, 8> values;
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = i;
+        paths.push_back("Group/" + std::string(i + 1, 'x'));
+    }
+
+    std::atomic<bool> failed = false;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < 20000; i++) {
+                size_t n = (i + t) % values.size();
+                int *value;
+                size_t index;
+                if (cache.find(paths[n], &value, &index)) {
+                    if (value != &values[n] || index != n) {
+                        failed = true;
+                    }
+                }
+                else {
+                    cache.insert(paths[n], &values[n], n);
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    ASSERT_FALSE(failed);
+}
@@ -207,4 +207,53 @@ TEST(Properties, InlineStringConstantProperty)
 
     ASSERT_EQ(11, encoder.getEncodedLength());
     ASSERT_EQ(0x6A, buffer[0]);
-}
\ No newline at end of file
+}
+TEST(Properties, FindByNameAfterRemoval)
+{
+    ThingSetNode *node;
+    {
+        ThingSetGroup<0x1100, 0, "Modules"> modules;
+        ThingSetReadOnlyProperty<float> voltage { 0x1101, 0x1100, "voltage" };
+        ASSERT_TRUE(ThingSetRegistry::findByName("Modules/voltage", &node));
+        ASSERT_EQ(0x1101, node->getId());
+        // second lookup is served from the path cache
+        ASSERT_TRUE(ThingSetRegistry::findByName("Modules/voltage", &node));
+        ASSERT_EQ(0x1101, node->getId());
+        ASSERT_FALSE(ThingSetRegistry::findByName("Modules/current", &node));
+    }
+    ASSERT_FALSE(ThingSetRegistry::findByName("Modules/voltage", &node));
+    ASSERT_FALSE(ThingSetRegistry::findByName("Modules", &node));
+}
+
+TEST(Properties, ChildRegisteredBeforeParent)
+{
+    ThingSetNode *node;
+    ThingSetReadOnlyProperty<float> voltage { 0x1201, 0x1200, "voltage" };
+    ASSERT_FALSE(ThingSetRegistry::findByName("Pack/voltage", &node));
+    {
+        ThingSetGroup<0x1200, 0, "Pack"> pack;
+        ASSERT_TRUE(ThingSetRegistry::findByName("Pack/voltage", &node));
+        ASSERT_EQ(0x1201, node->getId());
+    }
+    // parent went away first, so child waits for a replacement
+    ASSERT_FALSE(ThingSetRegistry::findByName("Pack/voltage", &node));
+    ThingSetGroup<0x1200, 0, "Pack"> replacement;
+    ASSERT_TRUE(ThingSetRegistry::findByName("Pack/voltage", &node));
+    ASSERT_EQ(0x1201, node->getId());
+}
+
+TEST(Properties, EncodableChildCount)
+{
+    ThingSetGroup<0x1220, 0, "Cell"> cell;
+    ThingSetReadOnlyProperty<float> voltage { 0x1221, 0x1220, "voltage" };
+    ThingSetGroup<0x1222, 0x1220, "Balancer"> balancer;
+    ASSERT_EQ(2, cell.getEncodableChildCount());
+    ASSERT_EQ(1, cell.getGroupChildCount());
+    {
+        ThingSetReadOnlyProperty<float> temperature { 0x1223, 0x1220, "temperature" };
+        ASSERT_EQ(3, cell.getEncodableChildCount());
+        ASSERT_EQ(1, cell.getGroupChildCount());
+    }
+    ASSERT_EQ(2, cell.getEncodableChildCount());
+    ASSERT_EQ(0, balancer.getEncodableChildCount());
+}
@@ -46,10 +46,8 @@ TEST(RecordMemberNamespaces, BothParentRecordsRegister)
 
 TEST(RecordMemberNamespaces, FindByIdDisambiguatesByParent)
 {
-    // Both record types share raw member id 0x7BA. Their proxies land in
-    // the same bucket because the parent id contribution to the bucket
-    // hash is a multiple of 8 and cancels. findById(rawId, parentId) must
-    // therefore also filter on parent id
+    // Both record types share raw member id 0x7BA, so findById(rawId, parentId)
+    // must key on the parent id too
     ThingSetNode *alphaA = nullptr;
     ASSERT_TRUE(ThingSetRegistry::findById(0x7BA, 0x7B0, &alphaA));
     EXPECT_EQ(0x7B0, alphaA->getParentId());
@@ -60,7 +58,7 @@ TEST(RecordMemberNamespaces, FindByIdDisambiguatesByParent)
 
     EXPECT_NE(alphaA, alphaB) << "findById returned the same proxy for both parents";
 
-    // And again for the second shared id, to cover the neighbouring bucket
+    // And again for the second shared id
     ThingSetNode *betaA = nullptr;
     ASSERT_TRUE(ThingSetRegistry::findById(0x7BB, 0x7B0, &betaA));
     EXPECT_EQ(0x7B0, betaA->getParentId());
@@ -65,4 +65,17 @@ TEST(RecordMembers, ArrayRecordMemberHasChildren)
         count++;
     }
     ASSERT_EQ(1, count);
-}
\ No newline at end of file
+}
+
+TEST(RecordMembers, FindRecordElementByName)
+{
+    ThingSetNode *node;
+    size_t index;
+    ASSERT_TRUE(ThingSetRegistry::findByName("records/1", &node, &index));
+    ASSERT_EQ(0x500, node->getId());
+    ASSERT_EQ(1, index);
+    ASSERT_TRUE(ThingSetRegistry::findByName("records/1/cells/voltage", &node, &index));
+    ASSERT_EQ(0x500, node->getId());
+    ASSERT_EQ(1, index);
+    ASSERT_FALSE(ThingSetRegistry::findByName("records/2", &node, &index));
+}
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "gtest/gtest.h"
+#include <thingset++/ThingSet.hpp>
+#include <thingset++/ThingSetReportScheduler.hpp>
+#include <thingset++/ThingSetServer.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace ThingSet;
+
+constexpr size_t ReportMessageSize = 16;
+
+class InMemoryReportTransport;
+
+class InMemoryReportEncoder : public StreamingThingSetBinaryEncoder<ReportMessageSize>
+{
+private:
+    std::vector<uint8_t> &_output;
+
+public:
+    InMemoryReportEncoder(std::vector<uint8_t> &output) : _output(output)
+    {
+        _output.clear();
+        zcbor_new_encode_state(_state, BINARY_ENCODER_DEFAULT_MAX_DEPTH, _buffer.data(), _buffer.size(), 2);
+    }
+
+protected:
+    bool write(size_t length, bool) override
+    {
+        if (length > ReportMessageSize) {
+            return false;
+        }
+        _output.insert(_output.end(), _buffer.begin(), _buffer.begin() + length);
+        return true;
+    }
+};
+
+class InMemoryReportTransport : public ThingSetServerTransport<int, ReportMessageSize, InMemoryReportEncoder>
+{
+public:
+    std::vector<uint8_t> output;
+
+    bool listen(Delegate<int(const int &, uint8_t *, size_t, uint8_t *, size_t)>) override
+    {
+        return true;
+    }
+
+    InMemoryReportEncoder getPublishingEncoder(bool) override
+    {
+        return InMemoryReportEncoder(output);
+    }
+};
+
+// Publishes a subset both directly and via a compiled report, returning
+// whether the two produced identical output
+static bool publishBothWays(ThingSetServer<int, ReportMessageSize, InMemoryReportEncoder> &server,
+                            InMemoryReportTransport &transport, ThingSetReport &report)
+{
+    if (!server.publish(Subset::live)) {
+        return false;
+    }
+    std::vector<uint8_t> expected = transport.output;
+    if (!server.publish(report)) {
+        return false;
+    }
+    return expected == transport.output;
+}
+
+TEST(Report, MatchesSubsetPublish)
+{
+    InMemoryReportTransport transport;
+    ThingSetServer<int, ReportMessageSize, InMemoryReportEncoder> server(transport);
+
+    ThingSetReadWriteProperty<float, Subset::live> voltage { 0x1501, 0, "voltage" };
+    ThingSetReadWriteProperty<uint32_t, Subset::live> count { 0x1502, 0, "count" };
+    ThingSetReadWriteProperty<std::array<int16_t, 3>, Subset::live> temperatures { 0x1503, 0, "temperatures" };
+    ThingSetReport report(Subset::live);
+
+    voltage = 3.3f;
+    count = 1;
+    ASSERT_TRUE(publishBothWays(server, transport, report));
+    // long enough to span more than one message
+    ASSERT_GT(transport.output.size(), ReportMessageSize);
+
+    // same widths, so values are patched in place
+    voltage = 4.1f;
+    count = 2;
+    temperatures = { 21, -4, 19 };
+    ASSERT_TRUE(publishBothWays(server, transport, report));
+
+    // wider values
+    count = 100000;
+    temperatures = { 1000, -1000, 300 };
+    ASSERT_TRUE(publishBothWays(server, transport, report));
+
+    // narrower again
+    count = 3;
+    ASSERT_TRUE(publishBothWays(server, transport, report));
+}
+
+TEST(Report, MatchesPropertyPublish)
+{
+    InMemoryReportTransport transport;
+    ThingSetServer<int, ReportMessageSize, InMemoryReportEncoder> server(transport);
+
+    ThingSetReadWriteProperty<float> voltage { 0x1501, 0, "voltage" };
+    ThingSetReadWriteProperty<uint32_t> count { 0x1502, 0, "count" };
+    ThingSetReadWriteProperty<std::array<int16_t, 3>> temperatures { 0x1503, 0, "temperatures" };
+    ThingSetReport report(voltage, count, temperatures);
+
+    voltage = 3.3f;
+    count = 100000;
+    temperatures = { 1000, -1000, 300 };
+    ASSERT_TRUE(server.publish(voltage, count, temperatures));
+    std::vector<uint8_t> expected = transport.output;
+    ASSERT_GT(expected.size(), ReportMessageSize);
+    ASSERT_TRUE(server.publish(report));
+    ASSERT_EQ(expected, transport.output);
+}
+
+TEST(Report, FollowsRegistry)
+{
+    InMemoryReportTransport transport;
+    ThingSetServer<int, ReportMessageSize, InMemoryReportEncoder> server(transport);
+
+    ThingSetReadWriteProperty<float, Subset::live> voltage { 0x1501, 0, "voltage" };
+    ThingSetReport report(Subset::live);
+    ASSERT_TRUE(publishBothWays(server, transport, report));
+    {
+        ThingSetReadWriteProperty<float, Subset::live> current { 0x1504, 0, "current" };
+        ASSERT_TRUE(publishBothWays(server, transport, report));
+    }
+    ASSERT_TRUE(publishBothWays(server, transport, report));
+}
+
+TEST(Report, Properties)
+{
+    ThingSetReadWriteProperty<float> voltage { 0x1501, 0, "voltage" };
+    ThingSetReadWriteProperty<uint32_t> count { 0x1502, 0, "count" };
+    voltage = 12.5f;
+    count = 7;
+    ThingSetReport report(voltage, count);
+    ASSERT_TRUE(report.update());
+
+    std::array<uint8_t, 32> buffer;
+    FixedDepthThingSetBinaryEncoder encoder(buffer, 2);
+    encoder.encode(0);
+    encoder.encodeMapStart(2);
+    encoder.encode(voltage.getId());
+    encoder.encode(voltage.getValue());
+    encoder.encode(count.getId());
+    encoder.encode(count.getValue());
+    encoder.encodeMapEnd(2);
+    ASSERT_EQ(encoder.getEncodedLength(), report.size());
+    ASSERT_EQ(0, memcmp(buffer.data(), report.data(), report.size()));
+
+    count = 70000;
+    ASSERT_TRUE(report.update());
+    ASSERT_EQ(encoder.getEncodedLength() + 4, report.size());
+}
+
+TEST(Report, ChangedValuesOnly)
+{
+    ThingSetReadWriteProperty<float> voltage { 0x1501, 0, "voltage" };
+    ThingSetReadWriteProperty<uint32_t> count { 0x1502, 0, "count" };
+    voltage = 12.5f;
+    count = 7;
+    ThingSetReport report(voltage, count);
+    report.setKeyframeInterval(3);
+
+    // first report is always a keyframe
+    ASSERT_TRUE(report.update());
+    std::vector<uint8_t> full(report.data(), report.data() + report.size());
+
+    // nothing has changed
+    ASSERT_TRUE(report.update());
+    ASSERT_EQ(0u, report.size());
+
+    count = 8;
+    ASSERT_TRUE(report.update());
+    std::array<uint8_t, 32> buffer;
+    FixedDepthThingSetBinaryEncoder encoder(buffer, 2);
+    encoder.encode(0);
+    encoder.encodeMapStart(1);
+    encoder.encode(count.getId());
+    encoder.encode(count.getValue());
+    encoder.encodeMapEnd(1);
+    ASSERT_EQ(encoder.getEncodedLength(), report.size());
+    ASSERT_EQ(0, memcmp(buffer.data(), report.data(), report.size()));
+
+    // keyframe includes every value, changed or not
+    ASSERT_TRUE(report.update());
+    ASSERT_EQ(full.size(), report.size());
+
+    // a change in width means a full report
+    ASSERT_TRUE(report.update());
+    ASSERT_EQ(0u, report.size());
+    count = 70000;
+    ASSERT_TRUE(report.update());
+    ASSERT_EQ(full.size() + 4, report.size());
+    ASSERT_TRUE(report.update());
+    ASSERT_EQ(0u, report.size());
+}
+
+TEST(Report, ReportingPolicy)
+{
+    using namespace std::chrono_literals;
+    ThingSetReportedProperty<ThingSetReadWriteProperty<float>> voltage {
+        { .deadband = 0.5, .minInterval = 100ms, .maxInterval = 1000ms }, 0x1501, 0, "voltage"
+    };
+    ThingSetReportedProperty<ThingSetReadWriteProperty<float>> current {
+        { .relativeDeadband = 0.1 }, 0x1502, 0, "current"
+    };
+    voltage = 12.0f;
+    current = 10.0f;
+    ThingSetReport report(voltage, current);
+    std::chrono::steady_clock::time_point t;
+
+    // everything is reported initially
+    ASSERT_TRUE(report.update(t));
+    size_t full = report.size();
+
+    // beyond the voltage deadband, but too soon after the last report
+    voltage = 13.0f;
+    ASSERT_TRUE(report.update(t + 50ms));
+    ASSERT_EQ(0u, report.size());
+    ASSERT_TRUE(report.update(t + 100ms));
+    std::array<uint8_t, 32> buffer;
+    FixedDepthThingSetBinaryEncoder encoder(buffer, 2);
+    encoder.encode(0);
+    encoder.encodeMapStart(1);
+    encoder.encode(voltage.getId());
+    encoder.encode(voltage.getValue());
+    encoder.encodeMapEnd(1);
+    ASSERT_EQ(encoder.getEncodedLength(), report.size());
+    ASSERT_EQ(0, memcmp(buffer.data(), report.data(), report.size()));
+
+    // within both deadbands
+    voltage = 13.4f;
+    current = 10.9f;
+    ASSERT_TRUE(report.update(t + 200ms));
+    ASSERT_EQ(0u, report.size());
+
+    // beyond the deadband of the current
+    current = 11.5f;
+    ASSERT_TRUE(report.update(t + 300ms));
+    ASSERT_GT(report.size(), 0u);
+    ASSERT_LT(report.size(), full);
+
+    // compared with the value last reported, not the previous value
+    current = 12.0f;
+    ASSERT_TRUE(report.update(t + 350ms));
+    ASSERT_EQ(0u, report.size());
+
+    // reported again after the maximum interval, whether changed or not
+    ASSERT_TRUE(report.update(t + 1099ms));
+    ASSERT_EQ(0u, report.size());
+    ASSERT_TRUE(report.update(t + 1100ms));
+    ASSERT_EQ(encoder.getEncodedLength(), report.size());
+}
+
+// Records the subset ID of each report the scheduler publishes
+class RecordingReportScheduler : public ThingSetReportScheduler<int, ReportMessageSize, InMemoryReportEncoder>
+{
+private:
+    InMemoryReportTransport &_transport;
+
+public:
+    std::vector<uint8_t> published;
+
+    RecordingReportScheduler(ThingSetServer<int, ReportMessageSize, InMemoryReportEncoder> &server,
+                             InMemoryReportTransport &transport)
+        : ThingSetReportScheduler(server), _transport(transport)
+    {}
+
+protected:
+    bool publish(ThingSetReport &report) override
+    {
+        if (!ThingSetReportScheduler::publish(report)) {
+            return false;
+        }
+        published.push_back(_transport.output[0]);
+        return true;
+    }
+};
+
+TEST(ReportScheduler, Run)
+{
+    using namespace std::chrono_literals;
+    InMemoryReportTransport transport;
+    ThingSetServer<int, ReportMessageSize, InMemoryReportEncoder> server(transport);
+    RecordingReportScheduler scheduler(server, transport);
+
+    ThingSetReadWriteProperty<float, Subset::live> voltage { 0x1501, 0, "voltage" };
+    ThingSetReadWriteProperty<uint32_t, Subset::persisted> count { 0x1502, 0, "count" };
+    ASSERT_TRUE(scheduler.add(Subset::persisted, 100ms));
+    ASSERT_TRUE(scheduler.add(Subset::live, 100ms, 1));
+    std::chrono::steady_clock::time_point t;
+    scheduler.schedule(t);
+
+    // reports of equal period are staggered across it
+    ASSERT_EQ(t + 50ms, scheduler.run(t));
+    ASSERT_EQ(t + 100ms, scheduler.run(t + 50ms));
+    ASSERT_EQ(t + 150ms, scheduler.run(t + 100ms));
+    ASSERT_EQ((std::vector<uint8_t> { (uint8_t)Subset::live, (uint8_t)Subset::persisted, (uint8_t)Subset::live }),
+              scheduler.published);
+
+    // reports which are due together are published in one pass, in order of priority
+    scheduler.published.clear();
+    ASSERT_EQ(t + 250ms, scheduler.run(t + 220ms));
+    ASSERT_EQ((std::vector<uint8_t> { (uint8_t)Subset::live, (uint8_t)Subset::persisted }), scheduler.published);
+
+    // deadlines more than a period ago are skipped
+    ASSERT_EQ(t + 1050ms, scheduler.run(t + 1000ms));
+    ThingSetReportStatistics statistics;
+    ASSERT_TRUE(scheduler.getStatistics(Subset::live, &statistics));
+    ASSERT_EQ(4u, statistics.count);
+    ASSERT_EQ(0u, statistics.failed);
+    ASSERT_EQ(7u, statistics.missed);
+    // jitter includes the real time spent in the pass before each publish
+    ASSERT_LT(statistics.minJitter, 1ms);
+    ASSERT_GE(statistics.maxJitter, 700ms);
+    ASSERT_LT(statistics.maxJitter, 701ms);
+    ASSERT_GE(statistics.meanJitter(), 180ms);
+    ASSERT_LT(statistics.meanJitter(), 181ms);
+}
+
+// Takes a while to publish each report, during which the statistics are read
+class SlowReportScheduler : public RecordingReportScheduler
+{
+public:
+    std::vector<std::thread> readers;
+    std::atomic<size_t> reads = 0;
+    bool blocked = false;
+
+    using RecordingReportScheduler::RecordingReportScheduler;
+
+protected:
+    bool publish(ThingSetReport &report) override
+    {
+        using namespace std::chrono_literals;
+        readers.emplace_back([this]() {
+            ThingSetReportStatistics statistics;
+            getStatistics(Subset::live, &statistics);
+            reads++;
+        });
+        std::this_thread::sleep_for(20ms);
+        if (reads < readers.size()) {
+            blocked = true;
+        }
+        return RecordingReportScheduler::publish(report);
+    }
+};
+
+TEST(ReportScheduler, SlowPublish)
+{
+    using namespace std::chrono_literals;
+    InMemoryReportTransport transport;
+    ThingSetServer<int, ReportMessageSize, InMemoryReportEncoder> server(transport);
+    SlowReportScheduler scheduler(server, transport);
+
+    ThingSetReadWriteProperty<float, Subset::live> voltage { 0x1501, 0, "voltage" };
+    ThingSetReadWriteProperty<uint32_t, Subset::persisted> count { 0x1502, 0, "count" };
+    ASSERT_TRUE(scheduler.add(Subset::persisted, 100ms));
+    ASSERT_TRUE(scheduler.add(Subset::live, 100ms, 1));
+    std::chrono::steady_clock::time_point t;
+    scheduler.schedule(t);
+    scheduler.run(t + 50ms);
+    for (std::thread &reader : scheduler.readers) {
+        reader.join();
+    }
+    // the statistics could be read while publishing
+    ASSERT_FALSE(scheduler.blocked);
+
+    // both are due; the later one, which was due at the start of the pass, is
+    // delayed by publishing the earlier one
+    ThingSetReportStatistics statistics;
+    ASSERT_TRUE(scheduler.getStatistics(Subset::live, &statistics));
+    ASSERT_LT(statistics.maxJitter, 51ms);
+    ASSERT_TRUE(scheduler.getStatistics(Subset::persisted, &statistics));
+    ASSERT_GE(statistics.maxJitter, 20ms);
+}
+
+TEST(ReportScheduler, Timer)
+{
+    using namespace std::chrono_literals;
+    InMemoryReportTransport transport;
+    ThingSetServer<int, ReportMessageSize, InMemoryReportEncoder> server(transport);
+    RecordingReportScheduler scheduler(server, transport);
+
+    ThingSetReadWriteProperty<float, Subset::live> voltage { 0x1501, 0, "voltage" };
+    ASSERT_FALSE(scheduler.start());
+    ASSERT_TRUE(scheduler.add(Subset::live, 10ms));
+    ASSERT_TRUE(scheduler.start());
+    ASSERT_FALSE(scheduler.start());
+    ASSERT_FALSE(scheduler.add(Subset::persisted, 10ms));
+    std::this_thread::sleep_for(100ms);
+    scheduler.stop();
+
+    size_t published = scheduler.published.size();
+    ASSERT_GT(published, 0u);
+    ThingSetReportStatistics statistics;
+    ASSERT_TRUE(scheduler.getStatistics(Subset::live, &statistics));
+    ASSERT_EQ(published, statistics.count);
+    ASSERT_LE(statistics.minJitter, statistics.maxJitter);
+
+    // nothing more is published once stopped
+    std::this_thread::sleep_for(20ms);
+    ASSERT_EQ(published, scheduler.published.size());
+}
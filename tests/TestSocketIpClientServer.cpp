@@ -8,8 +8,12 @@
 #include "thingset++/ThingSetClient.hpp"
 #include "thingset++/ThingSetServer.hpp"
 #include "thingset++/ThingSetFunction.hpp"
+#include "thingset++/ThingSetGroup.hpp"
 #include "gtest/gtest.h"
+#include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 
 using namespace ThingSet;
 using namespace ThingSet::Ip::Sockets;
@@ -59,4 +63,216 @@ SOCKET_TEST(ExecFunction,
 SOCKET_TEST(UpdateFloat,
     ASSERT_TRUE(client.update("totalVoltage", 25.0f));
     ASSERT_EQ(25.0, totalVoltage.getValue());
-)
\ No newline at end of file
+)
+TEST(SocketIpClientServer, GetTextResponseLargerThanBuffer)
+{
+    ThingSetGroup<0xB100, 0, "Large"> group;
+    std::vector<std::string> names;
+    std::vector<std::unique_ptr<ThingSetReadWriteProperty<float>>> properties;
+    for (int i = 0; i < 200; i++) {
+        names.push_back("property" + std::to_string(i));
+    }
+    for (int i = 0; i < 200; i++) {
+        properties.push_back(std::make_unique<ThingSetReadWriteProperty<float>>(0xB101 + i, 0xB100, names[i]));
+        *properties.back() = i * 1.5f;
+    }
+    std::vector<char> json(8192);
+    ThingSetTextEncoder reference(json.data(), json.size());
+    ASSERT_TRUE(group.encode(reference));
+    std::string expected = ":85 " + std::string(json.data(), reference.getEncodedLength());
+    ASSERT_GT(expected.size(), 2 * THINGSET_PLUS_PLUS_SOCKET_SERVER_TX_BUFFER_SIZE);
+
+    ThingSetSocketServerTransport serverTransport;
+    auto server = ThingSetServerBuilder::build(serverTransport);
+    server.listen();
+    std::this_thread::sleep_for(std::chrono::milliseconds(125));
+
+    int handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(9001);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, connect(handle, (sockaddr *)&address, sizeof(address)));
+    timeval timeout = { .tv_sec = 2, .tv_usec = 0 };
+    setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    const char request[] = "?Large";
+    ASSERT_EQ((ssize_t)strlen(request), send(handle, request, strlen(request), 0));
+    std::string response;
+    char chunk[512];
+    ssize_t received;
+    while (response.size() < expected.size() && (received = recv(handle, chunk, sizeof(chunk), 0)) > 0) {
+        response.append(chunk, received);
+    }
+    close(handle);
+    ASSERT_EQ(expected, response);
+}
+
+TEST(SocketIpClientServer, GetBinaryResponseLargerThanBuffer)
+{
+    ThingSetGroup<0xB400, 0, "LargeBinary"> group;
+    std::vector<std::string> names;
+    std::vector<std::unique_ptr<ThingSetReadWriteProperty<float>>> properties;
+    for (int i = 0; i < 300; i++) {
+        names.push_back("property" + std::to_string(i));
+    }
+    for (int i = 0; i < 300; i++) {
+        properties.push_back(std::make_unique<ThingSetReadWriteProperty<float>>(0xB401 + i, 0xB400, names[i]));
+        *properties.back() = i * 1.5f;
+    }
+    std::vector<uint8_t> cbor(8192);
+    DefaultFixedDepthThingSetBinaryEncoder reference(cbor.data(), cbor.size());
+    ASSERT_TRUE(reference.encodePreamble() && group.encode(reference));
+    std::vector<uint8_t> expected = { (uint8_t)ThingSetStatusCode::content };
+    expected.insert(expected.end(), cbor.data(), cbor.data() + reference.getEncodedLength());
+    ASSERT_GT(expected.size(), 2 * THINGSET_PLUS_PLUS_SOCKET_SERVER_TX_BUFFER_SIZE);
+
+    ThingSetSocketServerTransport serverTransport;
+    auto server = ThingSetServerBuilder::build(serverTransport);
+    server.listen();
+    std::this_thread::sleep_for(std::chrono::milliseconds(125));
+
+    int handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(9001);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, connect(handle, (sockaddr *)&address, sizeof(address)));
+    timeval timeout = { .tv_sec = 2, .tv_usec = 0 };
+    setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    const uint8_t request[] = { (uint8_t)ThingSetBinaryRequestType::get, 0x19, 0xB4, 0x00 };
+    ASSERT_EQ((ssize_t)sizeof(request), send(handle, request, sizeof(request), 0));
+    std::vector<uint8_t> response;
+    uint8_t chunk[512];
+    ssize_t received;
+    while (response.size() < expected.size() && (received = recv(handle, chunk, sizeof(chunk), 0)) > 0) {
+        response.insert(response.end(), chunk, chunk + received);
+    }
+    close(handle);
+    ASSERT_EQ(expected, response);
+}
+
+TEST(SocketIpClientServer, UpdateWithRequestLargerThanSmallestBuffer)
+{
+    ThingSetGroup<0xB600, 0, "Big"> group;
+    ThingSetReadWriteProperty<std::string> text{ 0xB601, 0xB600, "text" };
+    const std::string value(600, 'x');
+    const std::string request = "=Big {\"text\":\"" + value + "\"}";
+    ASSERT_GT(request.size(), Ip::BufferPool::getDefault().getMetrics(0).size);
+
+    ThingSetSocketServerTransport serverTransport;
+    auto server = ThingSetServerBuilder::build(serverTransport);
+    server.listen();
+    std::this_thread::sleep_for(std::chrono::milliseconds(125));
+
+    int handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(9001);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, connect(handle, (sockaddr *)&address, sizeof(address)));
+    timeval timeout = { .tv_sec = 2, .tv_usec = 0 };
+    setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    ASSERT_EQ((ssize_t)request.size(), send(handle, request.data(), request.size(), 0));
+    char response[16];
+    ssize_t received = recv(handle, response, sizeof(response), 0);
+    close(handle);
+    ASSERT_GE(received, 3);
+    ASSERT_EQ(":84", std::string(response, 3));
+    ASSERT_EQ(value, text.getValue());
+}
+
+TEST(SocketIpClientServer, SlowFunctionDoesNotBlockOtherClientsWithWorkers)
+{
+    ThingSetReadWriteProperty<float> voltage{ 0xB701, 0, "voltage", 24.0f };
+    ThingSetUserFunction<0xB702, 0x0, "xSlow", int> slow([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        return 1;
+    });
+
+    ThingSetSocketServerTransport serverTransport;
+#ifdef ENABLE_CONCURRENT_REGISTRY
+    ASSERT_TRUE(serverTransport.setWorkerCount(2));
+#else
+    // workers would share a registry which is not safe to share
+    ASSERT_FALSE(serverTransport.setWorkerCount(2));
+    GTEST_SKIP();
+#endif // ENABLE_CONCURRENT_REGISTRY
+    auto server = ThingSetServerBuilder::build(serverTransport);
+    server.listen();
+    std::this_thread::sleep_for(std::chrono::milliseconds(125));
+
+    std::array<uint8_t, 1024> slowRxBuffer;
+    std::array<uint8_t, 1024> slowTxBuffer;
+    ThingSetSocketClientTransport slowClientTransport("127.0.0.1");
+    auto slowClient = ThingSetClient(slowClientTransport, slowRxBuffer, slowTxBuffer);
+    ASSERT_TRUE(slowClient.connect());
+    ThingSetSocketClientTransport clientTransport("127.0.0.1");
+    auto client = ThingSetClient(clientTransport, rxBuffer, txBuffer);
+    ASSERT_TRUE(client.connect());
+
+    int result = 0;
+    std::thread slowThread([&]() { ASSERT_TRUE(slowClient.exec(0xB702, &result)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // requests on the other connection are answered while the function runs,
+    // and in the order they were sent
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(client.update("voltage", (float)i));
+        float value;
+        ASSERT_TRUE(client.get(0xB701, value));
+        ASSERT_EQ((float)i, value);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    slowThread.join();
+
+    ASSERT_EQ(1, result);
+    ASSERT_LT(elapsed, std::chrono::milliseconds(400));
+}
+
+/// @brief Serves requests only when told to, without threads of its own.
+class SteppedSocketServerTransport : public _ThingSetSocketServerTransport
+{
+public:
+    SteppedSocketServerTransport()
+        : _ThingSetSocketServerTransport(std::make_pair(in_addr{ htonl(INADDR_LOOPBACK) }, in_addr{ htonl(IN_CLASSA_NET) }))
+    {}
+
+    using _ThingSetSocketServerTransport::serve;
+
+protected:
+    void startThreads() override
+    {}
+};
+
+TEST(SocketIpClientServer, CloseConnectionWhenClientStopsReading)
+{
+    SteppedSocketServerTransport serverTransport;
+    Delegate<int(const SocketEndpoint &, uint8_t *, size_t, uint8_t *, size_t)> callback =
+        [](const SocketEndpoint &, uint8_t *, size_t, uint8_t *response, size_t responseSize) {
+            memset(response, ' ', responseSize);
+            return (int)responseSize;
+        };
+    ASSERT_TRUE(serverTransport.listen(callback));
+
+    int handles[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, handles));
+    int sendBufferSize = 4096;
+    setsockopt(handles[0], SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+    // the client reads none of what is sent to it
+    char filler[256] = {};
+    while (send(handles[0], filler, sizeof(filler), MSG_DONTWAIT) > 0) {
+    }
+
+    const char request[] = "?";
+    ASSERT_EQ((ssize_t)strlen(request), send(handles[1], request, strlen(request), 0));
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_FALSE(serverTransport.serve(handles[0]));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    close(handles[0]);
+    close(handles[1]);
+    ASSERT_GE(elapsed, std::chrono::milliseconds(THINGSET_PLUS_PLUS_SOCKET_SERVER_SEND_TIMEOUT_MS));
+}
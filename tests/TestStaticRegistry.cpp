@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "gtest/gtest.h"
+#include <thingset++/ThingSet.hpp>
+
+using namespace ThingSet;
+
+namespace {
+
+struct StaticRecord
+{
+    ThingSetReadOnlyRecordMember<0x7C2, 0x7C1, "alpha", uint32_t> alpha;
+    ThingSetReadOnlyRecordMember<0x7C3, 0x7C1, "beta", float> beta;
+};
+
+ThingSetGroup<0x7C0, 0x0, "StaticGroup"> staticGroup;
+ThingSetReadWriteProperty<float> dynamicChild{ 0x7C4, 0x7C0, "dynamicChild" };
+ThingSetReadOnlyProperty<std::array<StaticRecord, 2>> staticRecords{ 0x7C1, 0x0, "staticRecords" };
+
+typedef ThingSetGroup<0x7C5, 0x0, "ScopedGroup"> ScopedGroup;
+
+constexpr std::array<uint32_t, 512> manyKeys()
+{
+    std::array<uint32_t, 512> keys;
+    for (size_t i = 0; i < keys.size(); i++) {
+        keys[i] = i % 2 ? ThingSetRegistry::nodeKey(0x100 + i) : ThingSetRegistry::nodeKey(i, 0x900 + i / 16);
+    }
+    return keys;
+}
+
+constexpr ThingSetPerfectHash<512> manyKeysHash{ manyKeys() };
+static_assert(manyKeysHash.valid);
+static_assert(!ThingSetPerfectHash<2>{ std::array<uint32_t, 2>{ 0x7C0, 0x7C0 } }.valid);
+static_assert(!ThingSetPerfectHash<2>{ std::array<uint32_t, 2>{ 0x7C0, ThingSetStaticIndex::emptyKey } }.valid);
+
+} // namespace
+
+THINGSET_STATIC_REGISTRY(decltype(staticGroup), decltype(StaticRecord::alpha), decltype(StaticRecord::beta), ScopedGroup)
+
+TEST(StaticRegistry, PerfectHashIsCollisionFree)
+{
+    static ThingSetNode *nodes[manyKeysHash.slotCount];
+    ThingSetStaticIndex index{ manyKeysHash.displacements.data(), manyKeysHash.bucketCount - 1,
+                               manyKeysHash.keys.data(), nodes, manyKeysHash.slotCount - 1 };
+    std::array<bool, manyKeysHash.slotCount> seen{};
+    for (uint32_t key : manyKeys()) {
+        ThingSetNode **slot = index.slot(key);
+        ASSERT_NE(nullptr, slot);
+        size_t s = slot - nodes;
+        ASSERT_FALSE(seen[s]);
+        seen[s] = true;
+    }
+    ASSERT_EQ(nullptr, index.slot(ThingSetRegistry::nodeKey(0x1)));
+    ASSERT_EQ(nullptr, index.slot(ThingSetRegistry::nodeKey(0xFFFF, 0xFFFF)));
+}
+
+TEST(StaticRegistry, FindStaticNodeById)
+{
+    ThingSetNode *node;
+    ASSERT_TRUE(ThingSetRegistry::findById(0x7C0, &node));
+    ASSERT_EQ(&staticGroup, node);
+    ASSERT_EQ(node, *thingSetStaticIndex.slot(ThingSetRegistry::nodeKey(0x7C0)));
+}
+
+TEST(StaticRegistry, FindStaticRecordMemberById)
+{
+    ThingSetNode *node;
+    ASSERT_TRUE(ThingSetRegistry::findById(0x7C2, 0x7C1, &node));
+    ASSERT_EQ("alpha", node->getName());
+    ASSERT_EQ(node, *thingSetStaticIndex.slot(ThingSetRegistry::nodeKey(0x7C2, 0x7C1)));
+    ASSERT_FALSE(ThingSetRegistry::findById(0x7C2, &node));
+}
+
+TEST(StaticRegistry, DynamicNodesUseRuntimeIndex)
+{
+    ASSERT_EQ(nullptr, thingSetStaticIndex.slot(ThingSetRegistry::nodeKey(0x7C4)));
+    ThingSetNode *node;
+    ASSERT_TRUE(ThingSetRegistry::findById(0x7C4, &node));
+    ASSERT_EQ("dynamicChild", node->getName());
+    ASSERT_TRUE(ThingSetRegistry::findByName("StaticGroup/dynamicChild", &node));
+    ASSERT_EQ("dynamicChild", node->getName());
+}
+
+TEST(StaticRegistry, RegisterAndUnregister)
+{
+    ThingSetNode *node;
+    ASSERT_FALSE(ThingSetRegistry::findById(0x7C5, &node));
+    {
+        ScopedGroup scoped;
+        ASSERT_TRUE(ThingSetRegistry::findById(0x7C5, &node));
+        ASSERT_EQ(&scoped, node);
+        ASSERT_TRUE(ThingSetRegistry::findByName("ScopedGroup", &node));
+    }
+    ASSERT_FALSE(ThingSetRegistry::findById(0x7C5, &node));
+    ASSERT_FALSE(ThingSetRegistry::findByName("ScopedGroup", &node));
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2025 Brill Power.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "thingset++/StreamingThingSetTextEncoder.hpp"
+#include "thingset++/ThingSetGroup.hpp"
+#include "thingset++/ThingSetProperty.hpp"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+using namespace ThingSet;
+
+/// Collects the chunks written by a streaming encoder.
+struct Output
+{
+    std::string text;
+    std::vector<size_t> chunks;
+
+    bool operator()(const uint8_t *buffer, size_t length)
+    {
+        text.append((const char *)buffer, length);
+        chunks.push_back(length);
+        return true;
+    }
+};
+
+/// Encodes the same values with a streaming encoder of the given buffer size
+/// and with an encoder whose buffer is large enough, and checks they match.
+template <typename Encode> void assertSameAsUnstreamed(size_t size, Encode encode)
+{
+    char expected[1024];
+    ThingSetTextEncoder reference(expected, sizeof(expected));
+    ASSERT_TRUE(encode(reference));
+
+    Output output;
+    std::vector<char> buffer(size);
+    StreamingThingSetTextEncoder encoder(buffer.data(), buffer.size(), 0, output);
+    ASSERT_TRUE(encode(encoder));
+    output.text.append(buffer.data(), encoder.getEncodedLength() - output.text.size());
+    ASSERT_EQ(std::string(expected, reference.getEncodedLength()), output.text) << "buffer size " << size;
+    ASSERT_EQ(reference.getEncodedLength(), encoder.getEncodedLength());
+}
+
+TEST(StreamingTextEncoder, EncodeListInChunks)
+{
+    for (size_t size = 12; size < 40; size++) {
+        assertSameAsUnstreamed(size, [](ThingSetTextEncoder &encoder) {
+            std::array<float, 6> values = { 1.5f, -2.25f, 3.0f, 100.125f, 0.0f, 7.75f };
+            return encoder.encode(values);
+        });
+    }
+}
+
+TEST(StreamingTextEncoder, EncodeMapInChunks)
+{
+    ThingSetGroup<0xB000, 0, "streamed"> group;
+    ThingSetReadOnlyProperty<float> voltage{ 0xB001, 0xB000, "voltage", 24.5f };
+    ThingSetReadOnlyProperty<std::string> name{ 0xB002, 0xB000, "name", "a name longer than the buffer" };
+    ThingSetReadOnlyProperty<std::array<int32_t, 3>> counts{ 0xB003, 0xB000, "counts", { 1, -20, 300 } };
+    ThingSetGroup<0xB004, 0xB000, "empty"> empty;
+    for (size_t size = 12; size < 40; size++) {
+        assertSameAsUnstreamed(size, [&](ThingSetTextEncoder &encoder) { return group.encode(encoder); });
+    }
+}
+
+TEST(StreamingTextEncoder, WriteReservedBytesWithFirstChunk)
+{
+    Output output;
+    char buffer[16] = { ':', '8', '5', ' ' };
+    StreamingThingSetTextEncoder encoder(buffer, sizeof(buffer), 4, output);
+    ASSERT_TRUE(encoder.encode("0123456789abcdef"));
+    ASSERT_EQ(18, encoder.getEncodedLength());
+    // the last character in the buffer is kept back, in case it is a separator
+    ASSERT_EQ(":85 \"0123456789", output.text);
+    ASSERT_EQ(15, encoder.getWrittenLength());
+}
+
+TEST(StreamingTextEncoder, FailIfWriterFails)
+{
+    char buffer[8];
+    StreamingThingSetTextEncoder encoder(buffer, sizeof(buffer), 0, [](const uint8_t *, size_t) { return false; });
+    ASSERT_FALSE(encoder.encode("too long to fit"));
+}
@@ -46,4 +46,45 @@ TEST(Subsets, Multiple)
     }
 
     ASSERT_EQ(1, count);
-}
\ No newline at end of file
+}
+TEST(Subsets, Count)
+{
+    ThingSetReadOnlyProperty<float, Subset::live> f32 { 0x100, 0, "f32" };
+    ThingSetReadWriteProperty<float, Subset::live | Subset::persisted> u32 { 0x201, 0, "u32" };
+    ASSERT_EQ(2, ThingSetRegistry::countInSubset(Subset::live));
+    ASSERT_EQ(1, ThingSetRegistry::countInSubset(Subset::persisted));
+    ASSERT_EQ(1, ThingSetRegistry::countInSubset(Subset::live | Subset::persisted));
+    {
+        ThingSetReadOnlyProperty<int32_t, Subset::live> i32 { 0x200, 0, "i32" };
+        ASSERT_EQ(3, ThingSetRegistry::countInSubset(Subset::live));
+    }
+    ASSERT_EQ(2, ThingSetRegistry::countInSubset(Subset::live));
+}
+
+TEST(Subsets, MembersOnly)
+{
+    ThingSetReadOnlyProperty<float, Subset::live> f32 { 0x100, 0, "f32" };
+    ThingSetReadWriteProperty<float, Subset::persisted> persisted { 0x202, 0, "persisted" };
+    ThingSetReadWriteProperty<uint32_t, Subset::live | Subset::persisted> u32 { 0x201, 0, "u32" };
+    {
+        ThingSetReadOnlyProperty<int32_t, Subset::live> i32 { 0x200, 0, "i32" };
+        std::vector<std::string_view> names;
+        for (auto node : ThingSetRegistry::nodesInSubset(Subset::live)) {
+            names.push_back(node->getName());
+        }
+        // grouped by subsets, then in order of registration
+        ASSERT_EQ((std::vector<std::string_view> { "f32", "i32", "u32" }), names);
+    }
+
+    std::vector<std::string_view> names;
+    for (auto node : ThingSetRegistry::nodesInSubset(Subset::live)) {
+        names.push_back(node->getName());
+    }
+    ASSERT_EQ((std::vector<std::string_view> { "f32", "u32" }), names);
+
+    names.clear();
+    for (auto node : ThingSetRegistry::nodesInSubset(Subset::live | Subset::persisted)) {
+        names.push_back(node->getName());
+    }
+    ASSERT_EQ((std::vector<std::string_view> { "u32" }), names);
+}
@@ -26,6 +26,17 @@ TEST(TextDecoder, DecodeStdString)
     ASSERT_EQ(value, "Hello World");
 }
 
+TEST(TextDecoder, DecodeStringView)
+{
+    char buffer[] = "\"Hello World\"";
+    DefaultFixedSizeThingSetTextDecoder decoder(buffer, strlen(buffer));
+    std::string_view value;
+    ASSERT_TRUE(decoder.decode(&value));
+    ASSERT_EQ(value, "Hello World");
+    // points into the buffer rather than at a copy
+    ASSERT_EQ(value.data(), &buffer[1]);
+}
+
 TEST(TextDecoder, DecodeString)
 {
     char buffer[] = "\"F\"";
@@ -187,6 +198,28 @@ TEST(TextDecoder, DecodeMap)
     ASSERT_EQ(0x10, canAddr);
 }
 
+TEST(TextDecoder, DecodeMapWithIdsOrNames)
+{
+    char buffer[] = "{\"nodeID\":\"E93A142B282C4AD0\",\"canAddr\":16}";
+    DefaultFixedSizeThingSetTextDecoder decoder(buffer, strlen(buffer));
+    std::string_view nodeId;
+    uint8_t canAddr;
+    ASSERT_TRUE(decoder.decodeMap([&](std::optional<uint32_t> id, std::optional<std::string_view> name) {
+        if (id.has_value() || !name.has_value()) {
+            return false;
+        }
+        if (name.value() == "nodeID") {
+            return decoder.decode(&nodeId);
+        }
+        else if (name.value() == "canAddr") {
+            return decoder.decode(&canAddr);
+        }
+        return false;
+    }));
+    ASSERT_EQ("E93A142B282C4AD0", nodeId);
+    ASSERT_EQ(0x10, canAddr);
+}
+
 TEST(TextDecoder, DecodeStruct)
 {
     char buffer[] = "[{\"nodeID\":\"E93A142B282C4AD0\",\"three\":[1.23,13.4,14.5],\"canAddr\":16}]";
@@ -200,3 +233,18 @@ TEST(TextDecoder, DecodeStruct)
     ASSERT_NEAR(14.5f, newStructTest[0].three.getValue()[2], 1e-6);
     ASSERT_EQ(0x10, newStructTest[0].canAddr.getValue());
 }
+
+TEST(TextDecoder, DecodeArrayLargerThanFixedTokens)
+{
+    // more elements than a fixed-size decoder has tokens
+    std::string buffer = "[";
+    for (int i = 0; i < 200; i++) {
+        buffer += std::to_string(i) + (i < 199 ? "," : "]");
+    }
+    GrowableThingSetTextDecoder decoder(buffer.data(), buffer.size());
+    std::array<uint16_t, 200> values;
+    ASSERT_TRUE(decoder.decode(&values));
+    for (int i = 0; i < 200; i++) {
+        ASSERT_EQ(i, values[i]);
+    }
+}
@@ -77,6 +77,31 @@ TEST(TextEncoder, EncodeArrayOfDoubles)
     ASSERT_BUFFER_EQ(expected, buffer, encoder.getEncodedLength());
 }
 
+TEST(TextEncoder, EncodeShortestFloats)
+{
+    char buffer[TEXT_ENCODER_BUFFER_SIZE];
+    ThingSetTextEncoder encoder(buffer, sizeof(buffer), TextEncoderOptions::shortestFloats);
+    std::array f = { 1.23F, 24.2F, 0.0F, -3.0F, 1e-7F };
+    encoder.encode(f);
+    encoder.encode(0.1 + 0.2);
+    const char *expected = "[1.23,24.2,0,-3,1e-07]0.30000000000000004";
+    ASSERT_BUFFER_EQ(expected, buffer, encoder.getEncodedLength());
+}
+
+TEST(TextEncoder, EncodeNumbersWhichOnlyJustFit)
+{
+    char buffer[8];
+    ThingSetTextEncoder encoder(buffer, sizeof(buffer));
+    ASSERT_TRUE(encoder.encode(1.23F));
+    ASSERT_FALSE(encoder.encode((uint8_t)1));
+    ASSERT_BUFFER_EQ("1.230000", buffer, encoder.getEncodedLength());
+
+    ThingSetTextEncoder intEncoder(buffer, sizeof(buffer));
+    ASSERT_TRUE(intEncoder.encode((int64_t)-1234567));
+    ASSERT_FALSE(intEncoder.encode((int16_t)-1));
+    ASSERT_BUFFER_EQ("-1234567", buffer, intEncoder.getEncodedLength());
+}
+
 TEST(TextEncoder, EncodeInt)
 {
     SETUP(TEXT_ENCODER_BUFFER_SIZE)